@@ -1,3 +1,6 @@
 export * from "./wrapper/sapnwrfc-client";
 export * from "./wrapper/sapnwrfc-pool";
 export * from "./wrapper/sapnwrfc-throughput";
+export * from "./wrapper/sapnwrfc-server";
+export * from "./wrapper/sapnwrfc-transaction";
+export * from "./wrapper/sapnwrfc-cache";
@@ -13,4 +13,7 @@ Object.defineProperty(exports, "__esModule", { value: true });
 __exportStar(require("./wrapper/sapnwrfc-client"), exports);
 __exportStar(require("./wrapper/sapnwrfc-pool"), exports);
 __exportStar(require("./wrapper/sapnwrfc-throughput"), exports);
+__exportStar(require("./wrapper/sapnwrfc-server"), exports);
+__exportStar(require("./wrapper/sapnwrfc-transaction"), exports);
+__exportStar(require("./wrapper/sapnwrfc-cache"), exports);
 //# sourceMappingURL=index.js.map
\ No newline at end of file
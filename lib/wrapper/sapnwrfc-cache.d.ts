@@ -0,0 +1,29 @@
+/// <reference types="node" />
+export interface RfcCacheBinding {
+    new (maxBytes?: number, file?: string): RfcCacheBinding;
+    (maxBytes?: number, file?: string): RfcCacheBinding;
+    status: RfcCacheStatus;
+    get(key: string): Buffer | undefined;
+    set(key: string, value: Buffer, ttl: number): boolean;
+    delete(key: string): boolean;
+    clear(): void;
+}
+export interface RfcCacheStatus {
+    entries: number;
+    bytes: number;
+    maxBytes: number;
+    hits: number;
+    misses: number;
+    evictions: number;
+    expired: number;
+    shared: boolean;
+}
+export declare class Cache {
+    private __cache;
+    constructor(maxBytes?: number, file?: string);
+    get(key: string): any;
+    set(key: string, value: any, ttl: number): boolean;
+    delete(key: string): boolean;
+    clear(): void;
+    get status(): RfcCacheStatus;
+}
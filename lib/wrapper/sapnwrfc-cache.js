@@ -0,0 +1,33 @@
+"use strict";
+Object.defineProperty(exports, "__esModule", { value: true });
+exports.Cache = void 0;
+const sapnwrfc_client_1 = require("./sapnwrfc-client");
+const util_1 = require("util");
+const v8_1 = require("v8");
+class Cache {
+    constructor(maxBytes, file) {
+        this.__cache = util_1.isUndefined(file)
+            ? util_1.isUndefined(maxBytes)
+                ? new sapnwrfc_client_1.binding.Cache()
+                : new sapnwrfc_client_1.binding.Cache(maxBytes)
+            : new sapnwrfc_client_1.binding.Cache(maxBytes, file);
+    }
+    get(key) {
+        const data = this.__cache.get(key);
+        return util_1.isUndefined(data) ? undefined : v8_1.deserialize(data);
+    }
+    set(key, value, ttl) {
+        return this.__cache.set(key, v8_1.serialize(value), ttl);
+    }
+    delete(key) {
+        return this.__cache.delete(key);
+    }
+    clear() {
+        this.__cache.clear();
+    }
+    get status() {
+        return this.__cache.status;
+    }
+}
+exports.Cache = Cache;
+//# sourceMappingURL=sapnwrfc-cache.js.map
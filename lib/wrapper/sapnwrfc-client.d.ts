@@ -1,8 +1,15 @@
 /// <reference types="node" />
 import { RfcThroughputBinding } from "./sapnwrfc-throughput";
+import { RfcServerBinding } from "./sapnwrfc-server";
+import { RfcTransactionBinding, RfcTransactionOptions, Transaction } from "./sapnwrfc-transaction";
+import { RfcCacheBinding } from "./sapnwrfc-cache";
+import { Writable } from "stream";
 export interface NWRfcBinding {
     Client: RfcClientBinding;
     Throughput: RfcThroughputBinding;
+    Server: RfcServerBinding;
+    Transaction: RfcTransactionBinding;
+    Cache: RfcCacheBinding;
     verbose(): this;
 }
 declare let binding: NWRfcBinding;
@@ -43,17 +50,26 @@ export interface RfcClientOptions {
     bcd: string | Function;
     date: Function;
     time: Function;
+    intern?: boolean;
+    slice?: number;
+    bytes?: string;
 }
 export interface RfcClientBinding {
     new (connectionParameters: RfcConnectionParameters, options?: RfcClientOptions): RfcClientBinding;
     (connectionParameters: RfcConnectionParameters): RfcClientBinding;
     connect(callback: Function): any;
-    invoke(rfmName: string, rfmParams: RfcObject, callback: Function, callOptions?: object): any;
+    invoke(rfmName: string, rfmParams: RfcObject | Buffer, callback: Function, callOptions?: object): any;
+    call(rfmName: string, rfmParams: RfcObject | Buffer, callOptions?: object): Promise<RfcObject>;
     ping(callback: Function | undefined): void | Promise<void>;
     close(callback: Function | undefined): void | Promise<void>;
     reopen(callback: Function | undefined): void | Promise<void>;
     isAlive(): boolean;
     connectionInfo(): RfcConnectionInfo;
+    exportMetadata(rfmNames: Array<string>, callback: Function): void;
+    importMetadata(snapshot: Buffer, callback: Function): void;
+    streamRead(cursor: any, callback: Function): void;
+    streamClose(cursor: any): void;
+    releaseResult(result: RfcObject): void;
     id: number;
     _connectionHandle: number;
     version: RfcClientVersion;
@@ -75,7 +91,29 @@ declare enum EnumTrace {
 }
 export interface RfcCallOptions {
     notRequested?: Array<String>;
+    json?: boolean;
+    arrow?: Array<string>;
+    arrowDictionary?: boolean;
+    stream?: string;
+    streamFormat?: string;
+    split?: boolean | string;
+    splitFields?: string | Array<RfcSplitField>;
+    splitColumns?: boolean;
+    splitConvert?: boolean;
+    lazy?: boolean;
     timeout?: number;
+    deadline?: number | Date;
+}
+export interface RfcSplitField {
+    FIELDNAME: string;
+    OFFSET: number | string;
+    LENGTH: number | string;
+    TYPE?: string;
+}
+export interface RfcStreamOptions {
+    format?: string;
+    end?: boolean;
+    callOptions?: RfcCallOptions;
 }
 export interface RfcConnectionParameters {
     saprouter?: string;
@@ -110,7 +148,10 @@ export declare type RfcStructure = {
     [key: string]: RfcVariable | RfcStructure | RfcTable;
 };
 export declare type RfcTable = Array<RfcStructure>;
-export declare type RfcParameterValue = RfcVariable | RfcArray | RfcStructure | RfcTable;
+export declare type RfcColumns = {
+    [field: string]: RfcArray | Float64Array | Int32Array | Buffer;
+};
+export declare type RfcParameterValue = RfcVariable | RfcArray | RfcStructure | RfcTable | RfcColumns;
 export declare type RfcObject = {
     [key: string]: RfcParameterValue;
 };
@@ -127,14 +168,22 @@ export declare class Client {
     open(): Promise<Client>;
     reopen(callback?: Function): Promise<Client> | any;
     close(callback?: Function): Promise<void> | any;
-    call(rfmName: string, rfmParams: RfcObject, callOptions?: RfcCallOptions): Promise<RfcObject>;
+    call(rfmName: string, rfmParams: RfcObject | Buffer, callOptions?: RfcCallOptions): Promise<RfcObject>;
     connect(callback: Function): void;
-    invoke(rfmName: string, rfmParams: RfcObject, callback: Function, callOptions?: object): void;
+    invoke(rfmName: string, rfmParams: RfcObject | Buffer, callback: Function, callOptions?: object): void;
     ping(callback?: Function): Promise<boolean> | any;
+    exportMetadata(rfmNames: Array<string>, file?: string): Promise<Buffer>;
+    importMetadata(snapshot: Buffer | string): Promise<number>;
+    streamTable(rfmName: string, rfmParams: RfcObject | Buffer, tableName: string, writable: Writable, streamOptions?: RfcStreamOptions): Promise<RfcObject>;
+    releaseResult(result: RfcObject): void;
+    transaction(options?: RfcTransactionOptions): Transaction;
+    queue(queueName: string, options?: RfcTransactionOptions): Transaction;
+    unit(options?: RfcTransactionOptions): Transaction;
     get isAlive(): boolean;
     get connectionInfo(): RfcConnectionInfo;
     get id(): number;
     get _connectionHandle(): number;
+    get _client(): RfcClientBinding;
     get status(): RfcClientStatus;
     get version(): RfcClientVersion;
     get options(): RfcClientOptions;
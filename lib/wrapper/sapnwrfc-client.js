@@ -2,7 +2,9 @@
 Object.defineProperty(exports, "__esModule", { value: true });
 exports.Client = exports.binding = void 0;
 var Promise = require("bluebird");
+const sapnwrfc_transaction_1 = require("./sapnwrfc-transaction");
 const util_1 = require("util");
+const fs = require("fs");
 let binding;
 exports.binding = binding;
 try {
@@ -103,39 +105,9 @@ class Client {
             });
         }
     }
-    call(rfmName, rfmParams, callOptions = {}) {
-        return new Promise((resolve, reject) => {
-            if (arguments.length < 2) {
-                reject(new TypeError("Please provide remote function module name and parameters as arguments"));
-            }
-            if (typeof rfmName !== "string") {
-                reject(new TypeError("First argument (remote function module name) must be an string"));
-            }
-            if (typeof rfmParams !== "object") {
-                reject(new TypeError("Second argument (remote function module parameters) must be an object"));
-            }
-            if (arguments.length === 3 && typeof callOptions !== "object") {
-                reject(new TypeError("Call options argument must be an object"));
-            }
-            this.__status.lastcall = Date.now();
-            try {
-                if (!this.__client.isAlive()) {
-                    reject(new Error("Client invoked RFC call with closed connection: id=" +
-                        this.__client.id));
-                }
-                this.__client.invoke(rfmName, rfmParams, (err, res) => {
-                    if (!util_1.isUndefined(err)) {
-                        reject(err);
-                    }
-                    else {
-                        resolve(res);
-                    }
-                }, callOptions);
-            }
-            catch (ex) {
-                reject(ex);
-            }
-        });
+    call(rfmName, rfmParams, callOptions) {
+        this.__status.lastcall = Date.now();
+        return this.__client.call(rfmName, rfmParams, callOptions);
     }
     connect(callback) {
         this.__status.lastopen = Date.now();
@@ -194,6 +166,144 @@ class Client {
             });
         }
     }
+    exportMetadata(rfmNames, file) {
+        return new Promise((resolve, reject) => {
+            try {
+                this.__client.exportMetadata(rfmNames, (err, snapshot) => {
+                    if (!util_1.isUndefined(err)) {
+                        reject(err);
+                    }
+                    else if (util_1.isUndefined(file)) {
+                        resolve(snapshot);
+                    }
+                    else {
+                        fs.writeFile(file, snapshot, (err) => {
+                            if (err) {
+                                reject(err);
+                            }
+                            else {
+                                resolve(snapshot);
+                            }
+                        });
+                    }
+                });
+            }
+            catch (ex) {
+                reject(ex);
+            }
+        });
+    }
+    importMetadata(snapshot) {
+        return new Promise((resolve, reject) => {
+            const load = (buffer) => {
+                try {
+                    this.__client.importMetadata(buffer, (err, count) => {
+                        if (!util_1.isUndefined(err)) {
+                            reject(err);
+                        }
+                        else {
+                            resolve(count);
+                        }
+                    });
+                }
+                catch (ex) {
+                    reject(ex);
+                }
+            };
+            if (typeof snapshot === "string") {
+                fs.readFile(snapshot, (err, data) => {
+                    if (err) {
+                        reject(err);
+                    }
+                    else {
+                        load(data);
+                    }
+                });
+            }
+            else {
+                load(snapshot);
+            }
+        });
+    }
+    streamTable(rfmName, rfmParams, tableName, writable, streamOptions = {}) {
+        return new Promise((resolve, reject) => {
+            const callOptions = Object.assign({}, streamOptions.callOptions, {
+                stream: tableName,
+                streamFormat: streamOptions.format || "ndjson",
+            });
+            this.__status.lastcall = Date.now();
+            try {
+                this.__client.invoke(rfmName, rfmParams, (err, res, cursor) => {
+                    if (!util_1.isUndefined(err)) {
+                        reject(err);
+                        return;
+                    }
+                    let failed;
+                    let draining = false;
+                    const done = (err) => {
+                        writable.removeListener("error", onError);
+                        if (!util_1.isUndefined(err)) {
+                            this.__client.streamClose(cursor);
+                            reject(err);
+                        }
+                        else {
+                            if (streamOptions.end !== false)
+                                writable.end();
+                            resolve(res);
+                        }
+                    };
+                    const onError = (err) => {
+                        failed = err;
+                        if (draining) {
+                            writable.removeListener("drain", pump);
+                            done(err);
+                        }
+                    };
+                    // next chunk read when the writable is drained
+                    const pump = () => {
+                        draining = false;
+                        this.__client.streamRead(cursor, (err, chunk) => {
+                            if (!util_1.isUndefined(err)) {
+                                done(err);
+                            }
+                            else if (!util_1.isUndefined(failed)) {
+                                done(failed);
+                            }
+                            else if (util_1.isUndefined(chunk)) {
+                                done();
+                            }
+                            else if (writable.write(chunk)) {
+                                pump();
+                            }
+                            else {
+                                draining = true;
+                                writable.once("drain", pump);
+                            }
+                        });
+                    };
+                    writable.on("error", onError);
+                    pump();
+                }, callOptions);
+            }
+            catch (ex) {
+                reject(ex);
+            }
+        });
+    }
+    releaseResult(result) {
+        this.__client.releaseResult(result);
+    }
+    transaction(options = {}) {
+        return new sapnwrfc_transaction_1.Transaction(this, options);
+    }
+    queue(queueName, options = {}) {
+        if (typeof queueName !== "string")
+            throw new TypeError("Queue name must be a string");
+        return new sapnwrfc_transaction_1.Transaction(this, Object.assign({}, options, { queue: queueName }));
+    }
+    unit(options = {}) {
+        return new sapnwrfc_transaction_1.Transaction(this, Object.assign({}, options, { unit: true }));
+    }
     get isAlive() {
         return this.__client.isAlive();
     }
@@ -206,6 +316,9 @@ class Client {
     get _connectionHandle() {
         return this.__client._connectionHandle;
     }
+    get _client() {
+        return this.__client;
+    }
     get status() {
         return this.__status;
     }
@@ -1,22 +1,114 @@
+/// <reference types="node" />
 declare var Promise: any;
-import { Client, RfcConnectionParameters, RfcClientOptions } from "./sapnwrfc-client";
+import { Client, RfcConnectionParameters, RfcClientOptions, RfcCallOptions, RfcObject } from "./sapnwrfc-client";
+import { Writable } from "stream";
 export { Promise };
+export interface RfcPoolClassOptions {
+    priority?: number;
+    reserved?: number;
+}
 export interface RfcPoolOptions {
     min: number;
+    max?: number;
+    queueMax?: number;
+    coalesce?: Array<string>;
+    cache?: {
+        [rfmName: string]: number;
+    };
+    cacheMaxBytes?: number;
+    cacheFile?: string;
+    metadata?: Array<string>;
+    throughput?: boolean;
+    classes?: {
+        [name: string]: RfcPoolClassOptions;
+    };
+}
+export interface RfcAcquireOptions {
+    class?: string;
+    tenant?: string;
+    weight?: number;
+    timeout?: number;
+    deadline?: number | Date;
+}
+export interface RfcPoolSaturation {
+    inUse: number;
+    max?: number;
+    queued: number;
+    queueMax?: number;
+    oldestWait: number;
+}
+export interface RfcPoolClassStatus {
+    priority: number;
+    reserved: number;
+    queued: number;
+    inUse: number;
+    acquired: number;
+    waitTotal: number;
+    waitMax: number;
+}
+export interface RfcExtractOptions {
+    table?: string;
+    partitions?: Array<RfcObject>;
+    window?: number;
+    windowParams?: Array<string>;
+    parallel?: number;
+    ordered?: boolean;
+    retries?: number;
+    end?: boolean;
+    callOptions?: RfcCallOptions;
+    acquireOptions?: RfcAcquireOptions;
+    progress?: (progress: RfcExtractProgress) => void;
+}
+export interface RfcExtractProgress {
+    partition: number;
+    rows: number;
+    done: number;
+    partitions?: number;
+    total: number;
+    retries: number;
 }
 export declare class Pool {
     private __connectionParams;
     private __poolOptions;
     private __clientOptions;
     private __fillRequests;
+    private __classes;
+    private __leases;
+    private __seq;
+    private __coalesce;
+    private __inFlight;
+    private __coalesced;
+    private __cache;
+    private __warm;
+    private __throughput;
+    private __metered;
     private static Ready;
     private static Active;
     constructor(connectionParams: RfcConnectionParameters, poolOptions?: RfcPoolOptions, clientOptions?: RfcClientOptions);
     newClient(): Client;
     refill(): void;
-    acquire(reqId?: Number): Promise<Client>;
+    acquire(reqId?: Number, acquireOptions?: RfcAcquireOptions): Promise<Client>;
+    call(rfmName: string, rfmParams: RfcObject | Buffer, callOptions?: RfcCallOptions, acquireOptions?: RfcAcquireOptions): Promise<RfcObject>;
+    extract(rfmName: string, rfmParams: RfcObject, writable: Writable, extractOptions?: RfcExtractOptions): Promise<RfcExtractProgress>;
+    static keyRanges(field: string, bounds: Array<string>): Array<RfcObject>;
+    private invoke;
+    private poolClass;
+    private dequeue;
+    private admits;
+    private dispatch;
+    private grant;
+    private meter;
+    private unmeter;
+    private warm;
     release(client: Client, reqId?: Number): Promise<void>;
     releaseAll(): Promise<number>;
     get status(): object;
+    clearCache(): void;
+    get throughput(): Float64Array | undefined;
+    get queued(): number;
+    get saturation(): RfcPoolSaturation;
+    get classes(): {
+        [name: string]: RfcPoolClassStatus;
+    };
     get READY(): Array<Number>;
 }
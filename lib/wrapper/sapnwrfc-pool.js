@@ -4,7 +4,75 @@ exports.Pool = exports.Promise = void 0;
 var Promise = require("bluebird");
 exports.Promise = Promise;
 const sapnwrfc_client_1 = require("./sapnwrfc-client");
+const sapnwrfc_cache_1 = require("./sapnwrfc-cache");
+const sapnwrfc_throughput_1 = require("./sapnwrfc-throughput");
 const util_1 = require("util");
+const crypto_1 = require("crypto");
+const METADATA_TTL = 24 * 60 * 60 * 1000;
+function deadline(options) {
+    let expires;
+    if (typeof options.timeout === "number")
+        expires = Date.now() + options.timeout;
+    if (!util_1.isUndefined(options.deadline)) {
+        const time = options.deadline instanceof Date
+            ? options.deadline.getTime()
+            : options.deadline;
+        expires = util_1.isUndefined(expires) ? time : Math.min(expires, time);
+    }
+    return expires;
+}
+function requestKey(rfmName, rfmParams, callOptions) {
+    const options = Object.assign({}, callOptions);
+    delete options.timeout;
+    delete options.deadline;
+    const hash = crypto_1.createHash("sha256")
+        .update(Buffer.isBuffer(rfmParams) ? rfmParams : canonical(rfmParams))
+        .update(canonical(options))
+        .digest("base64");
+    return `${rfmName}:${hash}`;
+}
+function canonical(value) {
+    if (Buffer.isBuffer(value))
+        return `"${value.toString("base64")}"`;
+    if (value instanceof Date)
+        return `"${value.toISOString()}"`;
+    if (Array.isArray(value))
+        return `[${value.map(canonical).join(",")}]`;
+    if (value !== null && typeof value === "object")
+        return `{${Object.keys(value)
+            .sort()
+            .map((key) => `${JSON.stringify(key)}:${canonical(value[key])}`)
+            .join(",")}}`;
+    return JSON.stringify(value);
+}
+function partitionParams(rfmParams, partition) {
+    const params = Object.assign({}, rfmParams, partition);
+    const base = rfmParams.OPTIONS;
+    const range = partition.OPTIONS;
+    if (Array.isArray(base) && base.length > 0 && Array.isArray(range))
+        params.OPTIONS = [
+            { TEXT: "(" },
+            ...base,
+            { TEXT: ") AND (" },
+            ...range,
+            { TEXT: ")" },
+        ];
+    return params;
+}
+function rowCount(rows) {
+    if (Array.isArray(rows))
+        return rows.length;
+    if (rows !== null && typeof rows === "object") {
+        const columns = Object.keys(rows);
+        return columns.length > 0 ? rows[columns[0]].length : 0;
+    }
+    return 0;
+}
+function poolError(name, message) {
+    const error = new Error(message);
+    error.name = name;
+    return error;
+}
 let Pool = (() => {
     class Pool {
         constructor(connectionParams, poolOptions = {
@@ -14,6 +82,21 @@ let Pool = (() => {
             this.__poolOptions = poolOptions;
             this.__clientOptions = clientOptions;
             this.__fillRequests = 0;
+            this.__classes = new Map();
+            this.__leases = new Map();
+            this.__seq = 0;
+            this.__coalesce = new Set(poolOptions.coalesce || []);
+            this.__inFlight = new Map();
+            this.__coalesced = 0;
+            if (!util_1.isUndefined(poolOptions.cache) ||
+                !util_1.isUndefined(poolOptions.cacheFile) ||
+                !util_1.isUndefined(poolOptions.metadata))
+                this.__cache = new sapnwrfc_cache_1.Cache(poolOptions.cacheMaxBytes, poolOptions.cacheFile);
+            this.__metered = new WeakMap();
+            if (poolOptions.throughput)
+                this.__throughput = new sapnwrfc_throughput_1.Throughput();
+            for (let className in poolOptions.classes || {})
+                this.poolClass(className);
         }
         newClient() {
             return this.__clientOptions
@@ -43,53 +126,411 @@ let Pool = (() => {
                 }
             });
         }
-        acquire(reqId) {
-            console.log(`    pool acquire req: ${reqId} ready: ${Pool.Ready.length} ${this.READY}`);
+        acquire(reqId, acquireOptions = {}) {
             return new Promise((resolve, reject) => {
-                const client = Pool.Ready.pop();
-                if (Pool.Ready.length < this.__poolOptions.min)
-                    this.refill();
-                if (client instanceof sapnwrfc_client_1.Client) {
-                    Pool.Active.set(client.id, client);
-                    console.log(`    pool acquire req: ${reqId} client: ${client.id}:${client._connectionHandle} ready: ${Pool.Ready.length} ${this.READY}`);
-                    resolve(client);
+                const className = acquireOptions.class || "default";
+                const poolClass = this.poolClass(className);
+                const tenant = acquireOptions.tenant || "";
+                const weight = acquireOptions.weight || 1;
+                const start = Math.max(poolClass.virtualTime, poolClass.tenants.get(tenant) || 0);
+                const waiter = {
+                    className: className,
+                    finish: start + 1 / weight,
+                    seq: this.__seq++,
+                    queued: Date.now(),
+                    resolve: resolve,
+                    reject: reject,
+                };
+                poolClass.tenants.set(tenant, waiter.finish);
+                poolClass.queue.push(waiter);
+                this.dispatch();
+                if (poolClass.queue.indexOf(waiter) === -1)
+                    return;
+                if (!util_1.isUndefined(this.__poolOptions.queueMax) &&
+                    this.queued > this.__poolOptions.queueMax) {
+                    this.dequeue(waiter);
+                    reject(poolError("RfcPoolOverloadError", `Pool queue limit reached: ${this.__poolOptions.queueMax}`));
+                    return;
                 }
-                else {
-                    const newClient = this.newClient();
-                    newClient.connect((err) => {
-                        if (!util_1.isUndefined(err)) {
-                            reject(err);
+                const expires = deadline(acquireOptions);
+                if (!util_1.isUndefined(expires)) {
+                    waiter.timer = setTimeout(() => {
+                        this.dequeue(waiter);
+                        reject(poolError("RfcTimeoutError", `Pool acquire timed out after ${expires - waiter.queued} ms`));
+                    }, Math.max(0, expires - Date.now()));
+                }
+            });
+        }
+        call(rfmName, rfmParams, callOptions = {}, acquireOptions = {}) {
+            const ttl = (this.__poolOptions.cache || {})[rfmName];
+            const shared = this.__coalesce.has(rfmName);
+            if (util_1.isUndefined(ttl) && !shared)
+                return this.invoke(rfmName, rfmParams, callOptions, acquireOptions);
+            const key = requestKey(rfmName, rfmParams, callOptions);
+            if (!util_1.isUndefined(ttl) && !util_1.isUndefined(this.__cache)) {
+                const cached = this.__cache.get(key);
+                if (!util_1.isUndefined(cached))
+                    return Promise.resolve(cached);
+            }
+            let call = this.__inFlight.get(key);
+            if (!util_1.isUndefined(call)) {
+                this.__coalesced++;
+                return call;
+            }
+            call = this.invoke(rfmName, rfmParams, callOptions, acquireOptions);
+            if (!util_1.isUndefined(ttl) && !util_1.isUndefined(this.__cache)) {
+                const cache = this.__cache;
+                call = call.then((result) => {
+                    cache.set(key, result, ttl);
+                    return result;
+                });
+            }
+            if (shared) {
+                call = call.finally(() => {
+                    this.__inFlight.delete(key);
+                });
+                this.__inFlight.set(key, call);
+            }
+            return call;
+        }
+        extract(rfmName, rfmParams, writable, extractOptions = {}) {
+            return new Promise((resolve, reject) => {
+                const partitions = extractOptions.partitions;
+                const window = extractOptions.window;
+                if (util_1.isUndefined(partitions) === util_1.isUndefined(window)) {
+                    reject(new TypeError("Extract partitions or window option expected"));
+                    return;
+                }
+                const table = extractOptions.table || "DATA";
+                const parallel = Math.max(1, extractOptions.parallel || 4);
+                const retries = util_1.isUndefined(extractOptions.retries)
+                    ? 2
+                    : extractOptions.retries;
+                const [skipParam, countParam] = extractOptions.windowParams || [
+                    "ROWSKIPS",
+                    "ROWCOUNT",
+                ];
+                const status = {
+                    partition: -1,
+                    rows: 0,
+                    done: 0,
+                    partitions: util_1.isUndefined(partitions)
+                        ? undefined
+                        : partitions.length,
+                    total: 0,
+                    retries: 0,
+                };
+                const buffered = new Map();
+                let next = 0;
+                let written = 0;
+                let running = 0;
+                let draining = false;
+                let failed;
+                const params = (partition) => util_1.isUndefined(partitions)
+                    ? Object.assign({}, rfmParams, {
+                        [skipParam]: partition * window,
+                        [countParam]: window,
+                    })
+                    : partitionParams(rfmParams, partitions[partition]);
+                const fail = (err) => {
+                    if (!util_1.isUndefined(failed))
+                        return;
+                    failed = err;
+                    writable.removeListener("error", fail);
+                    writable.removeListener("drain", drained);
+                    reject(err);
+                };
+                const drained = () => {
+                    draining = false;
+                    schedule();
+                };
+                const write = (partition, rows) => {
+                    for (let row of Array.isArray(rows)
+                        ? rows
+                        : util_1.isUndefined(rows)
+                            ? []
+                            : [rows]) {
+                        if (!writable.write(row) && !draining) {
+                            draining = true;
+                            writable.once("drain", drained);
+                        }
+                    }
+                    status.partition = partition;
+                    status.rows = rowCount(rows);
+                    status.done++;
+                    status.total += status.rows;
+                    if (extractOptions.progress)
+                        extractOptions.progress(Object.assign({}, status));
+                };
+                const completed = (partition, rows) => {
+                    running--;
+                    const count = rowCount(rows);
+                    if (!util_1.isUndefined(window) && count < window) {
+                        const end = count === 0 ? partition : partition + 1;
+                        if (util_1.isUndefined(status.partitions) ||
+                            end < status.partitions)
+                            status.partitions = end;
+                    }
+                    if (util_1.isUndefined(status.partitions) ||
+                        partition < status.partitions) {
+                        if (!extractOptions.ordered) {
+                            write(partition, rows);
                         }
                         else {
-                            Pool.Active.set(newClient.id, newClient);
-                            console.log(`    pool acquire req: ${reqId} client: ${newClient.id}:${newClient._connectionHandle} ready: ${Pool.Ready.length} ${this.READY}`);
-                            console.log(this.READY);
-                            resolve(newClient);
+                            buffered.set(partition, rows);
+                            while (buffered.has(written)) {
+                                write(written, buffered.get(written));
+                                buffered.delete(written++);
+                            }
+                        }
+                    }
+                    schedule();
+                };
+                const run = (partition, attempt) => {
+                    this.call(rfmName, params(partition), extractOptions.callOptions, extractOptions.acquireOptions).then((result) => {
+                        if (!util_1.isUndefined(failed))
+                            return;
+                        try {
+                            completed(partition, result[table]);
+                        }
+                        catch (ex) {
+                            fail(ex);
+                        }
+                    }, (err) => {
+                        if (!util_1.isUndefined(failed))
+                            return;
+                        if (attempt < retries) {
+                            status.retries++;
+                            run(partition, attempt + 1);
+                        }
+                        else {
+                            fail(err);
                         }
                     });
-                }
+                };
+                const schedule = () => {
+                    if (!util_1.isUndefined(failed))
+                        return;
+                    const end = util_1.isUndefined(status.partitions)
+                        ? Infinity
+                        : status.partitions;
+                    for (let partition of buffered.keys())
+                        if (partition >= end)
+                            buffered.delete(partition);
+                    if (running === 0 && buffered.size === 0 && next >= end) {
+                        writable.removeListener("error", fail);
+                        writable.removeListener("drain", drained);
+                        if (extractOptions.end !== false)
+                            writable.end();
+                        resolve(status);
+                        return;
+                    }
+                    while (!draining &&
+                        next < end &&
+                        running + buffered.size < parallel) {
+                        running++;
+                        run(next++, 0);
+                    }
+                };
+                writable.on("error", fail);
+                schedule();
             });
         }
+        static keyRanges(field, bounds) {
+            const quote = (bound) => `'${bound.replace(/'/g, "''")}'`;
+            const ranges = [];
+            for (let i = 0; i <= bounds.length; i++) {
+                const options = [];
+                if (i > 0)
+                    options.push({ TEXT: `${field} >= ${quote(bounds[i - 1])}` });
+                if (i < bounds.length)
+                    options.push({
+                        TEXT: `${i > 0 ? "AND " : ""}${field} < ${quote(bounds[i])}`,
+                    });
+                ranges.push(options.length > 0 ? { OPTIONS: options } : {});
+            }
+            return ranges;
+        }
+        invoke(rfmName, rfmParams, callOptions, acquireOptions) {
+            const expires = deadline(callOptions);
+            if (!util_1.isUndefined(expires)) {
+                callOptions = Object.assign({}, callOptions, { deadline: expires });
+                delete callOptions.timeout;
+                acquireOptions = Object.assign({ deadline: expires }, acquireOptions);
+            }
+            return this.acquire(undefined, acquireOptions).then((client) => client.call(rfmName, rfmParams, callOptions).finally(() => {
+                this.release(client);
+            }));
+        }
+        poolClass(className) {
+            let poolClass = this.__classes.get(className);
+            if (util_1.isUndefined(poolClass)) {
+                const classOptions = (this.__poolOptions.classes || {})[className] || {};
+                poolClass = {
+                    priority: classOptions.priority || 0,
+                    reserved: classOptions.reserved || 0,
+                    inUse: 0,
+                    virtualTime: 0,
+                    tenants: new Map(),
+                    queue: [],
+                    acquired: 0,
+                    waitTotal: 0,
+                    waitMax: 0,
+                };
+                this.__classes.set(className, poolClass);
+            }
+            return poolClass;
+        }
+        dequeue(waiter) {
+            const queue = this.poolClass(waiter.className).queue;
+            const index = queue.indexOf(waiter);
+            if (index !== -1)
+                queue.splice(index, 1);
+        }
+        admits(className) {
+            if (util_1.isUndefined(this.__poolOptions.max))
+                return true;
+            let inUse = 0;
+            let reserved = 0;
+            for (let [name, poolClass] of this.__classes) {
+                inUse += poolClass.inUse;
+                if (name !== className)
+                    reserved += Math.max(0, poolClass.reserved - poolClass.inUse);
+            }
+            return this.__poolOptions.max - inUse > reserved;
+        }
+        dispatch() {
+            const classes = Array.from(this.__classes.entries()).sort((a, b) => b[1].priority - a[1].priority);
+            for (;;) {
+                let granted = false;
+                for (let [name, poolClass] of classes) {
+                    if (poolClass.queue.length === 0 || !this.admits(name))
+                        continue;
+                    let next = 0;
+                    for (let i = 1; i < poolClass.queue.length; i++) {
+                        const waiter = poolClass.queue[i];
+                        const best = poolClass.queue[next];
+                        if (waiter.finish < best.finish ||
+                            (waiter.finish === best.finish && waiter.seq < best.seq))
+                            next = i;
+                    }
+                    const waiter = poolClass.queue.splice(next, 1)[0];
+                    if (!util_1.isUndefined(waiter.timer))
+                        clearTimeout(waiter.timer);
+                    poolClass.virtualTime = waiter.finish;
+                    if (poolClass.queue.length === 0)
+                        poolClass.tenants.clear();
+                    this.grant(poolClass, waiter);
+                    granted = true;
+                    break;
+                }
+                if (!granted)
+                    return;
+            }
+        }
+        grant(poolClass, waiter) {
+            const wait = Date.now() - waiter.queued;
+            poolClass.inUse++;
+            poolClass.acquired++;
+            poolClass.waitTotal += wait;
+            poolClass.waitMax = Math.max(poolClass.waitMax, wait);
+            const client = Pool.Ready.pop();
+            if (Pool.Ready.length < this.__poolOptions.min)
+                this.refill();
+            if (client instanceof sapnwrfc_client_1.Client) {
+                Pool.Active.set(client.id, client);
+                this.__leases.set(client.id, waiter.className);
+                this.meter(client);
+                this.warm(client, waiter);
+            }
+            else {
+                const newClient = this.newClient();
+                newClient.connect((err) => {
+                    if (!util_1.isUndefined(err)) {
+                        poolClass.inUse--;
+                        waiter.reject(err);
+                        this.dispatch();
+                    }
+                    else {
+                        Pool.Active.set(newClient.id, newClient);
+                        this.__leases.set(newClient.id, waiter.className);
+                        this.meter(newClient);
+                        this.warm(newClient, waiter);
+                    }
+                });
+            }
+        }
+        meter(client) {
+            if (util_1.isUndefined(this.__throughput))
+                return;
+            if (this.__metered.get(client) === client._connectionHandle)
+                return;
+            this.__throughput.setOnConnection(client);
+            this.__metered.set(client, client._connectionHandle);
+        }
+        unmeter(client) {
+            if (util_1.isUndefined(this.__throughput))
+                return;
+            this.__throughput.removeFromConnection(client);
+            this.__metered.delete(client);
+        }
+        warm(client, waiter) {
+            const rfmNames = this.__poolOptions.metadata;
+            if (util_1.isUndefined(rfmNames) || util_1.isUndefined(this.__cache)) {
+                waiter.resolve(client);
+                return;
+            }
+            if (util_1.isUndefined(this.__warm)) {
+                const cache = this.__cache;
+                const params = Object.assign({}, this.__connectionParams);
+                delete params.passwd;
+                const hash = crypto_1.createHash("sha256")
+                    .update(canonical(params))
+                    .update(canonical(rfmNames))
+                    .digest("base64");
+                const key = `metadata:${hash}`;
+                const exported = () => client.exportMetadata(rfmNames).then((snapshot) => {
+                    cache.set(key, snapshot, METADATA_TTL);
+                });
+                const snapshot = cache.get(key);
+                this.__warm = (util_1.isUndefined(snapshot)
+                    ? exported()
+                    : client.importMetadata(snapshot).catch(exported)).catch(() => { });
+            }
+            this.__warm.then(() => waiter.resolve(client));
+        }
         release(client, reqId) {
             return new Promise((resolve, reject) => {
                 if (!(client instanceof sapnwrfc_client_1.Client))
                     reject(new TypeError("Pool release() method requires a client instance as argument"));
                 const id = client.id;
                 Pool.Active.delete(id);
-                if (Pool.Ready.length < this.__poolOptions.min) {
+                const className = this.__leases.get(id);
+                if (!util_1.isUndefined(className)) {
+                    this.__leases.delete(id);
+                    this.poolClass(className).inUse--;
+                }
+                if (Pool.Ready.length < this.__poolOptions.min ||
+                    this.queued > 0) {
                     Pool.Ready.push(client);
                 }
                 else {
+                    this.unmeter(client);
+                    client.close(() => { });
                 }
-                console.log(`    pool release req: ${reqId} client: ${client.id}:${client._connectionHandle} ready: ${Pool.Ready.length} ${this.READY}`);
                 resolve(id);
+                this.dispatch();
             });
         }
         releaseAll() {
             return new Promise((resolve) => {
                 const toBeClosed = Pool.Ready.length + Pool.Active.size;
                 let closed = 0;
+                this.__leases.clear();
+                for (let poolClass of this.__classes.values())
+                    poolClass.inUse = 0;
                 for (let [id, client] of Pool.Active.entries()) {
+                    this.unmeter(client);
                     client.close(() => {
                         closed++;
                         if (closed === toBeClosed) {
@@ -99,23 +540,79 @@ let Pool = (() => {
                         }
                     });
                 }
-                Pool.Ready.forEach((client) => client.close(() => {
-                    closed++;
-                    if (closed === toBeClosed) {
-                        Pool.Ready = [];
-                        Pool.Active = new Map();
-                        resolve(closed);
-                    }
-                }));
+                Pool.Ready.forEach((client) => {
+                    this.unmeter(client);
+                    client.close(() => {
+                        closed++;
+                        if (closed === toBeClosed) {
+                            Pool.Ready = [];
+                            Pool.Active = new Map();
+                            resolve(closed);
+                        }
+                    });
+                });
             });
         }
         get status() {
             return {
                 active: Pool.Active.size,
                 ready: Pool.Ready.length,
+                queued: this.queued,
+                classes: this.classes,
+                coalesced: this.__coalesced,
+                cache: util_1.isUndefined(this.__cache) ? undefined : this.__cache.status,
                 options: this.__poolOptions,
             };
         }
+        clearCache() {
+            if (!util_1.isUndefined(this.__cache))
+                this.__cache.clear();
+        }
+        get throughput() {
+            return util_1.isUndefined(this.__throughput)
+                ? undefined
+                : this.__throughput.snapshot();
+        }
+        get queued() {
+            let queued = 0;
+            for (let poolClass of this.__classes.values())
+                queued += poolClass.queue.length;
+            return queued;
+        }
+        get saturation() {
+            const now = Date.now();
+            let inUse = 0;
+            let queued = 0;
+            let oldest = now;
+            for (let poolClass of this.__classes.values()) {
+                inUse += poolClass.inUse;
+                queued += poolClass.queue.length;
+                for (let waiter of poolClass.queue)
+                    oldest = Math.min(oldest, waiter.queued);
+            }
+            return {
+                inUse: inUse,
+                max: this.__poolOptions.max,
+                queued: queued,
+                queueMax: this.__poolOptions.queueMax,
+                oldestWait: now - oldest,
+            };
+        }
+        get classes() {
+            const classes = {};
+            for (let [name, poolClass] of this.__classes) {
+                classes[name] = {
+                    priority: poolClass.priority,
+                    reserved: poolClass.reserved,
+                    queued: poolClass.queue.length,
+                    inUse: poolClass.inUse,
+                    acquired: poolClass.acquired,
+                    waitTotal: poolClass.waitTotal,
+                    waitMax: poolClass.waitMax,
+                };
+            }
+            return classes;
+        }
         get READY() {
             const ready = new Array();
             for (let c of Pool.Ready)
@@ -0,0 +1,29 @@
+import { Client, RfcClientBinding, RfcConnectionParameters, RfcObject } from "./sapnwrfc-client";
+export interface RfcServerOptions {
+    threads?: number;
+}
+export declare type RfcServerFunction = (abapInput: RfcObject) => RfcObject | void | Promise<RfcObject | void>;
+export interface RfcServerBinding {
+    new (serverParams: RfcConnectionParameters, client: RfcClientBinding, options?: RfcServerOptions): RfcServerBinding;
+    (serverParams: RfcConnectionParameters, client: RfcClientBinding, options?: RfcServerOptions): RfcServerBinding;
+    start(callback: Function): void;
+    stop(callback: Function): void;
+    addFunction(abapFunctionName: string, jsFunction: RfcServerFunction, callback: Function): void;
+    removeFunction(abapFunctionName: string): boolean;
+    id: number;
+    alive: boolean;
+    threads: number;
+}
+export declare class Server {
+    private __server;
+    private __client;
+    constructor(serverParams: RfcConnectionParameters, client: Client, options?: RfcServerOptions);
+    start(callback?: Function): Promise<void> | any;
+    stop(callback?: Function): Promise<void> | any;
+    addFunction(abapFunctionName: string, jsFunction: RfcServerFunction, callback?: Function): Promise<void> | any;
+    removeFunction(abapFunctionName: string): boolean;
+    get id(): number;
+    get alive(): boolean;
+    get threads(): number;
+    get client(): Client;
+}
@@ -0,0 +1,97 @@
+"use strict";
+Object.defineProperty(exports, "__esModule", { value: true });
+exports.Server = void 0;
+var Promise = require("bluebird");
+const sapnwrfc_client_1 = require("./sapnwrfc-client");
+const util_1 = require("util");
+class Server {
+    constructor(serverParams, client, options) {
+        if (!(client instanceof sapnwrfc_client_1.Client))
+            throw new TypeError("Client instance required as second argument");
+        this.__client = client;
+        this.__server = options
+            ? new sapnwrfc_client_1.binding.Server(serverParams, client._client, options)
+            : new sapnwrfc_client_1.binding.Server(serverParams, client._client);
+    }
+    start(callback) {
+        if (typeof callback === "function") {
+            return this.__server.start(callback);
+        }
+        else if (!util_1.isUndefined(callback)) {
+            throw new TypeError(`Start callback, if provided, must be a function, received: typeof ${callback}`);
+        }
+        else {
+            return new Promise((resolve, reject) => {
+                this.__server.start((err) => {
+                    if (!util_1.isUndefined(err)) {
+                        reject(err);
+                    }
+                    else {
+                        resolve();
+                    }
+                });
+            });
+        }
+    }
+    stop(callback) {
+        if (typeof callback === "function") {
+            return this.__server.stop(callback);
+        }
+        else if (!util_1.isUndefined(callback)) {
+            throw new TypeError(`Stop callback, if provided, must be a function, received: typeof ${callback}`);
+        }
+        else {
+            return new Promise((resolve, reject) => {
+                this.__server.stop((err) => {
+                    if (!util_1.isUndefined(err)) {
+                        reject(err);
+                    }
+                    else {
+                        resolve();
+                    }
+                });
+            });
+        }
+    }
+    addFunction(abapFunctionName, jsFunction, callback) {
+        if (typeof abapFunctionName !== "string")
+            throw new TypeError("First argument (ABAP function name) must be a string");
+        if (typeof jsFunction !== "function")
+            throw new TypeError("Second argument (JavaScript function) must be a function");
+        if (typeof callback === "function") {
+            return this.__server.addFunction(abapFunctionName, jsFunction, callback);
+        }
+        else if (!util_1.isUndefined(callback)) {
+            throw new TypeError(`Callback, if provided, must be a function, received: typeof ${callback}`);
+        }
+        else {
+            return new Promise((resolve, reject) => {
+                this.__server.addFunction(abapFunctionName, jsFunction, (err) => {
+                    if (!util_1.isUndefined(err)) {
+                        reject(err);
+                    }
+                    else {
+                        resolve();
+                    }
+                });
+            });
+        }
+    }
+    removeFunction(abapFunctionName) {
+        return this.__server.removeFunction(abapFunctionName);
+    }
+    get id() {
+        return this.__server.id;
+    }
+    get alive() {
+        return this.__server.alive;
+    }
+    get threads() {
+        return this.__server.threads;
+    }
+    get client() {
+        return this.__client;
+    }
+}
+exports.Server = Server;
+//# sourceMappingURL=sapnwrfc-server.js.map
\ No newline at end of file
@@ -10,6 +10,7 @@ export interface RfcThroughputBinding {
     getFromConnection(_connectionHandle: number): any;
     reset(): void;
     destroy(): void;
+    snapshot(values: Float64Array): any;
 }
 export interface RfcThroughputStatus {
     numberOfCalls: number;
@@ -20,9 +21,24 @@ export interface RfcThroughputStatus {
     serializationTime: number;
     deserializationTime: number;
 }
+export declare enum RfcThroughputIndex {
+    numberOfCalls = 0,
+    sentBytes = 1,
+    receivedBytes = 2,
+    applicationTime = 3,
+    totalTime = 4,
+    serializationTime = 5,
+    deserializationTime = 6,
+    interval = 7,
+    callsPerSecond = 8,
+    sentBytesPerSecond = 9,
+    receivedBytesPerSecond = 10,
+    meanApplicationTime = 11
+}
 export declare class Throughput {
     private __throughput;
     private __clients;
+    private __snapshot;
     private static __Handles;
     constructor(client?: Client | Array<Client>);
     setOnConnection(client: Client | Array<Client>): void;
@@ -31,6 +47,7 @@ export declare class Throughput {
     reset(): void;
     destroy(): void;
     get status(): RfcThroughputStatus;
+    snapshot(): Float64Array;
     get clients(): Set<Client>;
     get _handle(): number;
 }
@@ -1,12 +1,28 @@
 "use strict";
 Object.defineProperty(exports, "__esModule", { value: true });
-exports.Throughput = void 0;
+exports.Throughput = exports.RfcThroughputIndex = void 0;
 const sapnwrfc_client_1 = require("./sapnwrfc-client");
 const util_1 = require("util");
+var RfcThroughputIndex;
+(function (RfcThroughputIndex) {
+    RfcThroughputIndex[RfcThroughputIndex["numberOfCalls"] = 0] = "numberOfCalls";
+    RfcThroughputIndex[RfcThroughputIndex["sentBytes"] = 1] = "sentBytes";
+    RfcThroughputIndex[RfcThroughputIndex["receivedBytes"] = 2] = "receivedBytes";
+    RfcThroughputIndex[RfcThroughputIndex["applicationTime"] = 3] = "applicationTime";
+    RfcThroughputIndex[RfcThroughputIndex["totalTime"] = 4] = "totalTime";
+    RfcThroughputIndex[RfcThroughputIndex["serializationTime"] = 5] = "serializationTime";
+    RfcThroughputIndex[RfcThroughputIndex["deserializationTime"] = 6] = "deserializationTime";
+    RfcThroughputIndex[RfcThroughputIndex["interval"] = 7] = "interval";
+    RfcThroughputIndex[RfcThroughputIndex["callsPerSecond"] = 8] = "callsPerSecond";
+    RfcThroughputIndex[RfcThroughputIndex["sentBytesPerSecond"] = 9] = "sentBytesPerSecond";
+    RfcThroughputIndex[RfcThroughputIndex["receivedBytesPerSecond"] = 10] = "receivedBytesPerSecond";
+    RfcThroughputIndex[RfcThroughputIndex["meanApplicationTime"] = 11] = "meanApplicationTime";
+})(RfcThroughputIndex = exports.RfcThroughputIndex || (exports.RfcThroughputIndex = {}));
 let Throughput = (() => {
     class Throughput {
         constructor(client) {
             this.__clients = new Set();
+            this.__snapshot = new Float64Array(RfcThroughputIndex.meanApplicationTime + 1);
             this.__throughput = new sapnwrfc_client_1.binding.Throughput();
             Throughput.__Handles.set(this.__throughput._handle, this);
             if (client)
@@ -70,6 +86,12 @@ let Throughput = (() => {
         get status() {
             return this.__throughput.status;
         }
+        snapshot() {
+            const e = this.__throughput.snapshot(this.__snapshot);
+            if (!util_1.isUndefined(e))
+                throw new Error(JSON.stringify(e));
+            return this.__snapshot;
+        }
         get clients() {
             return this.__clients;
         }
@@ -0,0 +1,40 @@
+import { Client, RfcClientBinding, RfcObject } from "./sapnwrfc-client";
+export interface RfcTransactionOptions {
+    unit?: boolean;
+    queue?: string | Array<string>;
+    id?: string;
+}
+export interface RfcTransactionBinding {
+    new (client: RfcClientBinding, options?: RfcTransactionOptions): RfcTransactionBinding;
+    (client: RfcClientBinding, options?: RfcTransactionOptions): RfcTransactionBinding;
+    create(callback: Function): void;
+    add(rfmName: string, rfmParams: RfcObject, callback: Function): void;
+    submit(callback: Function): void;
+    confirm(callback: Function): void;
+    destroy(): void;
+    id: number;
+    tid: string;
+    type: string;
+    queue: Array<string>;
+}
+export declare type RfcTransactionCall = {
+    rfmName: string;
+    rfmParams: RfcObject;
+};
+export declare class Transaction {
+    private __transaction;
+    private __client;
+    private __calls;
+    constructor(client: Client, options?: RfcTransactionOptions);
+    private __call;
+    add(rfmName: string, rfmParams?: RfcObject): Transaction;
+    submit(beforeSubmit?: (tid: string) => any): Promise<string>;
+    confirm(): Promise<void>;
+    destroy(): void;
+    get id(): number;
+    get tid(): string;
+    get type(): string;
+    get queue(): Array<string>;
+    get calls(): Array<RfcTransactionCall>;
+    get client(): Client;
+}
@@ -0,0 +1,85 @@
+"use strict";
+Object.defineProperty(exports, "__esModule", { value: true });
+exports.Transaction = void 0;
+var Promise = require("bluebird");
+const sapnwrfc_client_1 = require("./sapnwrfc-client");
+const util_1 = require("util");
+class Transaction {
+    constructor(client, options) {
+        this.__calls = [];
+        if (!(client instanceof sapnwrfc_client_1.Client))
+            throw new TypeError("Client instance required as first argument");
+        this.__client = client;
+        this.__transaction = options
+            ? new sapnwrfc_client_1.binding.Transaction(client._client, options)
+            : new sapnwrfc_client_1.binding.Transaction(client._client);
+    }
+    __call(method, ...args) {
+        return new Promise((resolve, reject) => {
+            this.__transaction[method](...args, (err, res) => {
+                if (!util_1.isUndefined(err)) {
+                    reject(err);
+                }
+                else {
+                    resolve(res);
+                }
+            });
+        });
+    }
+    add(rfmName, rfmParams = {}) {
+        if (typeof rfmName !== "string")
+            throw new TypeError("First argument (remote function module name) must be an string");
+        if (typeof rfmParams !== "object")
+            throw new TypeError("Second argument (remote function module parameters) must be an object");
+        this.__calls.push({ rfmName: rfmName, rfmParams: rfmParams });
+        return this;
+    }
+    submit(beforeSubmit) {
+        if (!util_1.isUndefined(beforeSubmit) && typeof beforeSubmit !== "function")
+            throw new TypeError(`beforeSubmit, if provided, must be a function, received: typeof ${beforeSubmit}`);
+        if (this.__calls.length === 0)
+            return Promise.reject(new Error("No function calls added to transaction"));
+        return this.__call("create")
+            .then((tid) => {
+            if (beforeSubmit)
+                return Promise.resolve(beforeSubmit(tid));
+        })
+            .then(() => Promise.each(this.__calls, (call) => this.__call("add", call.rfmName, call.rfmParams)))
+            .then(() => this.__call("submit"))
+            .then(() => {
+            this.__calls = [];
+            return this.__transaction.tid;
+        })
+            .catch((err) => {
+            this.__transaction.destroy();
+            throw err;
+        });
+    }
+    confirm() {
+        return this.__call("confirm");
+    }
+    destroy() {
+        this.__calls = [];
+        this.__transaction.destroy();
+    }
+    get id() {
+        return this.__transaction.id;
+    }
+    get tid() {
+        return this.__transaction.tid;
+    }
+    get type() {
+        return this.__transaction.type;
+    }
+    get queue() {
+        return this.__transaction.queue;
+    }
+    get calls() {
+        return this.__calls;
+    }
+    get client() {
+        return this.__client;
+    }
+}
+exports.Transaction = Transaction;
+//# sourceMappingURL=sapnwrfc-transaction.js.map
\ No newline at end of file
@@ -0,0 +1,237 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+
+#include <uv.h>
+#include "Cache.h"
+
+#define NODERFC_CACHE_MAX_BYTES (64 * 1024 * 1024)
+
+namespace node_rfc
+{
+
+    static uint64_t nowMs(void)
+    {
+        return uv_hrtime() / 1000000;
+    }
+
+    Cache::Cache(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Cache>(info)
+    {
+        if (!info.IsConstructCall())
+        {
+            Napi::Error::New(info.Env(), "Use the new operator to create instances of Rfc Cache.").ThrowAsJavaScriptException();
+            return;
+        }
+        bytes = 0;
+        shared = NULL;
+        maxBytes = NODERFC_CACHE_MAX_BYTES;
+        hits = misses = evictions = expired = 0;
+        if (info[0].IsNumber())
+        {
+            maxBytes = (size_t)info[0].As<Napi::Number>().Int64Value();
+        }
+        else if (!info[0].IsUndefined())
+        {
+            Napi::TypeError::New(info.Env(), "Cache size in bytes must be a number").ThrowAsJavaScriptException();
+            return;
+        }
+        if (info[1].IsString())
+        {
+            std::string errorMessage;
+            shared = new SharedStore();
+            if (!shared->open(info[1].As<Napi::String>().Utf8Value(), maxBytes, errorMessage))
+            {
+                delete shared;
+                shared = NULL;
+                Napi::Error::New(info.Env(), errorMessage).ThrowAsJavaScriptException();
+            }
+        }
+        else if (!info[1].IsUndefined())
+        {
+            Napi::TypeError::New(info.Env(), "Shared cache file path must be a string").ThrowAsJavaScriptException();
+        }
+    }
+
+    Cache::~Cache(void)
+    {
+        if (shared != NULL)
+        {
+            delete shared;
+        }
+    }
+
+    Napi::Object Cache::Init(Napi::Env env, Napi::Object exports)
+    {
+        Napi::HandleScope scope(env);
+
+        Napi::Function t = DefineClass(
+            env, "Cache",
+            {
+                InstanceAccessor("status", &Cache::StatusGetter, nullptr),
+                InstanceMethod("get", &Cache::Get),
+                InstanceMethod("set", &Cache::Set),
+                InstanceMethod("delete", &Cache::Delete),
+                InstanceMethod("clear", &Cache::Clear),
+            });
+
+        addonData(env)->cacheConstructor = Napi::Persistent(t);
+
+        exports.Set("Cache", t);
+        return exports;
+    }
+
+    void Cache::erase(std::list<CacheEntry>::iterator entry)
+    {
+        bytes -= entry->key.size() + entry->data.size();
+        entries.erase(entry->key);
+        lru.erase(entry);
+    }
+
+    Napi::Value Cache::Get(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsString())
+        {
+            Napi::TypeError::New(info.Env(), "Cache key must be a string").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        if (shared != NULL)
+        {
+            std::string data;
+            int rc = shared->get(info[0].As<Napi::String>().Utf8Value(), data);
+            if (rc != 0)
+            {
+                misses++;
+                expired += rc == 2 ? 1 : 0;
+                evictions += rc == 3 ? 1 : 0;
+                return info.Env().Undefined();
+            }
+            hits++;
+            return Napi::Buffer<char>::Copy(info.Env(), data.data(), data.size());
+        }
+        std::unordered_map<std::string, std::list<CacheEntry>::iterator>::iterator found = entries.find(info[0].As<Napi::String>().Utf8Value());
+        if (found == entries.end())
+        {
+            misses++;
+            return info.Env().Undefined();
+        }
+        std::list<CacheEntry>::iterator entry = found->second;
+        if (entry->expires <= nowMs())
+        {
+            expired++;
+            misses++;
+            erase(entry);
+            return info.Env().Undefined();
+        }
+        hits++;
+        lru.splice(lru.begin(), lru, entry);
+        return Napi::Buffer<char>::Copy(info.Env(), entry->data.data(), entry->data.size());
+    }
+
+    Napi::Value Cache::Set(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsString() || !info[1].IsBuffer() || !info[2].IsNumber())
+        {
+            Napi::TypeError::New(info.Env(), "Cache key string, value Buffer and TTL milliseconds expected").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        std::string key = info[0].As<Napi::String>().Utf8Value();
+        Napi::Buffer<char> value = info[1].As<Napi::Buffer<char>>();
+        int64_t ttl = info[2].As<Napi::Number>().Int64Value();
+
+        if (shared != NULL)
+        {
+            if (ttl <= 0)
+            {
+                shared->remove(key);
+                return Napi::Boolean::New(info.Env(), false);
+            }
+            return Napi::Boolean::New(info.Env(), shared->set(key, value.Data(), value.Length(), (uint64_t)ttl));
+        }
+
+        std::unordered_map<std::string, std::list<CacheEntry>::iterator>::iterator found = entries.find(key);
+        if (found != entries.end())
+        {
+            erase(found->second);
+        }
+
+        // larger than the whole cache, not stored
+        size_t size = key.size() + value.Length();
+        if (ttl <= 0 || size > maxBytes)
+        {
+            return Napi::Boolean::New(info.Env(), false);
+        }
+
+        while (bytes + size > maxBytes)
+        {
+            evictions++;
+            erase(--lru.end());
+        }
+
+        CacheEntry entry;
+        entry.key = key;
+        entry.data.assign(value.Data(), value.Length());
+        entry.expires = nowMs() + ttl;
+        lru.push_front(entry);
+        entries[key] = lru.begin();
+        bytes += size;
+        return Napi::Boolean::New(info.Env(), true);
+    }
+
+    Napi::Value Cache::Delete(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsString())
+        {
+            Napi::TypeError::New(info.Env(), "Cache key must be a string").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        if (shared != NULL)
+        {
+            return Napi::Boolean::New(info.Env(), shared->remove(info[0].As<Napi::String>().Utf8Value()));
+        }
+        std::unordered_map<std::string, std::list<CacheEntry>::iterator>::iterator found = entries.find(info[0].As<Napi::String>().Utf8Value());
+        if (found == entries.end())
+        {
+            return Napi::Boolean::New(info.Env(), false);
+        }
+        erase(found->second);
+        return Napi::Boolean::New(info.Env(), true);
+    }
+
+    Napi::Value Cache::Clear(const Napi::CallbackInfo &info)
+    {
+        if (shared != NULL)
+        {
+            shared->clear();
+        }
+        lru.clear();
+        entries.clear();
+        bytes = 0;
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Cache::StatusGetter(const Napi::CallbackInfo &info)
+    {
+        Napi::Object status = Napi::Object::New(info.Env());
+        status.Set("entries", Napi::Number::New(info.Env(), (double)(shared != NULL ? shared->entries() : entries.size())));
+        status.Set("bytes", Napi::Number::New(info.Env(), (double)(shared != NULL ? shared->bytes() : bytes)));
+        status.Set("maxBytes", Napi::Number::New(info.Env(), (double)maxBytes));
+        status.Set("hits", Napi::Number::New(info.Env(), hits));
+        status.Set("misses", Napi::Number::New(info.Env(), misses));
+        status.Set("evictions", Napi::Number::New(info.Env(), evictions));
+        status.Set("expired", Napi::Number::New(info.Env(), expired));
+        status.Set("shared", Napi::Boolean::New(info.Env(), shared != NULL));
+        return status;
+    }
+
+} // namespace node_rfc
@@ -0,0 +1,75 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+
+#ifndef NODE_SAPNWRFC_CACHE_H_
+#define NODE_SAPNWRFC_CACHE_H_
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <napi.h>
+#include "addon.h"
+#include "shared.h"
+
+using namespace Napi;
+
+namespace node_rfc
+{
+    // Serialized RFC results outside of the V8 heap, TTL and LRU eviction by size,
+    // or in a memory mapped file shared by processes, with oldest records overwritten
+    class Cache : public Napi::ObjectWrap<Cache>
+    {
+    public:
+        static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+        Cache(const Napi::CallbackInfo &info);
+        ~Cache(void);
+
+    private:
+        typedef struct _CacheEntry
+        {
+            std::string key;
+            std::string data;
+            uint64_t expires; // uv_hrtime() milliseconds
+        } CacheEntry;
+
+        // Cache API
+
+        Napi::Value StatusGetter(const Napi::CallbackInfo &info);
+        Napi::Value Get(const Napi::CallbackInfo &info);
+        Napi::Value Set(const Napi::CallbackInfo &info);
+        Napi::Value Delete(const Napi::CallbackInfo &info);
+        Napi::Value Clear(const Napi::CallbackInfo &info);
+
+        void erase(std::list<CacheEntry>::iterator entry);
+
+        // most recently used first
+        std::list<CacheEntry> lru;
+        std::unordered_map<std::string, std::list<CacheEntry>::iterator> entries;
+
+        // shared file store, NULL: in process
+        SharedStore *shared;
+
+        size_t bytes;
+        size_t maxBytes;
+        double hits;
+        double misses;
+        double evictions;
+        double expired;
+    };
+
+} // namespace node_rfc
+
+#endif // NODE_SAPNWRFC_CACHE_H_
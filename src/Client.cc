@@ -12,16 +12,15 @@
 // either express or implied. See the License for the specific
 // language governing permissions and limitations under the License.
 
+#include <chrono>
 #include "Client.h"
 #include "noderfcsdk.h"
+#include "watchdog.h"
 #include "macros.h"
 
 namespace node_rfc
 {
 
-    unsigned int Client::__refCounter = 0;
-    extern Napi::Env __env;
-
     class ConnectAsync : public Napi::AsyncWorker
     {
     public:
@@ -42,7 +41,7 @@ namespace node_rfc
 
             if (!client->alive)
             {
-                Napi::Value argv[1] = {wrapError(&errorInfo)};
+                Napi::Value argv[1] = {wrapError(Env(), &errorInfo)};
                 CALLBACK_CALL(Env().Global(), Callback(), 1, argv);
             }
             else
@@ -108,7 +107,7 @@ namespace node_rfc
             }
             else
             {
-                Napi::Value argv[1] = {wrapError(&errorInfo)};
+                Napi::Value argv[1] = {wrapError(Env(), &errorInfo)};
                 CALLBACK_CALL(Env().Global(), Callback(), 1, argv);
             }
         }
@@ -141,7 +140,7 @@ namespace node_rfc
             client->UnlockMutex();
             Napi::Value argv[2] = {Env().Undefined(), Env().Undefined()};
             if (errorInfo.code != RFC_OK)
-                argv[0] = wrapError(&errorInfo);
+                argv[0] = wrapError(Env(), &errorInfo);
             argv[1] = Napi::Boolean::New(Env(), isValid && errorInfo.code == RFC_OK);
             CALLBACK_CALL(Env().Global(), Callback(), 2, argv);
         }
@@ -154,24 +153,131 @@ namespace node_rfc
     class InvokeAsync : public Napi::AsyncWorker
     {
     public:
-        InvokeAsync(Napi::Function &callback, Client *client, RFC_FUNCTION_HANDLE functionHandle, RFC_FUNCTION_DESC_HANDLE functionDescHandle)
+        InvokeAsync(Napi::Function &callback, Client *client, RFC_FUNCTION_HANDLE functionHandle, RFC_FUNCTION_DESC_HANDLE functionDescHandle, Napi::Value jsonParams, InvokeOptions &options)
             : Napi::AsyncWorker(callback), callback(Napi::Persistent(callback)),
-              client(client), functionHandle(functionHandle), functionDescHandle(functionDescHandle)
+              client(client), functionHandle(functionHandle), functionDescHandle(functionDescHandle), options(options)
         {
+            jsonParamsData = NULL;
+            jsonParamsLength = 0;
+            if (jsonParams.IsBuffer())
+            {
+                // not copied, referenced until the call completes
+                Napi::Buffer<char> buffer = jsonParams.As<Napi::Buffer<char>>();
+                jsonParamsRef = Napi::Persistent(jsonParams.As<Napi::Object>());
+                jsonParamsData = buffer.Data();
+                jsonParamsLength = buffer.Length();
+            }
+        }
+        ~InvokeAsync()
+        {
+            for (size_t i = 0; i < arrowStreams.size(); i++)
+            {
+                delete arrowStreams[i];
+            }
         }
-        ~InvokeAsync() {}
 
         void Execute()
         {
             client->LockMutex();
+
+            timedOut = false;
+            jsonFilled = true;
+            if (jsonParamsData != NULL)
+            {
+                jsonFilled = client->jsonFill(functionDescHandle, functionHandle, jsonParamsData, jsonParamsLength, jsonErrorMessage, &jsonErrorInfo);
+                if (!jsonFilled)
+                {
+                    return;
+                }
+            }
+
+            // deadline passed while queued, or RFC call cancelled by the watchdog
+            if (options.deadline != 0)
+            {
+                if (options.deadline <= uv_hrtime())
+                {
+                    timedOut = true;
+                    return;
+                }
+                deadline.connectionHandle = client->connectionHandle;
+                deadline.expires = options.deadline;
+                watchdogAdd(&deadline);
+            }
+
             RfcInvoke(client->connectionHandle, functionHandle, &errorInfo);
+
+            if (options.deadline != 0)
+            {
+                watchdogRemove(&deadline);
+                if (deadline.cancelled)
+                {
+                    // connection closed by RfcCancel(), reopened here instead of on the main thread
+                    timedOut = true;
+                    RFC_ERROR_INFO openErrorInfo;
+                    client->connectionHandle = RfcOpenConnection(client->connectionParams, client->paramSize, &openErrorInfo);
+                    client->alive = (openErrorInfo.code == RFC_OK);
+                    return;
+                }
+            }
+
+            // JSON serialized here, unless JS conversion functions to be called
+            jsonSerialized = false;
+            if (options.json && errorInfo.code == RFC_OK && !client->jsonConversions())
+            {
+                jsonSerialized = client->jsonResult(functionDescHandle, functionHandle, jsonResult, &jsonErrorInfo);
+                if (!jsonSerialized)
+                {
+                    jsonResult.clear();
+                }
+            }
+
+            // Arrow streams built here, table rows released after export
+            arrowExported = true;
+            if (!options.arrow.empty() && errorInfo.code == RFC_OK)
+            {
+                arrowExported = exportArrow();
+            }
+
+            // fixed-width lines split here, rows released after the split
+            splitDone = true;
+            if (!options.split.empty() && errorInfo.code == RFC_OK && arrowExported)
+            {
+                splitDone = client->splitTable(functionDescHandle, functionHandle, options, split, splitErrorMessage, &splitErrorInfo);
+            }
+
+            // streamed table validated here, rows read after the call
+            streamPrepared = true;
+            if (!options.stream.empty() && errorInfo.code == RFC_OK && arrowExported && splitDone)
+            {
+                streamPrepared = prepareStream();
+            }
         }
 
         void OnOK()
         {
-            Napi::Value argv[2] = {Env().Undefined(), Env().Undefined()};
+            Napi::Value argv[3] = {Env().Undefined(), Env().Undefined(), Env().Undefined()};
+            TableCursor *cursor = NULL;
+            ResultSlices *slices = NULL;
+            bool lazy = false;
 
-            if (errorInfo.code != RFC_OK)
+            jsonParamsRef.Reset();
+
+            if (!jsonFilled)
+            {
+                if (jsonErrorMessage.empty())
+                {
+                    argv[0] = wrapError(Env(), &jsonErrorInfo);
+                }
+                else
+                {
+                    argv[0] = Napi::TypeError::New(Env(), jsonErrorMessage).Value();
+                }
+            }
+            else if (timedOut)
+            {
+                argv[0] = RfcTimeoutError(Env(), options.timeout, client->alive);
+            }
+            else if (errorInfo.code != RFC_OK)
             {
                 if (
                     errorInfo.code == RFC_COMMUNICATION_FAILURE || // Error in Network & Communication layer.
@@ -186,15 +292,131 @@ namespace node_rfc
                     if (!client->alive)
                         errorInfo = openErrorInfo;
                 }
-                argv[0] = wrapError(&errorInfo, client->alive);
+                argv[0] = wrapError(Env(), &errorInfo, client->alive);
+            }
+            else if (!arrowExported)
+            {
+                if (arrowErrorMessage.empty())
+                {
+                    argv[0] = wrapError(Env(), &arrowErrorInfo);
+                }
+                else
+                {
+                    argv[0] = Napi::TypeError::New(Env(), arrowErrorMessage).Value();
+                }
+            }
+            else if (!splitDone)
+            {
+                if (splitErrorMessage.empty())
+                {
+                    argv[0] = wrapError(Env(), &splitErrorInfo);
+                }
+                else
+                {
+                    argv[0] = Napi::TypeError::New(Env(), splitErrorMessage).Value();
+                }
+            }
+            else if (!streamPrepared)
+            {
+                if (streamErrorMessage.empty())
+                {
+                    argv[0] = wrapError(Env(), &streamErrorInfo);
+                }
+                else
+                {
+                    argv[0] = Napi::TypeError::New(Env(), streamErrorMessage).Value();
+                }
+            }
+            else if (jsonSerialized)
+            {
+                argv[1] = Napi::Buffer<char>::Copy(Env(), jsonResult.data(), jsonResult.size());
+            }
+            else if (options.json && !client->jsonConversions())
+            {
+                argv[0] = wrapError(Env(), &jsonErrorInfo, client->alive);
+            }
+            else if (options.json)
+            {
+                Napi::Value result = client->wrapResult(functionDescHandle, functionHandle);
+                Napi::Function stringify = Env().Global().Get("JSON").As<Napi::Object>().Get("stringify").As<Napi::Function>();
+                std::string resultString = stringify.Call({result}).As<Napi::String>().Utf8Value();
+                argv[1] = Napi::Buffer<char>::Copy(Env(), resultString.data(), resultString.size());
             }
             else
             {
-                argv[1] = client->wrapResult(functionDescHandle, functionHandle);
+                // tables with rows converted in slices, unless streamed or decoded on access
+                lazy = options.lazy;
+                if (client->__slice > 0 && options.stream.empty() && !lazy)
+                {
+                    slices = new ResultSlices();
+                }
+                Napi::Object result = lazy ? client->wrapLazy(functionDescHandle, functionHandle, options).As<Napi::Object>()
+                                           : client->wrapResult(functionDescHandle, functionHandle, options.stream.empty() ? NULL : streamDesc.name,
+                                                                slices == NULL ? NULL : &slices->tables)
+                                                 .As<Napi::Object>();
+                for (size_t i = 0; i < arrowStreams.size(); i++)
+                {
+                    // not copied, released with the Buffer
+                    std::string *stream = arrowStreams[i];
+                    arrowStreams[i] = NULL;
+                    result.Set(options.arrow[i], Napi::Buffer<char>::New(
+                                                     Env(), &(*stream)[0], stream->size(),
+                                                     [](Napi::Env env, char *data, std::string *stream) { delete stream; },
+                                                     stream));
+                }
+                if (!options.split.empty())
+                {
+                    result.Set(options.split, client->wrapSplit(split, options.splitColumns, options.splitConvert));
+                }
+                argv[1] = result;
+                if (slices != NULL && slices->tables.empty())
+                {
+                    delete slices;
+                    slices = NULL;
+                }
+                if (!options.stream.empty())
+                {
+                    // function handle released with the cursor
+                    cursor = new TableCursor();
+                    cursor->client = client;
+                    cursor->functionHandle = functionHandle;
+                    cursor->tableHandle = streamTable;
+                    cursor->typeDesc = streamDesc.typeDescHandle;
+                    cursor->rowCount = streamRowCount;
+                    cursor->row = 0;
+                    cursor->format = options.streamFormat;
+                    cursor->pending = false;
+                    argv[2] = Napi::External<TableCursor>::New(
+                        Env(), cursor,
+                        [](Napi::Env env, TableCursor *cursor) {
+                            if (cursor->functionHandle != NULL)
+                            {
+                                RfcDestroyFunction(cursor->functionHandle, NULL);
+                            }
+                            delete cursor;
+                        });
+                }
             }
             client->UnlockMutex();
-            RfcDestroyFunction(functionHandle, NULL);
-            CALLBACK_CALL(Env().Global(), callback, 2, argv)
+            if (slices != NULL)
+            {
+                // function handle released and callback called after the last slice
+                slices->functionHandle = functionHandle;
+                slices->client = Napi::Persistent(client->Value());
+                slices->result = Napi::Persistent(argv[1].As<Napi::Object>());
+                slices->callback = Napi::Persistent(callback.Value());
+                slices->current = 0;
+                slices->errorInfo.code = RFC_OK;
+                callback.Reset();
+                client->sliceResult(slices);
+                return;
+            }
+            if (cursor == NULL && !lazy)
+            {
+                RfcDestroyFunction(functionHandle, NULL);
+            }
+            size_t argc = (cursor == NULL) ? 2 : 3;
+            CALLBACK_CALL(Env().Global(), callback, argc, argv)
             callback.Reset();
         }
 
@@ -204,16 +426,103 @@ namespace node_rfc
         RFC_FUNCTION_HANDLE functionHandle;
         RFC_FUNCTION_DESC_HANDLE functionDescHandle;
         RFC_ERROR_INFO errorInfo;
+
+        // RFC call deadline
+        bool timedOut;
+        Deadline deadline;
+
+        // parameters from JSON Buffer
+        Napi::ObjectReference jsonParamsRef;
+        const char *jsonParamsData;
+        size_t jsonParamsLength;
+        bool jsonFilled;
+        std::string jsonErrorMessage;
+
+        // result as JSON Buffer
+        bool jsonSerialized;
+        std::string jsonResult;
+        RFC_ERROR_INFO jsonErrorInfo;
+
+        // tables as Arrow IPC streams
+        bool exportArrow(void)
+        {
+            RFC_PARAMETER_DESC paramDesc;
+            RFC_TABLE_HANDLE tableHandle;
+            for (size_t i = 0; i < options.arrow.size(); i++)
+            {
+                SAP_UC *paramName = client->fillString(options.arrow[i]);
+                RFC_RC rc = RfcGetParameterDescByName(functionDescHandle, paramName, &paramDesc, &arrowErrorInfo);
+                if (rc == RFC_OK && paramDesc.type != RFCTYPE_TABLE)
+                {
+                    free(paramName);
+                    arrowErrorMessage = "Table parameter expected for Arrow export: " + options.arrow[i];
+                    return false;
+                }
+                if (rc == RFC_OK)
+                {
+                    rc = RfcGetTable(functionHandle, paramName, &tableHandle, &arrowErrorInfo);
+                }
+                free(paramName);
+                if (rc != RFC_OK)
+                {
+                    return false;
+                }
+                arrowStreams.push_back(new std::string());
+                if (!client->arrowTable(tableHandle, paramDesc.typeDescHandle, options.arrowDictionary, *arrowStreams.back(), arrowErrorMessage, &arrowErrorInfo))
+                {
+                    return false;
+                }
+                RfcDeleteAllRows(tableHandle, NULL);
+            }
+            return true;
+        }
+
+        // table streamed after the call
+        bool prepareStream(void)
+        {
+            SAP_UC *paramName = client->fillString(options.stream);
+            RFC_RC rc = RfcGetParameterDescByName(functionDescHandle, paramName, &streamDesc, &streamErrorInfo);
+            if (rc == RFC_OK && streamDesc.type != RFCTYPE_TABLE)
+            {
+                free(paramName);
+                streamErrorMessage = "Table parameter expected for streaming: " + options.stream;
+                return false;
+            }
+            if (rc == RFC_OK)
+            {
+                rc = RfcGetTable(functionHandle, paramName, &streamTable, &streamErrorInfo);
+            }
+            free(paramName);
+            return rc == RFC_OK && RfcGetRowCount(streamTable, &streamRowCount, &streamErrorInfo) == RFC_OK;
+        }
+
+        bool splitDone;
+        SplitTable split;
+        std::string splitErrorMessage;
+        RFC_ERROR_INFO splitErrorInfo;
+
+        bool streamPrepared;
+        RFC_PARAMETER_DESC streamDesc;
+        RFC_TABLE_HANDLE streamTable;
+        unsigned int streamRowCount;
+        std::string streamErrorMessage;
+        RFC_ERROR_INFO streamErrorInfo;
+
+        InvokeOptions options;
+        bool arrowExported;
+        std::vector<std::string *> arrowStreams;
+        std::string arrowErrorMessage;
+        RFC_ERROR_INFO arrowErrorInfo;
     };
 
     class PrepareAsync : public Napi::AsyncWorker
     {
     public:
         PrepareAsync(Napi::Function &callback, Client *client,
-                     Napi::String rfmName, Napi::Array &notRequestedParameters, Napi::Object &rfmParams)
+                     Napi::String rfmName, Napi::Array &notRequestedParameters, Napi::Object &rfmParams, InvokeOptions &options)
             : Napi::AsyncWorker(callback),
               callback(Napi::Persistent(callback)), client(client),
-              notRequested(Napi::Persistent(notRequestedParameters)), rfmParams(Napi::Persistent(rfmParams))
+              notRequested(Napi::Persistent(notRequestedParameters)), rfmParams(Napi::Persistent(rfmParams)), options(options)
         {
             funcName = client->fillString(rfmName);
         }
@@ -233,7 +542,7 @@ namespace node_rfc
             Napi::Value argv[2] = {Env().Undefined(), Env().Undefined()};
 
             if (functionDescHandle == NULL || errorInfo.code != RFC_OK)
-                argv[0] = wrapError(&errorInfo);
+                argv[0] = wrapError(Env(), &errorInfo);
 
             if (argv[0].IsUndefined())
             {
@@ -241,7 +550,7 @@ namespace node_rfc
 
                 if (errorInfo.code != RFC_OK)
                 {
-                    argv[0] = wrapError(&errorInfo);
+                    argv[0] = wrapError(Env(), &errorInfo);
                 }
                 else
                 {
@@ -253,7 +562,7 @@ namespace node_rfc
                         free(const_cast<SAP_UC *>(paramName));
                         if (rc != RFC_OK)
                         {
-                            argv[0] = wrapError(&errorInfo);
+                            argv[0] = wrapError(Env(), &errorInfo);
                             break;
                         }
                     }
@@ -262,7 +571,7 @@ namespace node_rfc
 
             notRequested.Reset();
 
-            if (argv[0].IsUndefined())
+            if (argv[0].IsUndefined() && !rfmParams.Value().IsBuffer())
             {
                 Napi::Object params = rfmParams.Value();
                 Napi::Array paramNames = params.GetPropertyNames();
@@ -281,12 +590,13 @@ namespace node_rfc
                 }
             }
 
+            Napi::Value jsonParams = rfmParams.Value();
             rfmParams.Reset();
 
             if (argv[0].IsUndefined())
             {
                 Napi::Function callbackFunction = callback.Value();
-                (new InvokeAsync(callbackFunction, client, functionHandle, functionDescHandle))->Queue();
+                (new InvokeAsync(callbackFunction, client, functionHandle, functionDescHandle, jsonParams, options))->Queue();
             }
             else
             {
@@ -302,18 +612,17 @@ namespace node_rfc
 
         Napi::Reference<Napi::Array> notRequested;
         Napi::Reference<Napi::Object> rfmParams;
+        InvokeOptions options;
 
         RFC_FUNCTION_DESC_HANDLE functionDescHandle;
         RFC_ERROR_INFO errorInfo;
     };
 
-    Napi::FunctionReference Client::constructor;
-
     Client::Client(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Client>(info)
     {
         char err[256];
 
-        init(info.Env());
+        init();
 
         if (!info.IsConstructCall())
         {
@@ -365,7 +674,7 @@ namespace node_rfc
                         else
                         {
                             sprintf(err, "Unknown bcd option, only 'number' or function allowed: %s", &bcdString[0]);
-                            Napi::TypeError::New(node_rfc::__env, err).ThrowAsJavaScriptException();
+                            Napi::TypeError::New(Env(), err).ThrowAsJavaScriptException();
                         }
                     }
                 }
@@ -394,7 +703,7 @@ namespace node_rfc
                     if (opt.IsNull())
                     {
                         sprintf(err, "Date option is not an object with toABAP and fromABAP functions");
-                        Napi::TypeError::New(node_rfc::__env, err).ThrowAsJavaScriptException();
+                        Napi::TypeError::New(Env(), err).ThrowAsJavaScriptException();
                     }
                 }
                 else if (key.Utf8Value().compare(std::string("time")) == (int)0)
@@ -422,7 +731,53 @@ namespace node_rfc
                     if (opt.IsNull())
                     {
                         sprintf(err, "Date option is not an object with toABAP and fromABAP functions");
-                        Napi::TypeError::New(node_rfc::__env, err).ThrowAsJavaScriptException();
+                        Napi::TypeError::New(Env(), err).ThrowAsJavaScriptException();
+                    }
+                }
+                else if (key.Utf8Value().compare(std::string("intern")) == (int)0)
+                {
+                    if (!opt.IsBoolean())
+                    {
+                        Napi::TypeError::New(Env(), "Intern option must be a boolean").ThrowAsJavaScriptException();
+                    }
+                    else
+                    {
+                        __intern = opt.As<Napi::Boolean>().Value();
+                    }
+                }
+                else if (key.Utf8Value().compare(std::string("bytes")) == (int)0)
+                {
+                    std::string bytes = opt.ToString().Utf8Value();
+                    if (bytes.compare(std::string("buffer")) == (int)0)
+                    {
+                        __bytes = NODERFC_BYTES_BUFFER;
+                    }
+                    else if (bytes.compare(std::string("view")) == (int)0)
+                    {
+                        __bytes = NODERFC_BYTES_VIEW;
+                    }
+                    else if (bytes.compare(std::string("hex")) == (int)0)
+                    {
+                        __bytes = NODERFC_BYTES_HEX;
+                    }
+                    else if (bytes.compare(std::string("base64")) == (int)0)
+                    {
+                        __bytes = NODERFC_BYTES_BASE64;
+                    }
+                    else
+                    {
+                        Napi::TypeError::New(Env(), "Bytes option must be buffer, view, hex or base64").ThrowAsJavaScriptException();
+                    }
+                }
+                else if (key.Utf8Value().compare(std::string("slice")) == (int)0)
+                {
+                    if (!opt.IsNumber() || opt.As<Napi::Number>().DoubleValue() < 0)
+                    {
+                        Napi::TypeError::New(Env(), "Slice option must be a number of milliseconds").ThrowAsJavaScriptException();
+                    }
+                    else
+                    {
+                        __slice = opt.As<Napi::Number>().Uint32Value();
                     }
                 }
                 else if (key.Utf8Value().compare(std::string("filter")) == (int)0)
@@ -431,14 +786,14 @@ namespace node_rfc
                     if (((int)__filter_param_direction < 1) || ((int)__filter_param_direction) > 4)
                     {
                         sprintf(err, "Invalid key for the filter parameter direction (see RFC_DIRECTION): %u", (int)__filter_param_direction);
-                        Napi::TypeError::New(node_rfc::__env, err).ThrowAsJavaScriptException();
+                        Napi::TypeError::New(Env(), err).ThrowAsJavaScriptException();
                     }
                 }
                 else
                 {
                     std::string optionName = key.Utf8Value();
                     sprintf(err, "Unknown option: %s", &optionName[0]);
-                    Napi::TypeError::New(node_rfc::__env, err).ThrowAsJavaScriptException();
+                    Napi::TypeError::New(Env(), err).ThrowAsJavaScriptException();
                 }
             }
         }
@@ -457,7 +812,7 @@ namespace node_rfc
             this->connectionParams[i].value = fillString(value);
         }
 
-        this->__refId = ++Client::__refCounter;
+        this->__refId = ++addonData(info.Env())->clientRefCounter;
 
         uv_sem_init(&this->invocationMutex, 1);
     }
@@ -507,14 +862,19 @@ namespace node_rfc
                                                      InstanceMethod("connectionInfo", &Client::ConnectionInfo),
                                                      InstanceMethod("connect", &Client::Connect),
                                                      InstanceMethod("invoke", &Client::Invoke),
+                                                     InstanceMethod("call", &Client::Call),
                                                      InstanceMethod("ping", &Client::Ping),
                                                      InstanceMethod("close", &Client::Close),
                                                      InstanceMethod("reopen", &Client::Reopen),
                                                      InstanceMethod("isAlive", &Client::IsAlive),
+                                                     InstanceMethod("exportMetadata", &Client::ExportMetadata),
+                                                     InstanceMethod("importMetadata", &Client::ImportMetadata),
+                                                     InstanceMethod("streamRead", &Client::StreamRead),
+                                                     InstanceMethod("streamClose", &Client::StreamClose),
+                                                     InstanceMethod("releaseResult", &Client::ReleaseResult),
                                                  });
 
-        constructor = Napi::Persistent(t);
-        constructor.SuppressDestruct();
+        addonData(env)->clientConstructor = Napi::Persistent(t);
 
         exports.Set("Client", t);
         return exports;
@@ -540,14 +900,28 @@ namespace node_rfc
 
     Napi::Value Client::Invoke(const Napi::CallbackInfo &info)
     {
-        Napi::Array notRequested = Napi::Array::New(info.Env());
-        Napi::Value bcd;
-
-        Napi::Function callback = info[2].As<Napi::Function>();
+        return queueInvoke(info[0], info[1], info[2].As<Napi::Function>(), info[3]);
+    }
 
-        if (info[3].IsObject())
+    Napi::Value Client::queueInvoke(Napi::Value name, Napi::Value params, Napi::Function callback, Napi::Value callOptions)
+    {
+        Napi::Array notRequested = Napi::Array::New(Env());
+        Napi::Value bcd;
+        InvokeOptions invokeOptions;
+        invokeOptions.json = false;
+        invokeOptions.arrowDictionary = false;
+        invokeOptions.streamFormat = NODERFC_STREAM_NDJSON;
+        invokeOptions.splitFields = "FIELDS";
+        invokeOptions.splitColumns = false;
+        invokeOptions.splitConvert = false;
+        invokeOptions.lazy = false;
+        invokeOptions.timeout = 0;
+        invokeOptions.deadline = 0;
+        bool timeoutSet = false;
+
+        if (callOptions.IsObject())
         {
-            Napi::Object options = info[3].ToObject();
+            Napi::Object options = callOptions.ToObject();
             Napi::Array props = options.GetPropertyNames();
             for (unsigned int i = 0; i < props.Length(); i++)
             {
@@ -556,22 +930,247 @@ namespace node_rfc
                 {
                     notRequested = options.Get(key).As<Napi::Array>();
                 }
+                else if (key.Utf8Value().compare(std::string("json")) == (int)0)
+                {
+                    invokeOptions.json = options.Get(key).ToBoolean();
+                }
+                else if (key.Utf8Value().compare(std::string("arrow")) == (int)0)
+                {
+                    Napi::Value arrow = options.Get(key);
+                    if (!arrow.IsArray())
+                    {
+                        Napi::TypeError::New(Env(), "Array of table parameter names expected for option arrow").ThrowAsJavaScriptException();
+                        return Env().Undefined();
+                    }
+                    for (unsigned int j = 0; j < arrow.As<Napi::Array>().Length(); j++)
+                    {
+                        invokeOptions.arrow.push_back(arrow.As<Napi::Array>().Get(j).ToString().Utf8Value());
+                    }
+                }
+                else if (key.Utf8Value().compare(std::string("arrowDictionary")) == (int)0)
+                {
+                    invokeOptions.arrowDictionary = options.Get(key).ToBoolean();
+                }
+                else if (key.Utf8Value().compare(std::string("stream")) == (int)0)
+                {
+                    invokeOptions.stream = options.Get(key).ToString().Utf8Value();
+                }
+                else if (key.Utf8Value().compare(std::string("split")) == (int)0)
+                {
+                    // true: RFC_READ_TABLE DATA
+                    Napi::Value split = options.Get(key);
+                    if (split.IsBoolean())
+                    {
+                        invokeOptions.split = split.ToBoolean() ? "DATA" : "";
+                    }
+                    else
+                    {
+                        invokeOptions.split = split.ToString().Utf8Value();
+                    }
+                }
+                else if (key.Utf8Value().compare(std::string("splitFields")) == (int)0)
+                {
+                    // layout table name, or FIELDNAME, OFFSET, LENGTH, TYPE objects
+                    Napi::Value fields = options.Get(key);
+                    if (!fields.IsArray())
+                    {
+                        invokeOptions.splitFields = fields.ToString().Utf8Value();
+                        continue;
+                    }
+                    for (unsigned int j = 0; j < fields.As<Napi::Array>().Length(); j++)
+                    {
+                        Napi::Value field = fields.As<Napi::Array>().Get(j);
+                        if (!field.IsObject() || !field.ToObject().Has("FIELDNAME") || !field.ToObject().Has("OFFSET") || !field.ToObject().Has("LENGTH"))
+                        {
+                            Napi::TypeError::New(Env(), "Array of {FIELDNAME, OFFSET, LENGTH} objects expected for option splitFields").ThrowAsJavaScriptException();
+                            return Env().Undefined();
+                        }
+                        Napi::Object fieldObj = field.ToObject();
+                        SplitField splitField;
+                        splitField.name = fieldObj.Get("FIELDNAME").ToString().Utf8Value();
+                        double offset = fieldObj.Get("OFFSET").ToNumber().DoubleValue();
+                        double length = fieldObj.Get("LENGTH").ToNumber().DoubleValue();
+                        splitField.offset = offset > 0 ? (unsigned int)offset : 0;
+                        splitField.length = length > 0 ? (unsigned int)length : 0;
+                        std::string type = fieldObj.Has("TYPE") ? fieldObj.Get("TYPE").ToString().Utf8Value() : "";
+                        splitField.type = type.empty() ? ' ' : type[0];
+                        invokeOptions.splitLayout.push_back(splitField);
+                    }
+                }
+                else if (key.Utf8Value().compare(std::string("splitColumns")) == (int)0)
+                {
+                    invokeOptions.splitColumns = options.Get(key).ToBoolean();
+                }
+                else if (key.Utf8Value().compare(std::string("splitConvert")) == (int)0)
+                {
+                    invokeOptions.splitConvert = options.Get(key).ToBoolean();
+                }
+                else if (key.Utf8Value().compare(std::string("lazy")) == (int)0)
+                {
+                    invokeOptions.lazy = options.Get(key).ToBoolean();
+                }
+                else if (key.Utf8Value().compare(std::string("timeout")) == (int)0 ||
+                         key.Utf8Value().compare(std::string("deadline")) == (int)0)
+                {
+                    // timeout in milliseconds, deadline as Date or epoch milliseconds
+                    Napi::Value value = options.Get(key);
+                    if (value.IsUndefined())
+                    {
+                        continue;
+                    }
+                    if (!value.IsNumber() && !value.IsDate())
+                    {
+                        Napi::TypeError::New(Env(), "Number of milliseconds or Date expected for option " + key.Utf8Value()).ThrowAsJavaScriptException();
+                        return Env().Undefined();
+                    }
+                    double ms = value.ToNumber().DoubleValue();
+                    if (key.Utf8Value().compare(std::string("deadline")) == (int)0)
+                    {
+                        ms -= (double)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+                    }
+                    ms = ms < 0 ? 0 : ms;
+                    if (!timeoutSet || ms < invokeOptions.timeout)
+                    {
+                        invokeOptions.timeout = (unsigned int)ms;
+                        timeoutSet = true;
+                    }
+                }
+                else if (key.Utf8Value().compare(std::string("streamFormat")) == (int)0)
+                {
+                    std::string format = options.Get(key).ToString().Utf8Value();
+                    if (format.compare(std::string("ndjson")) == (int)0)
+                    {
+                        invokeOptions.streamFormat = NODERFC_STREAM_NDJSON;
+                    }
+                    else if (format.compare(std::string("csv")) == (int)0)
+                    {
+                        invokeOptions.streamFormat = NODERFC_STREAM_CSV;
+                    }
+                    else
+                    {
+                        Napi::TypeError::New(Env(), "Stream format ndjson or csv expected").ThrowAsJavaScriptException();
+                        return Env().Undefined();
+                    }
+                }
                 else
                 {
-                    char err[256];
-                    std::string optionName = key.Utf8Value();
-                    sprintf(err, "Unknown option: %s", &optionName[0]);
-                    Napi::TypeError::New(node_rfc::__env, err).ThrowAsJavaScriptException();
+                    Napi::TypeError::New(Env(), "Unknown option: " + key.Utf8Value()).ThrowAsJavaScriptException();
+                    return Env().Undefined();
                 }
             }
         }
 
-        Napi::String rfmName = info[0].As<Napi::String>();
-        Napi::Object rfmParams = info[1].As<Napi::Object>();
+        if (invokeOptions.json && !invokeOptions.arrow.empty())
+        {
+            Napi::TypeError::New(Env(), "Options json and arrow cannot be combined").ThrowAsJavaScriptException();
+            return Env().Undefined();
+        }
+
+        if (invokeOptions.json && !invokeOptions.stream.empty())
+        {
+            Napi::TypeError::New(Env(), "Options json and stream cannot be combined").ThrowAsJavaScriptException();
+            return Env().Undefined();
+        }
+
+        // streamed rows encoded natively, the client JS conversions would be skipped
+        if (!invokeOptions.stream.empty() && jsonConversions())
+        {
+            Napi::TypeError::New(Env(), "Option stream cannot be combined with client options bcd function, date, time or bytes hex/base64").ThrowAsJavaScriptException();
+            return Env().Undefined();
+        }
 
-        (new PrepareAsync(callback, this, rfmName, notRequested, rfmParams))->Queue();
+        if (invokeOptions.lazy && (invokeOptions.json || !invokeOptions.stream.empty()))
+        {
+            Napi::TypeError::New(Env(), "Option lazy cannot be combined with json or stream").ThrowAsJavaScriptException();
+            return Env().Undefined();
+        }
 
-        return info.Env().Undefined();
+        if (invokeOptions.json && !invokeOptions.split.empty())
+        {
+            Napi::TypeError::New(Env(), "Options json and split cannot be combined").ThrowAsJavaScriptException();
+            return Env().Undefined();
+        }
+
+        Napi::String rfmName = name.As<Napi::String>();
+        Napi::Object rfmParams = params.As<Napi::Object>();
+
+        // JSON parameters filled on the worker thread, unless JS conversion functions to be called
+        if (rfmParams.IsBuffer() && (!__dateToABAP.IsEmpty() || !__timeToABAP.IsEmpty()))
+        {
+            Napi::Buffer<char> buffer = rfmParams.As<Napi::Buffer<char>>();
+            Napi::Function parse = Env().Global().Get("JSON").As<Napi::Object>().Get("parse").As<Napi::Function>();
+            rfmParams = parse.Call({Napi::String::New(Env(), buffer.Data(), buffer.Length())}).As<Napi::Object>();
+        }
+
+        // deadline from here, after all option checks
+        if (timeoutSet)
+        {
+            invokeOptions.deadline = uv_hrtime() + (uint64_t)invokeOptions.timeout * 1000000;
+        }
+
+        (new PrepareAsync(callback, this, rfmName, notRequested, rfmParams, invokeOptions))->Queue();
+
+        return Env().Undefined();
+    }
+
+    Napi::Value Client::Call(const Napi::CallbackInfo &info)
+    {
+        char err[256];
+        Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(info.Env());
+
+        if (info.Length() < 2 || info[1].IsUndefined())
+        {
+            deferred.Reject(Napi::TypeError::New(info.Env(), "Please provide remote function module name and parameters as arguments").Value());
+            return deferred.Promise();
+        }
+        if (!info[0].IsString())
+        {
+            deferred.Reject(Napi::TypeError::New(info.Env(), "First argument (remote function module name) must be an string").Value());
+            return deferred.Promise();
+        }
+        if (!info[1].IsObject())
+        {
+            deferred.Reject(Napi::TypeError::New(info.Env(), "Second argument (remote function module parameters) must be an object").Value());
+            return deferred.Promise();
+        }
+        if (info.Length() > 2 && !info[2].IsUndefined() && !info[2].IsObject())
+        {
+            deferred.Reject(Napi::TypeError::New(info.Env(), "Call options argument must be an object").Value());
+            return deferred.Promise();
+        }
+        if (info.Length() > 2 && info[2].IsObject() && !info[2].As<Napi::Object>().Get("stream").IsUndefined())
+        {
+            // streamed table read with the cursor, passed to the invoke callback only
+            deferred.Reject(Napi::TypeError::New(info.Env(), "Option stream not supported by call(), use streamTable()").Value());
+            return deferred.Promise();
+        }
+        if (!alive)
+        {
+            sprintf(err, "Client invoked RFC call with closed connection: id=%u", __refId);
+            deferred.Reject(Napi::Error::New(info.Env(), err).Value());
+            return deferred.Promise();
+        }
+
+        // settled by the invoke callback, (err, result[, cursor])
+        Napi::Function settle = Napi::Function::New(info.Env(), [deferred](const Napi::CallbackInfo &info) {
+            if (info[0].IsUndefined())
+            {
+                deferred.Resolve(info[1]);
+            }
+            else
+            {
+                deferred.Reject(info[0]);
+            }
+        });
+
+        // option errors rejected, not thrown, the call not queued
+        queueInvoke(info[0], info[1], settle, info.Length() > 2 ? info[2] : info.Env().Undefined());
+        if (info.Env().IsExceptionPending())
+        {
+            deferred.Reject(info.Env().GetAndClearPendingException().Value());
+        }
+
+        return deferred.Promise();
     }
 
     void Client::LockMutex(void)
@@ -654,34 +1253,34 @@ namespace node_rfc
 
         if (rc != RFC_OK || errorInfo.code != RFC_OK)
         {
-            return wrapError(&errorInfo);
-        }
-
-        infoObj.Set(Napi::String::New(env, "dest"), wrapString(connInfo.dest, 64));
-        infoObj.Set(Napi::String::New(env, "host"), wrapString(connInfo.host, 100));
-        infoObj.Set(Napi::String::New(env, "partnerHost"), wrapString(connInfo.partnerHost, 100));
-        infoObj.Set(Napi::String::New(env, "sysNumber"), wrapString(connInfo.sysNumber, 2));
-        infoObj.Set(Napi::String::New(env, "sysId"), wrapString(connInfo.sysId, 8));
-        infoObj.Set(Napi::String::New(env, "client"), wrapString(connInfo.client, 3));
-        infoObj.Set(Napi::String::New(env, "user"), wrapString(connInfo.user, 12));
-        infoObj.Set(Napi::String::New(env, "language"), wrapString(connInfo.language, 2));
-        infoObj.Set(Napi::String::New(env, "trace"), wrapString(connInfo.trace, 1));
-        infoObj.Set(Napi::String::New(env, "isoLanguage"), wrapString(connInfo.isoLanguage, 2));
-        infoObj.Set(Napi::String::New(env, "codepage"), wrapString(connInfo.codepage, 4));
-        infoObj.Set(Napi::String::New(env, "partnerCodepage"), wrapString(connInfo.partnerCodepage, 4));
-        infoObj.Set(Napi::String::New(env, "rfcRole"), wrapString(connInfo.rfcRole, 1));
-        infoObj.Set(Napi::String::New(env, "type"), wrapString(connInfo.type, 1));
-        infoObj.Set(Napi::String::New(env, "partnerType"), wrapString(connInfo.partnerType, 1));
-        infoObj.Set(Napi::String::New(env, "rel"), wrapString(connInfo.rel, 4));
-        infoObj.Set(Napi::String::New(env, "partnerRel"), wrapString(connInfo.partnerRel, 4));
-        infoObj.Set(Napi::String::New(env, "kernelRel"), wrapString(connInfo.kernelRel, 4));
-        infoObj.Set(Napi::String::New(env, "cpicConvId"), wrapString(connInfo.cpicConvId, 8));
-        infoObj.Set(Napi::String::New(env, "progName"), wrapString(connInfo.progName, 128));
-        infoObj.Set(Napi::String::New(env, "partnerBytesPerChar"), wrapString(connInfo.partnerBytesPerChar, 1));
-        infoObj.Set(Napi::String::New(env, "partnerSystemCodepage"), wrapString(connInfo.partnerSystemCodepage, 4));
-        infoObj.Set(Napi::String::New(env, "partnerIP"), wrapString(connInfo.partnerIP, 15));
-        infoObj.Set(Napi::String::New(env, "partnerIPv6"), wrapString(connInfo.partnerIPv6, 45));
-        // infoObj.Set(Napi::String::New(env, "reserved"), wrapString(connInfo.reserved, 17));
+            return wrapError(Env(), &errorInfo);
+        }
+
+        infoObj.Set(Napi::String::New(env, "dest"), wrapString(Env(), connInfo.dest, 64));
+        infoObj.Set(Napi::String::New(env, "host"), wrapString(Env(), connInfo.host, 100));
+        infoObj.Set(Napi::String::New(env, "partnerHost"), wrapString(Env(), connInfo.partnerHost, 100));
+        infoObj.Set(Napi::String::New(env, "sysNumber"), wrapString(Env(), connInfo.sysNumber, 2));
+        infoObj.Set(Napi::String::New(env, "sysId"), wrapString(Env(), connInfo.sysId, 8));
+        infoObj.Set(Napi::String::New(env, "client"), wrapString(Env(), connInfo.client, 3));
+        infoObj.Set(Napi::String::New(env, "user"), wrapString(Env(), connInfo.user, 12));
+        infoObj.Set(Napi::String::New(env, "language"), wrapString(Env(), connInfo.language, 2));
+        infoObj.Set(Napi::String::New(env, "trace"), wrapString(Env(), connInfo.trace, 1));
+        infoObj.Set(Napi::String::New(env, "isoLanguage"), wrapString(Env(), connInfo.isoLanguage, 2));
+        infoObj.Set(Napi::String::New(env, "codepage"), wrapString(Env(), connInfo.codepage, 4));
+        infoObj.Set(Napi::String::New(env, "partnerCodepage"), wrapString(Env(), connInfo.partnerCodepage, 4));
+        infoObj.Set(Napi::String::New(env, "rfcRole"), wrapString(Env(), connInfo.rfcRole, 1));
+        infoObj.Set(Napi::String::New(env, "type"), wrapString(Env(), connInfo.type, 1));
+        infoObj.Set(Napi::String::New(env, "partnerType"), wrapString(Env(), connInfo.partnerType, 1));
+        infoObj.Set(Napi::String::New(env, "rel"), wrapString(Env(), connInfo.rel, 4));
+        infoObj.Set(Napi::String::New(env, "partnerRel"), wrapString(Env(), connInfo.partnerRel, 4));
+        infoObj.Set(Napi::String::New(env, "kernelRel"), wrapString(Env(), connInfo.kernelRel, 4));
+        infoObj.Set(Napi::String::New(env, "cpicConvId"), wrapString(Env(), connInfo.cpicConvId, 8));
+        infoObj.Set(Napi::String::New(env, "progName"), wrapString(Env(), connInfo.progName, 128));
+        infoObj.Set(Napi::String::New(env, "partnerBytesPerChar"), wrapString(Env(), connInfo.partnerBytesPerChar, 1));
+        infoObj.Set(Napi::String::New(env, "partnerSystemCodepage"), wrapString(Env(), connInfo.partnerSystemCodepage, 4));
+        infoObj.Set(Napi::String::New(env, "partnerIP"), wrapString(Env(), connInfo.partnerIP, 15));
+        infoObj.Set(Napi::String::New(env, "partnerIPv6"), wrapString(Env(), connInfo.partnerIPv6, 45));
+        // infoObj.Set(Napi::String::New(env, "reserved"), wrapString(Env(), connInfo.reserved, 17));
 
         return infoObj;
     }
@@ -709,55 +1308,59 @@ namespace node_rfc
 
         RfcGetVersion(&major, &minor, &patchLevel);
 
-        Napi::Object version = Napi::Object::New(node_rfc::__env);
-        version.Set(Napi::String::New(node_rfc::__env, "major"), major);
-        version.Set(Napi::String::New(node_rfc::__env, "minor"), minor);
-        version.Set(Napi::String::New(node_rfc::__env, "patchLevel"), patchLevel);
-        version.Set(Napi::String::New(node_rfc::__env, "binding"), Napi::String::New(node_rfc::__env, SAPNWRFC_BINDING_VERSION));
+        Napi::Object version = Napi::Object::New(Env());
+        version.Set(Napi::String::New(Env(), "major"), major);
+        version.Set(Napi::String::New(Env(), "minor"), minor);
+        version.Set(Napi::String::New(Env(), "patchLevel"), patchLevel);
+        version.Set(Napi::String::New(Env(), "binding"), Napi::String::New(Env(), SAPNWRFC_BINDING_VERSION));
         return version;
     }
 
     Napi::Value Client::OptionsGetter(const Napi::CallbackInfo &info)
     {
-        Napi::Object options = Napi::Object::New(node_rfc::__env);
+        Napi::Object options = Napi::Object::New(Env());
         if (__bcd == NODERFC_BCD_STRING)
         {
-            options.Set(Napi::String::New(node_rfc::__env, "bcd"), Napi::String::New(node_rfc::__env, "string"));
+            options.Set(Napi::String::New(Env(), "bcd"), Napi::String::New(Env(), "string"));
         }
         else if (__bcd == NODERFC_BCD_NUMBER)
         {
-            options.Set(Napi::String::New(node_rfc::__env, "bcd"), Napi::String::New(node_rfc::__env, "number"));
+            options.Set(Napi::String::New(Env(), "bcd"), Napi::String::New(Env(), "number"));
         }
         else if (__bcd == NODERFC_BCD_FUNCTION)
         {
-            options.Set(Napi::String::New(node_rfc::__env, "bcd"), __bcdFunction.Value());
+            options.Set(Napi::String::New(Env(), "bcd"), __bcdFunction.Value());
         }
         else
         {
-            options.Set(Napi::String::New(node_rfc::__env, "bcd"), Napi::String::New(node_rfc::__env, "?"));
+            options.Set(Napi::String::New(Env(), "bcd"), Napi::String::New(Env(), "?"));
         }
 
-        Napi::Object date = Napi::Object::New(node_rfc::__env);
+        Napi::Object date = Napi::Object::New(Env());
         if (!__dateToABAP.IsEmpty())
         {
-            date.Set(Napi::String::New(node_rfc::__env, "toABAP"), __dateToABAP.Value());
+            date.Set(Napi::String::New(Env(), "toABAP"), __dateToABAP.Value());
         }
         if (!__dateFromABAP.IsEmpty())
         {
-            date.Set(Napi::String::New(node_rfc::__env, "fromABAP"), __dateFromABAP.Value());
+            date.Set(Napi::String::New(Env(), "fromABAP"), __dateFromABAP.Value());
         }
-        options.Set(Napi::String::New(node_rfc::__env, "date"), date);
+        options.Set(Napi::String::New(Env(), "date"), date);
 
-        Napi::Object time = Napi::Object::New(node_rfc::__env);
+        Napi::Object time = Napi::Object::New(Env());
         if (!__timeToABAP.IsEmpty())
         {
-            time.Set(Napi::String::New(node_rfc::__env, "toABAP"), __timeToABAP.Value());
+            time.Set(Napi::String::New(Env(), "toABAP"), __timeToABAP.Value());
         }
         if (!__timeFromABAP.IsEmpty())
         {
-            time.Set(Napi::String::New(node_rfc::__env, "fromABAP"), __timeFromABAP.Value());
+            time.Set(Napi::String::New(Env(), "fromABAP"), __timeFromABAP.Value());
         }
-        options.Set(Napi::String::New(node_rfc::__env, "time"), time);
+        options.Set(Napi::String::New(Env(), "time"), time);
+        options.Set(Napi::String::New(Env(), "intern"), Napi::Boolean::New(Env(), __intern));
+        options.Set(Napi::String::New(Env(), "slice"), Napi::Number::New(Env(), __slice));
+        const char *bytes[] = {"buffer", "view", "hex", "base64"};
+        options.Set(Napi::String::New(Env(), "bytes"), Napi::String::New(Env(), bytes[__bytes]));
 
         return options;
     }
@@ -21,9 +21,45 @@
 #define NODERFC_BCD_NUMBER 1
 #define NODERFC_BCD_FUNCTION 2
 
+#define NODERFC_METADATA_VERSION 1
+
+#define NODERFC_TEXT_STRING 0
+#define NODERFC_TEXT_NUMBER 1
+#define NODERFC_TEXT_BYTES 2
+
+#define NODERFC_STREAM_NDJSON 0
+#define NODERFC_STREAM_CSV 1
+#define NODERFC_STREAM_CHUNK 65536
+
+// interned CHAR columns: field length, distinct values, rows before the cardinality check
+#define NODERFC_INTERN_LENGTH 32
+#define NODERFC_INTERN_DISTINCT 4096
+#define NODERFC_INTERN_SAMPLE 1024
+
+// BYTE values, client option bytes
+#define NODERFC_BYTES_BUFFER 0
+#define NODERFC_BYTES_VIEW 1
+#define NODERFC_BYTES_HEX 2
+#define NODERFC_BYTES_BASE64 3
+// longest table BYTE field viewed into the slab
+#define NODERFC_SLAB_FIELD 256
+
+// result tables converted in slices, rows between time budget checks
+#define NODERFC_SLICE_ROWS 64
+
+// columnar table input
+#define NODERFC_COLUMN_ARRAY 0
+#define NODERFC_COLUMN_FLOAT64 1
+#define NODERFC_COLUMN_INT32 2
+#define NODERFC_COLUMN_TEXT 3
+
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <uv.h>
 #include <napi.h>
 #include <sapnwrfc.h>
+#include "addon.h"
 
 using namespace Napi;
 
@@ -31,7 +67,136 @@ using namespace Napi;
 
 namespace node_rfc
 {
-    extern Napi::Env __env;
+    // fixed-width line field, RFC_READ_TABLE FIELDS row
+    typedef struct _SplitField
+    {
+        std::string name;
+        unsigned int offset; // characters
+        unsigned int length;
+        char type;           // ABAP type, for splitConvert
+    } SplitField;
+
+    // invoke() options, used after the RFC call
+    typedef struct _InvokeOptions
+    {
+        bool json;                      // result as JSON Buffer
+        std::vector<std::string> arrow; // tables as Arrow IPC stream Buffers
+        bool arrowDictionary;           // dictionary encoded CHAR and STRING columns
+        std::string stream;             // table streamed in chunks, after the call
+        int streamFormat;               // NODERFC_STREAM_NDJSON or NODERFC_STREAM_CSV
+        std::string split;              // fixed-width lines table split into fields
+        std::string splitFields;        // layout table, if splitLayout empty
+        std::vector<SplitField> splitLayout; // fields given as option
+        bool splitColumns;              // arrays per field instead of row objects
+        bool splitConvert;              // numbers, dates and times by ABAP type
+        bool lazy;                      // parameters decoded on first access
+        unsigned int timeout;           // milliseconds, reported in timeout error
+        uint64_t deadline;              // uv_hrtime() nanoseconds, 0: none
+    } InvokeOptions;
+
+    // repeated values of a CHAR column, trimmed SAP_UC bytes to strings index
+    typedef struct _InternColumn
+    {
+        std::unordered_map<std::string, uint32_t> index;
+        unsigned int seen;
+        bool disabled; // long field or high cardinality
+    } InternColumn;
+
+    // strings shared by the rows of one table
+    typedef struct _InternTable
+    {
+        Napi::Array strings;
+        uint32_t count;
+        std::vector<InternColumn> columns;
+    } InternTable;
+
+    // table row type resolved once, rows defined with all properties at once,
+    // in field order, to share one hidden class
+    typedef struct _RowTemplate
+    {
+        std::vector<RFC_FIELD_DESC> fields;
+        std::vector<napi_property_descriptor> properties; // names, values of the current row
+        bool unnamed;                                     // elementary line type, value only
+        InternTable *intern;                              // NULL: not interned
+        bool flat;                                        // character-like fields, one char buffer per row
+        std::vector<SAP_UC> charBuffer;
+        Napi::ArrayBuffer slab; // short BYTE values of all rows, empty: not viewed
+        size_t slabOffset;
+    } RowTemplate;
+
+    // CHAR fields only table input, rows set from one char buffer
+    typedef struct _FlatRow
+    {
+        std::vector<RFC_FIELD_DESC> fields;
+        std::unordered_map<std::string, unsigned int> index; // UTF-8 field name
+        std::vector<SAP_UC> blank;
+        std::vector<SAP_UC> charBuffer;
+    } FlatRow;
+
+    // table input column, field resolved once for all rows
+    typedef struct _TableColumn
+    {
+        RFC_FIELD_DESC fieldDesc;
+        int kind;            // NODERFC_COLUMN_*
+        Napi::Array array;   // values, any type
+        const double *f64;   // Float64Array values
+        const int32_t *i32;  // Int32Array values
+        const char *text;    // newline delimited UTF-8 values
+        size_t textSize;
+        size_t textOffset;   // next value
+    } TableColumn;
+
+    // split lines, trimmed UTF-8 cells row by row
+    typedef struct _SplitTable
+    {
+        std::vector<SplitField> fields;
+        unsigned int rowCount;
+        std::string text;
+        std::vector<size_t> ends; // cell end offsets in text
+    } SplitTable;
+
+    class Client;
+
+    // result tables converted between event loop turns, function handle owned until done
+    typedef struct _ResultSlices
+    {
+        RFC_FUNCTION_HANDLE functionHandle;
+        Napi::ObjectReference client; // kept alive between slices
+        Napi::ObjectReference result;
+        Napi::FunctionReference callback;
+        std::vector<RFC_PARAMETER_DESC> tables;
+        size_t current;                 // table converted
+        RFC_TABLE_HANDLE tableHandle;
+        unsigned int row;               // rows left, converted last to first
+        Napi::ObjectReference table;    // empty: current table not started
+        Napi::ObjectReference strings;  // interned strings of the current table
+        Napi::ObjectReference slab;     // BYTE values of the current table
+        InternTable intern;
+        RowTemplate rowType;
+        RFC_ERROR_INFO errorInfo;
+    } ResultSlices;
+
+    // lazy result parameters, function handle owned until all decoded or released
+    typedef struct _LazyResult
+    {
+        RFC_FUNCTION_HANDLE functionHandle;
+        Napi::ObjectReference client; // conversion options of the client used
+        std::vector<RFC_PARAMETER_DESC> parameters;
+        unsigned int pending; // parameters not decoded yet
+    } LazyResult;
+
+    // table rows read in chunks, function handle owned until released
+    typedef struct _TableCursor
+    {
+        Client *client;
+        RFC_FUNCTION_HANDLE functionHandle;
+        RFC_TABLE_HANDLE tableHandle;
+        RFC_TYPE_DESC_HANDLE typeDesc;
+        unsigned int rowCount;
+        unsigned int row;
+        int format;
+        bool pending;
+    } TableCursor;
 
     class Client : public Napi::ObjectWrap<Client>
     {
@@ -42,18 +207,29 @@ namespace node_rfc
         friend class PingAsync;
         friend class PrepareAsync;
         friend class InvokeAsync;
+        friend class Server;
+        friend class AddFunctionAsync;
+        friend class Transaction;
+        friend class TransactionCreateAsync;
+        friend class TransactionAddAsync;
+        friend class TransactionSubmitAsync;
+        friend class TransactionConfirmAsync;
+        friend class ExportMetadataAsync;
+        friend class ImportMetadataAsync;
+        friend class StreamReadAsync;
 
-        static Napi::FunctionReference constructor;
         static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
-        void init(Napi::Env env)
+        void init(void)
         {
-            node_rfc::__env = env;
             paramSize = 0;
             connectionParams = NULL;
             connectionHandle = NULL;
             alive = false;
             __bcd = NODERFC_BCD_STRING;
+            __intern = false;
+            __slice = 0;
+            __bytes = NODERFC_BYTES_BUFFER;
 
             rc = (RFC_RC)0;
             errorInfo.code = rc;
@@ -63,7 +239,6 @@ namespace node_rfc
         ~Client(void);
 
     private:
-        static unsigned int __refCounter;
         unsigned int __refId;
 
         // Client API
@@ -77,10 +252,19 @@ namespace node_rfc
         Napi::Value ConnectionInfo(const Napi::CallbackInfo &info);
         Napi::Value Connect(const Napi::CallbackInfo &info);
         Napi::Value Invoke(const Napi::CallbackInfo &info);
+        Napi::Value Call(const Napi::CallbackInfo &info);
         Napi::Value Ping(const Napi::CallbackInfo &info);
         Napi::Value Close(const Napi::CallbackInfo &info);
         Napi::Value Reopen(const Napi::CallbackInfo &info);
         Napi::Value IsAlive(const Napi::CallbackInfo &info);
+        Napi::Value ExportMetadata(const Napi::CallbackInfo &info);
+        Napi::Value ImportMetadata(const Napi::CallbackInfo &info);
+        Napi::Value StreamRead(const Napi::CallbackInfo &info);
+        Napi::Value StreamClose(const Napi::CallbackInfo &info);
+        Napi::Value ReleaseResult(const Napi::CallbackInfo &info);
+
+        // options parsed and call queued, shared by invoke and promise call
+        Napi::Value queueInvoke(Napi::Value name, Napi::Value params, Napi::Function callback, Napi::Value callOptions);
 
         // SAP NW RFC SDK
 
@@ -89,16 +273,56 @@ namespace node_rfc
         Napi::Value fillFunctionParameter(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, Napi::String name, Napi::Value value);
         Napi::Value fillStructure(RFC_STRUCTURE_HANDLE structHandle, RFC_TYPE_DESC_HANDLE functionDescHandle, SAP_UC *cName, Napi::Value value);
         Napi::Value fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, Napi::Value value, RFC_TYPE_DESC_HANDLE functionDescHandle);
+        Napi::Value fillColumns(RFC_TABLE_HANDLE tableHandle, RFC_TYPE_DESC_HANDLE typeDesc, SAP_UC *cName, Napi::Object columns);
+        Napi::Value fillCell(RFC_TABLE_HANDLE tableHandle, TableColumn *column, unsigned int row);
+        bool flatTemplate(RFC_TYPE_DESC_HANDLE typeDesc, FlatRow *flatRow);
+        bool fillFlat(FlatRow *flatRow, RFC_STRUCTURE_HANDLE structHandle, Napi::Value line);
+        bool flatChars(FlatRow *flatRow, RFC_FIELD_DESC *fieldDesc, Napi::String value);
 
         Napi::Value wrapStructure(RFC_TYPE_DESC_HANDLE typeDesc, RFC_STRUCTURE_HANDLE structHandle);
+        bool rowTemplate(RFC_TYPE_DESC_HANDLE typeDesc, RowTemplate *row, RFC_ERROR_INFO *errorInfo);
+        Napi::Value wrapRow(RowTemplate *row, RFC_STRUCTURE_HANDLE structHandle);
+        Napi::Value wrapChars(RowTemplate *row, unsigned int column);
+        Napi::Value internChars(InternTable *intern, unsigned int column, RFC_STRUCTURE_HANDLE structHandle, RFC_FIELD_DESC *fieldDesc, RFC_CHAR *chars = NULL);
+        void rowSlab(RowTemplate *row, unsigned int rowCount);
+        Napi::Value wrapSlab(RowTemplate *row, RFC_STRUCTURE_HANDLE structHandle, RFC_FIELD_DESC *fieldDesc);
+        Napi::Value wrapBytes(SAP_RAW *bytes, unsigned int length);
         Napi::Value wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, unsigned int cLen, RFC_TYPE_DESC_HANDLE typeDesc);
-        Napi::Value wrapResult(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle);
+        Napi::Value wrapResult(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *skipName = NULL, std::vector<RFC_PARAMETER_DESC> *tables = NULL);
+
+        Napi::Value wrapLazy(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, InvokeOptions &options, SAP_UC *skipName = NULL);
+
+        // non-empty result tables converted in slices, callback called when done
+        void sliceResult(ResultSlices *slices);
+        bool wrapSlice(ResultSlices *slices);
+
+        // JSON parameters and result, worker thread
+        bool jsonFill(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, const char *json, size_t length, std::string &errorMessage, RFC_ERROR_INFO *errorInfo);
+        bool jsonConversions(void);
+        bool jsonStructure(RFC_TYPE_DESC_HANDLE typeDesc, RFC_STRUCTURE_HANDLE structHandle, std::string &json, RFC_ERROR_INFO *errorInfo);
+        bool jsonVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, unsigned int cLen, RFC_TYPE_DESC_HANDLE typeDesc, std::string &json, RFC_ERROR_INFO *errorInfo);
+        bool jsonResult(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, std::string &json, RFC_ERROR_INFO *errorInfo);
+        bool textVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, unsigned int cLen, std::string &text, int *kind, RFC_ERROR_INFO *errorInfo);
+
+        // Arrow IPC stream, worker thread
+        bool arrowTable(RFC_TABLE_HANDLE tableHandle, RFC_TYPE_DESC_HANDLE typeDesc, bool dictionary, std::string &stream, std::string &errorMessage, RFC_ERROR_INFO *errorInfo);
+
+        // table rows as NDJSON or CSV chunks, worker thread
+        bool streamChunk(TableCursor *cursor, std::string &chunk, std::string &errorMessage, RFC_ERROR_INFO *errorInfo);
+
+        // fixed-width lines split on the worker thread, wrapped after the call
+        bool splitTable(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, InvokeOptions &options, SplitTable &split, std::string &errorMessage, RFC_ERROR_INFO *errorInfo);
+        Napi::Value splitValue(SplitTable &split, size_t field, size_t begin, size_t end, bool convert);
+        Napi::Value wrapSplit(SplitTable &split, bool columns, bool convert);
 
         unsigned int paramSize;
         RFC_CONNECTION_PARAMETER *connectionParams;
         RFC_CONNECTION_HANDLE connectionHandle;
         bool alive;
         int __bcd = 0; // 0: string, 1: number, 2: function
+        bool __intern; // table CHAR values interned per column
+        unsigned int __slice; // milliseconds per result conversion slice, 0: at once
+        int __bytes;          // NODERFC_BYTES_*
         RFC_DIRECTION __filter_param_direction = (RFC_DIRECTION)0;
 
         Napi::FunctionReference __bcdFunction;
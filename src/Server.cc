@@ -0,0 +1,713 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#include <chrono>
+#include <thread>
+#include "Server.h"
+#include "noderfcsdk.h"
+#include "macros.h"
+
+namespace node_rfc
+{
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Registered server connections, used to find the Server of an incoming call
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static std::map<RFC_CONNECTION_HANDLE, Server *> __servers;
+    static uv_mutex_t __serversMutex;
+    static uv_once_t __serversOnce = UV_ONCE_INIT;
+
+    static void initServers(void)
+    {
+        uv_mutex_init(&__serversMutex);
+    }
+
+    static void registerConnection(RFC_CONNECTION_HANDLE connectionHandle, Server *server)
+    {
+        uv_once(&__serversOnce, initServers);
+        uv_mutex_lock(&__serversMutex);
+        __servers[connectionHandle] = server;
+        uv_mutex_unlock(&__serversMutex);
+    }
+
+    static void unregisterConnection(RFC_CONNECTION_HANDLE connectionHandle)
+    {
+        uv_once(&__serversOnce, initServers);
+        uv_mutex_lock(&__serversMutex);
+        __servers.erase(connectionHandle);
+        uv_mutex_unlock(&__serversMutex);
+    }
+
+    static Server *findServer(RFC_CONNECTION_HANDLE connectionHandle)
+    {
+        Server *server = NULL;
+        uv_once(&__serversOnce, initServers);
+        uv_mutex_lock(&__serversMutex);
+        std::map<RFC_CONNECTION_HANDLE, Server *>::iterator it = __servers.find(connectionHandle);
+        if (it != __servers.end())
+            server = it->second;
+        uv_mutex_unlock(&__serversMutex);
+        return server;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Listener thread helpers, no JS access
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static std::string utf8String(const SAP_UC *uc)
+    {
+        RFC_ERROR_INFO errorInfo;
+        unsigned int length = strlenU((SAP_UTF16 *)uc);
+        unsigned int utf8Size = length * 3;
+        unsigned int resultLen = 0;
+        std::string utf8(utf8Size + 1, '\0');
+        if (RfcSAPUCToUTF8(uc, length, (RFC_BYTE *)&utf8[0], &utf8Size, &resultLen, &errorInfo) != RFC_OK)
+            return std::string();
+        utf8.resize(resultLen);
+        while (utf8.size() > 0 && isspace(utf8[utf8.size() - 1]))
+            utf8.resize(utf8.size() - 1);
+        return utf8;
+    }
+
+    static void setErrorMessage(RFC_ERROR_INFO *errorInfo, std::string message)
+    {
+        RFC_ERROR_INFO convErrorInfo;
+        unsigned int sapucSize = sizeof(errorInfo->message) / sizeof(SAP_UC);
+        unsigned int resultLen = 0;
+
+        // ABAP SYSTEM_FAILURE, raised in the external server
+        errorInfo->code = RFC_EXTERNAL_FAILURE;
+        errorInfo->group = EXTERNAL_APPLICATION_FAILURE;
+        memsetU((SAP_UTF16 *)errorInfo->key, 0, sizeof(errorInfo->key) / sizeof(SAP_UC));
+        memsetU((SAP_UTF16 *)errorInfo->message, 0, sapucSize);
+        if (message.length() >= sapucSize)
+            message.resize(sapucSize - 1);
+        RfcUTF8ToSAPUC((RFC_BYTE *)&message[0], message.length(), errorInfo->message, &sapucSize, &resultLen, &convErrorInfo);
+    }
+
+    static std::string errorMessage(Napi::Value error)
+    {
+        if (error.IsObject())
+        {
+            Napi::Value message = error.As<Napi::Object>().Get("message");
+            if (message.IsString())
+                return message.As<Napi::String>().Utf8Value();
+        }
+        return error.ToString().Utf8Value();
+    }
+
+    static void noop(const Napi::CallbackInfo &info) {}
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Async workers
+    ////////////////////////////////////////////////////////////////////////////////
+
+    class StartAsync : public Napi::AsyncWorker
+    {
+    public:
+        StartAsync(Napi::Function &callback, Server *server)
+            : Napi::AsyncWorker(callback), server(server) {}
+        ~StartAsync() {}
+
+        void Execute()
+        {
+            errorInfo.code = RFC_OK;
+            for (unsigned int i = 0; i < server->threadCount; i++)
+            {
+                ServerListener listener;
+                listener.server = server;
+                listener.connectionHandle = RfcRegisterServer(server->serverParams, server->serverParamSize, &errorInfo);
+                if (listener.connectionHandle == NULL)
+                {
+                    break;
+                }
+                server->listeners.push_back(listener);
+            }
+
+            if (errorInfo.code != RFC_OK)
+            {
+                RFC_ERROR_INFO closeErrorInfo;
+                for (unsigned int i = 0; i < server->listeners.size(); i++)
+                {
+                    RfcCloseConnection(server->listeners[i].connectionHandle, &closeErrorInfo);
+                }
+                server->listeners.clear();
+            }
+        }
+
+        void OnOK()
+        {
+            if (errorInfo.code != RFC_OK)
+            {
+                server->running = false;
+                Napi::Value argv[1] = {wrapError(Env(), &errorInfo)};
+                CALLBACK_CALL(Env().Global(), Callback(), 1, argv);
+                return;
+            }
+
+            server->dispatcher = Napi::ThreadSafeFunction::New(Env(), Napi::Function::New(Env(), noop), "node-rfc-server", 0, 1);
+            server->stopping = false;
+            for (unsigned int i = 0; i < server->listeners.size(); i++)
+            {
+                registerConnection(server->listeners[i].connectionHandle, server);
+                uv_thread_create(&server->listeners[i].thread, Server::Listen, &server->listeners[i]);
+            }
+
+            // keep the running server from being garbage collected
+            server->Ref();
+
+            CALLBACK_CALL(Env().Global(), Callback(), 0, {});
+        }
+
+    private:
+        Server *server;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    class StopAsync : public Napi::AsyncWorker
+    {
+    public:
+        StopAsync(Napi::Function &callback, Server *server)
+            : Napi::AsyncWorker(callback), server(server) {}
+        ~StopAsync() {}
+
+        void Execute()
+        {
+            server->stopping = true;
+            for (unsigned int i = 0; i < server->listeners.size(); i++)
+            {
+                uv_thread_join(&server->listeners[i].thread);
+            }
+            server->listeners.clear();
+        }
+
+        void OnOK()
+        {
+            server->dispatcher.Release();
+            server->running = false;
+            server->Unref();
+            CALLBACK_CALL(Env().Global(), Callback(), 0, {});
+        }
+
+    private:
+        Server *server;
+    };
+
+    class AddFunctionAsync : public Napi::AsyncWorker
+    {
+    public:
+        AddFunctionAsync(Napi::Function &callback, Server *server, std::string functionName)
+            : Napi::AsyncWorker(callback), server(server), functionName(functionName)
+        {
+            funcName = server->client->fillString(functionName);
+        }
+        ~AddFunctionAsync() {}
+
+        void Execute()
+        {
+            server->client->LockMutex();
+            functionDescHandle = RfcGetFunctionDesc(server->client->connectionHandle, funcName, &errorInfo);
+            free(funcName);
+            if (functionDescHandle != NULL)
+            {
+                RfcInstallServerFunction(NULL, functionDescHandle, Server::GenericHandler, &errorInfo);
+            }
+        }
+
+        void OnOK()
+        {
+            server->client->UnlockMutex();
+            if (functionDescHandle == NULL || errorInfo.code != RFC_OK)
+            {
+                server->handlers.erase(functionName);
+                Napi::Value argv[1] = {wrapError(Env(), &errorInfo)};
+                CALLBACK_CALL(Env().Global(), Callback(), 1, argv);
+            }
+            else
+            {
+                CALLBACK_CALL(Env().Global(), Callback(), 0, {});
+            }
+        }
+
+    private:
+        Server *server;
+        std::string functionName;
+        SAP_UC *funcName;
+        RFC_FUNCTION_DESC_HANDLE functionDescHandle;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Listener threads
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void Server::Listen(void *arg)
+    {
+        ServerListener *listener = static_cast<ServerListener *>(arg);
+        Server *server = listener->server;
+        RFC_ERROR_INFO errorInfo;
+        RFC_RC rc;
+
+        while (!server->stopping)
+        {
+            if (listener->connectionHandle == NULL)
+            {
+                // connection closed by the SDK, register again
+                listener->connectionHandle = RfcRegisterServer(server->serverParams, server->serverParamSize, &errorInfo);
+                if (listener->connectionHandle == NULL)
+                {
+                    std::this_thread::sleep_for(std::chrono::seconds(NODERFC_SERVER_LISTEN_TIMEOUT));
+                    continue;
+                }
+                registerConnection(listener->connectionHandle, server);
+            }
+
+            rc = RfcListenAndDispatch(listener->connectionHandle, NODERFC_SERVER_LISTEN_TIMEOUT, &errorInfo);
+            switch (rc)
+            {
+            case RFC_OK:             // request processed
+            case RFC_RETRY:          // no request within timeout
+            case RFC_ABAP_EXCEPTION: // handler raised an exception, connection still open
+                break;
+            default: // RFC_ABAP_MESSAGE, RFC_EXTERNAL_FAILURE, RFC_COMMUNICATION_FAILURE, RFC_CLOSED, RFC_NOT_FOUND
+                unregisterConnection(listener->connectionHandle);
+                listener->connectionHandle = NULL;
+                break;
+            }
+        }
+
+        if (listener->connectionHandle != NULL)
+        {
+            unregisterConnection(listener->connectionHandle);
+            RfcCloseConnection(listener->connectionHandle, &errorInfo);
+            listener->connectionHandle = NULL;
+        }
+    }
+
+    RFC_RC SAP_API Server::GenericHandler(RFC_CONNECTION_HANDLE connectionHandle, RFC_FUNCTION_HANDLE functionHandle, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_ABAP_NAME functionName;
+        ServerRequest request;
+
+        request.server = findServer(connectionHandle);
+        request.functionHandle = functionHandle;
+        request.functionDescHandle = RfcDescribeFunction(functionHandle, errorInfo);
+        if (request.functionDescHandle == NULL)
+        {
+            return errorInfo->code;
+        }
+        if (request.server == NULL)
+        {
+            setErrorMessage(errorInfo, "node-rfc server not running");
+            return errorInfo->code;
+        }
+
+        RfcGetFunctionName(request.functionDescHandle, functionName, errorInfo);
+        request.functionName = utf8String(functionName);
+        request.errorInfo.code = RFC_OK;
+        request.errorInfo.group = OK;
+        uv_sem_init(&request.done, 0);
+
+        // run the JS handler on the main thread and wait for the result
+        napi_status status = request.server->dispatcher.BlockingCall(
+            &request, [](Napi::Env env, Napi::Function jsCallback, ServerRequest *request) {
+                request->server->handleRequest(env, request);
+            });
+        if (status == napi_ok)
+        {
+            uv_sem_wait(&request.done);
+        }
+        else
+        {
+            setErrorMessage(&request.errorInfo, "node-rfc server stopped");
+        }
+        uv_sem_destroy(&request.done);
+
+        if (request.errorInfo.code != RFC_OK)
+        {
+            *errorInfo = request.errorInfo;
+            return request.errorInfo.code;
+        }
+        return RFC_OK;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // JS handler dispatch, main thread
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void Server::handleRequest(Napi::Env env, ServerRequest *request)
+    {
+        Napi::HandleScope scope(env);
+
+        request->id = ++requestCounter;
+        outstanding[request->id] = request;
+        if (stopping)
+        {
+            failRequest(request, "node-rfc server stopped");
+            return;
+        }
+
+        std::map<std::string, Napi::FunctionReference>::iterator handler = handlers.find(request->functionName);
+        if (handler == handlers.end())
+        {
+            failRequest(request, "No JavaScript handler registered for " + request->functionName);
+            return;
+        }
+
+        Napi::Value result;
+        try
+        {
+            // IMPORTING, CHANGING and TABLES parameters, EXPORTING are set by the handler
+            RFC_PARAMETER_DESC paramDesc;
+            unsigned int paramCount = 0;
+            RfcGetParameterCount(request->functionDescHandle, &paramCount, NULL);
+
+            Napi::Object abapInput = Napi::Object::New(env);
+            for (unsigned int i = 0; i < paramCount; i++)
+            {
+                RfcGetParameterDescByIndex(request->functionDescHandle, i, &paramDesc, NULL);
+                if (paramDesc.direction == RFC_EXPORT)
+                {
+                    continue;
+                }
+                abapInput.Set(wrapString(Env(), paramDesc.name), client->wrapVariable(paramDesc.type, request->functionHandle, paramDesc.name, paramDesc.nucLength, paramDesc.typeDescHandle));
+            }
+
+            result = handler->second.Call({abapInput});
+        }
+        catch (const Napi::Error &e)
+        {
+            failRequest(request, e.Message());
+            return;
+        }
+
+        if (result.IsPromise())
+        {
+            // request may be failed by stop() before the promise settles, looked up by id
+            Napi::Object promise = result.As<Napi::Object>();
+            uint64_t id = request->id;
+            Server *server = this;
+            Ref();
+            Napi::Function onResolved = Napi::Function::New(env, [server, id](const Napi::CallbackInfo &info) {
+                server->settleRequest(id, info[0], false);
+            });
+            Napi::Function onRejected = Napi::Function::New(env, [server, id](const Napi::CallbackInfo &info) {
+                server->settleRequest(id, info[0], true);
+            });
+            promise.Get("then").As<Napi::Function>().Call(promise, {onResolved, onRejected});
+        }
+        else
+        {
+            completeRequest(request, result);
+        }
+    }
+
+    void Server::settleRequest(uint64_t id, Napi::Value result, bool rejected)
+    {
+        std::map<uint64_t, ServerRequest *>::iterator it = outstanding.find(id);
+        if (it != outstanding.end())
+        {
+            if (rejected)
+            {
+                failRequest(it->second, errorMessage(result));
+            }
+            else
+            {
+                completeRequest(it->second, result);
+            }
+        }
+        Unref();
+    }
+
+    void Server::completeRequest(ServerRequest *request, Napi::Value result)
+    {
+        if (!result.IsUndefined() && !result.IsNull())
+        {
+            if (!result.IsObject())
+            {
+                failRequest(request, "Server function " + request->functionName + " must return an object with ABAP parameters");
+                return;
+            }
+            try
+            {
+                Napi::Object params = result.As<Napi::Object>();
+                Napi::Array paramNames = params.GetPropertyNames();
+                for (unsigned int i = 0; i < paramNames.Length(); i++)
+                {
+                    Napi::String name = paramNames.Get(i).ToString();
+                    Napi::Value rv = client->fillFunctionParameter(request->functionDescHandle, request->functionHandle, name, params.Get(name));
+                    if (!rv.IsUndefined())
+                    {
+                        failRequest(request, errorMessage(rv));
+                        return;
+                    }
+                }
+            }
+            catch (const Napi::Error &e)
+            {
+                failRequest(request, e.Message());
+                return;
+            }
+        }
+        outstanding.erase(request->id);
+        uv_sem_post(&request->done);
+    }
+
+    void Server::failRequest(ServerRequest *request, std::string message)
+    {
+        setErrorMessage(&request->errorInfo, message);
+        outstanding.erase(request->id);
+        uv_sem_post(&request->done);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Server API
+    ////////////////////////////////////////////////////////////////////////////////
+
+    Server::Server(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Server>(info)
+    {
+        char err[256];
+
+        init();
+
+        if (!info.IsConstructCall())
+        {
+            Napi::Error::New(info.Env(), "Use the new operator to create instances of Rfc server.").ThrowAsJavaScriptException();
+            return;
+        }
+
+        if (info.Length() < 2)
+        {
+            Napi::Error::New(info.Env(), "Please provide server connection parameters and client as arguments").ThrowAsJavaScriptException();
+            return;
+        }
+
+        if (!info[0].IsObject())
+        {
+            Napi::TypeError::New(info.Env(), "Server connection parameters must be an object").ThrowAsJavaScriptException();
+            return;
+        }
+
+        if (!info[1].IsObject() || !info[1].ToObject().InstanceOf(addonData(info.Env())->clientConstructor.Value()))
+        {
+            Napi::TypeError::New(info.Env(), "Client instance required as second argument").ThrowAsJavaScriptException();
+            return;
+        }
+
+        if (info.Length() > 3)
+        {
+            Napi::TypeError::New(info.Env(), "Too many parameters, only server connection parameters, client and options object expected").ThrowAsJavaScriptException();
+            return;
+        }
+
+        if (info.Length() == 3 && !info[2].IsUndefined())
+        {
+            if (!info[2].IsObject())
+            {
+                Napi::TypeError::New(info.Env(), "Options must be an object").ThrowAsJavaScriptException();
+                return;
+            }
+
+            Napi::Object options = info[2].ToObject();
+            Napi::Array props = options.GetPropertyNames();
+            for (unsigned int i = 0; i < props.Length(); i++)
+            {
+                Napi::String key = props.Get(i).ToString();
+                Napi::Value opt = options.Get(key);
+                if (key.Utf8Value().compare(std::string("threads")) == (int)0)
+                {
+                    if (!opt.IsNumber() || opt.As<Napi::Number>().Int32Value() < 1)
+                    {
+                        Napi::TypeError::New(info.Env(), "Server threads option must be a positive number").ThrowAsJavaScriptException();
+                        return;
+                    }
+                    threadCount = opt.As<Napi::Number>().Uint32Value();
+                }
+                else
+                {
+                    std::string optionName = key.Utf8Value();
+                    sprintf(err, "Unknown option: %s", &optionName[0]);
+                    Napi::TypeError::New(info.Env(), err).ThrowAsJavaScriptException();
+                    return;
+                }
+            }
+        }
+
+        this->clientRef = Napi::Persistent(info[1].ToObject());
+        this->client = Client::Unwrap(info[1].ToObject());
+
+        Napi::Object serverParams = info[0].ToObject();
+        Napi::Array paramNames = serverParams.GetPropertyNames();
+        this->serverParamSize = paramNames.Length();
+        this->serverParams = static_cast<RFC_CONNECTION_PARAMETER *>(malloc(this->serverParamSize * sizeof(RFC_CONNECTION_PARAMETER)));
+        for (unsigned int i = 0; i < this->serverParamSize; i++)
+        {
+            Napi::String name = paramNames.Get(i).ToString();
+            Napi::String value = serverParams.Get(name).ToString();
+            this->serverParams[i].name = client->fillString(name);
+            this->serverParams[i].value = client->fillString(value);
+        }
+
+        this->__refId = ++addonData(info.Env())->serverRefCounter;
+    }
+
+    Server::~Server(void)
+    {
+        if (running)
+        {
+            stopping = true;
+            for (unsigned int i = 0; i < listeners.size(); i++)
+            {
+                uv_thread_join(&listeners[i].thread);
+            }
+            listeners.clear();
+        }
+
+        for (unsigned int i = 0; i < this->serverParamSize; i++)
+        {
+            free(const_cast<SAP_UC *>(serverParams[i].name));
+            free(const_cast<SAP_UC *>(serverParams[i].value));
+        }
+        free(serverParams);
+
+        handlers.clear();
+        clientRef.Reset();
+    }
+
+    Napi::Object Server::Init(Napi::Env env, Napi::Object exports)
+    {
+        Napi::HandleScope scope(env);
+
+        Napi::Function t = DefineClass(env,
+                                       "Server", {
+                                                     InstanceAccessor("id", &Server::IdGetter, nullptr),
+                                                     InstanceAccessor("alive", &Server::AliveGetter, nullptr),
+                                                     InstanceAccessor("threads", &Server::ThreadsGetter, nullptr),
+                                                     InstanceMethod("start", &Server::Start),
+                                                     InstanceMethod("stop", &Server::Stop),
+                                                     InstanceMethod("addFunction", &Server::AddFunction),
+                                                     InstanceMethod("removeFunction", &Server::RemoveFunction),
+                                                 });
+
+        addonData(env)->serverConstructor = Napi::Persistent(t);
+
+        exports.Set("Server", t);
+        return exports;
+    }
+
+    Napi::Value Server::Start(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "First argument must be callback function").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[0].As<Napi::Function>();
+
+        if (running)
+        {
+            Napi::Value argv[1] = {Napi::Error::New(info.Env(), "Server already running").Value()};
+            CALLBACK_CALL(info.Env().Global(), callback, 1, argv);
+            return info.Env().Undefined();
+        }
+        running = true;
+
+        (new StartAsync(callback, this))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Server::Stop(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "First argument must be callback function").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[0].As<Napi::Function>();
+
+        if (!running || stopping)
+        {
+            CALLBACK_CALL(info.Env().Global(), callback, 0, {});
+            return info.Env().Undefined();
+        }
+
+        // listener threads blocked by unsettled handlers released before joined
+        stopping = true;
+        while (!outstanding.empty())
+        {
+            failRequest(outstanding.begin()->second, "node-rfc server stopped");
+        }
+
+        (new StopAsync(callback, this))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Server::AddFunction(const Napi::CallbackInfo &info)
+    {
+        if (info.Length() < 3 || !info[0].IsString() || !info[1].IsFunction() || !info[2].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "ABAP function name, JavaScript function and callback function required as arguments").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+
+        std::string functionName = info[0].As<Napi::String>().Utf8Value();
+        for (unsigned int i = 0; i < functionName.length(); i++)
+        {
+            functionName[i] = toupper(functionName[i]);
+        }
+        Napi::Function callback = info[2].As<Napi::Function>();
+
+        handlers[functionName] = Napi::Persistent(info[1].As<Napi::Function>());
+
+        (new AddFunctionAsync(callback, this, functionName))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Server::RemoveFunction(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsString())
+        {
+            Napi::TypeError::New(info.Env(), "ABAP function name required as argument").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+
+        std::string functionName = info[0].As<Napi::String>().Utf8Value();
+        for (unsigned int i = 0; i < functionName.length(); i++)
+        {
+            functionName[i] = toupper(functionName[i]);
+        }
+
+        return Napi::Boolean::New(info.Env(), handlers.erase(functionName) > 0);
+    }
+
+    Napi::Value Server::IdGetter(const Napi::CallbackInfo &info)
+    {
+        return Napi::Number::New(info.Env(), this->__refId);
+    }
+
+    Napi::Value Server::AliveGetter(const Napi::CallbackInfo &info)
+    {
+        return Napi::Boolean::New(info.Env(), this->running && !this->stopping);
+    }
+
+    Napi::Value Server::ThreadsGetter(const Napi::CallbackInfo &info)
+    {
+        return Napi::Number::New(info.Env(), this->threadCount);
+    }
+
+} // namespace node_rfc
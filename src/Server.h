@@ -0,0 +1,128 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#ifndef NODE_SAPNWRFC_SERVER_H_
+#define NODE_SAPNWRFC_SERVER_H_
+
+#define NODERFC_SERVER_THREADS 1
+#define NODERFC_SERVER_LISTEN_TIMEOUT 1 // seconds
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+#include <uv.h>
+#include <napi.h>
+#include <sapnwrfc.h>
+#include "addon.h"
+#include "Client.h"
+
+using namespace Napi;
+
+namespace node_rfc
+{
+    class Server;
+
+    // Incoming ABAP call, handed over from the listener thread to JavaScript
+    typedef struct _ServerRequest
+    {
+        Server *server;
+        std::string functionName;
+        RFC_FUNCTION_HANDLE functionHandle;
+        RFC_FUNCTION_DESC_HANDLE functionDescHandle;
+        RFC_ERROR_INFO errorInfo;
+        uv_sem_t done;
+        uint64_t id; // outstanding requests key, main thread
+    } ServerRequest;
+
+    // Listener thread and its registered server connection
+    typedef struct _ServerListener
+    {
+        Server *server;
+        uv_thread_t thread;
+        RFC_CONNECTION_HANDLE connectionHandle;
+    } ServerListener;
+
+    class Server : public Napi::ObjectWrap<Server>
+    {
+    public:
+        friend class StartAsync;
+        friend class StopAsync;
+        friend class AddFunctionAsync;
+
+        static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+        void init(void)
+        {
+            serverParamSize = 0;
+            serverParams = NULL;
+            client = NULL;
+            threadCount = NODERFC_SERVER_THREADS;
+            running = false;
+            stopping = false;
+            requestCounter = 0;
+        };
+
+        Server(const Napi::CallbackInfo &info);
+        ~Server(void);
+
+        // SAP NW RFC SDK server function, installed for all JS handled ABAP functions
+        static RFC_RC SAP_API GenericHandler(RFC_CONNECTION_HANDLE connectionHandle, RFC_FUNCTION_HANDLE functionHandle, RFC_ERROR_INFO *errorInfo);
+
+    private:
+        unsigned int __refId;
+
+        // Server API
+
+        Napi::Value IdGetter(const Napi::CallbackInfo &info);
+        Napi::Value AliveGetter(const Napi::CallbackInfo &info);
+        Napi::Value ThreadsGetter(const Napi::CallbackInfo &info);
+
+        Napi::Value Start(const Napi::CallbackInfo &info);
+        Napi::Value Stop(const Napi::CallbackInfo &info);
+        Napi::Value AddFunction(const Napi::CallbackInfo &info);
+        Napi::Value RemoveFunction(const Napi::CallbackInfo &info);
+
+        // JS dispatch, main thread
+
+        void handleRequest(Napi::Env env, ServerRequest *request);
+        void completeRequest(ServerRequest *request, Napi::Value result);
+        void failRequest(ServerRequest *request, std::string message);
+        void settleRequest(uint64_t id, Napi::Value result, bool rejected);
+
+        static void Listen(void *arg);
+
+        unsigned int serverParamSize;
+        RFC_CONNECTION_PARAMETER *serverParams;
+
+        // client providing function descriptions and data conversions
+        Client *client;
+        Napi::ObjectReference clientRef;
+
+        unsigned int threadCount;
+        std::vector<ServerListener> listeners;
+        std::atomic<bool> running;
+        std::atomic<bool> stopping;
+
+        // requests waiting for the JS handler, failed by stop()
+        std::map<uint64_t, ServerRequest *> outstanding;
+        uint64_t requestCounter;
+
+        std::map<std::string, Napi::FunctionReference> handlers;
+        Napi::ThreadSafeFunction dispatcher;
+    };
+
+} // namespace node_rfc
+
+#endif // NODE_SAPNWRFC_SERVER_H_
@@ -20,24 +20,19 @@
 namespace node_rfc
 {
 
-    unsigned int Throughput::__refCounter = 0;
-    extern Napi::Env __env;
-
-    Napi::FunctionReference Throughput::constructor;
-
     Throughput::Throughput(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Throughput>(info)
     {
         if (!info.IsConstructCall())
         {
             Napi::Error::New(info.Env(), "Use the new operator to create instances of Rfc  Throughput.").ThrowAsJavaScriptException();
         }
-        init(info.Env());
         RFC_ERROR_INFO errorInfo;
         this->__handle = RfcCreateThroughput(&errorInfo);
         if (errorInfo.code != RFC_OK)
             Napi::Error::New(info.Env(), "node-rfc internal error: Throughput create failed.\nCheck if SAP NWRFC SDK version >= 7.53").ThrowAsJavaScriptException();
 
-        this->__refId = ++Throughput::__refCounter;
+        this->__refId = ++addonData(info.Env())->throughputRefCounter;
+        this->__sampled = 0;
     }
 
     Throughput::~Throughput(void)
@@ -67,10 +62,10 @@ namespace node_rfc
                 StaticMethod("getFromConnection", &Throughput::GetFromConnection),
                 InstanceMethod("reset", &Throughput::Reset),
                 InstanceMethod("destroy", &Throughput::Destroy),
+                InstanceMethod("snapshot", &Throughput::Snapshot),
             });
 
-        constructor = Napi::Persistent(t);
-        constructor.SuppressDestruct();
+        addonData(env)->throughputConstructor = Napi::Persistent(t);
 
         exports.Set("Throughput", t);
         return exports;
@@ -82,7 +77,7 @@ namespace node_rfc
         RFC_ERROR_INFO errorInfo;
         RFC_RC rc = RfcResetThroughput(this->__handle, &errorInfo);
         if (rc != RFC_OK)
-            return scope.Escape(wrapError(&errorInfo));
+            return scope.Escape(wrapError(info.Env(), &errorInfo));
         return info.Env().Undefined();
     }
 
@@ -95,7 +90,7 @@ namespace node_rfc
             RFC_RC rc = RfcDestroyThroughput(this->__handle, &errorInfo);
             this->__handle = NULL;
             if (rc != RFC_OK)
-                return scope.Escape(wrapError(&errorInfo));
+                return scope.Escape(wrapError(info.Env(), &errorInfo));
         }
         return info.Env().Undefined();
     }
@@ -140,6 +135,59 @@ namespace node_rfc
         return scope.Escape(status);
     }
 
+    // counters summed by the SDK over all connections of the handle,
+    // written with interval rates into a caller owned Float64Array
+    Napi::Value Throughput::Snapshot(const Napi::CallbackInfo &info)
+    {
+        Napi::EscapableHandleScope scope(info.Env());
+
+        if (!info[0].IsTypedArray() || info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array ||
+            info[0].As<Napi::TypedArray>().ElementLength() < NODERFC_THROUGHPUT_SNAPSHOT)
+        {
+            Napi::TypeError::New(info.Env(), "Float64Array of " + std::to_string(NODERFC_THROUGHPUT_SNAPSHOT) + " elements required as argument").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        if (this->__handle == NULL)
+        {
+            Napi::Error::New(info.Env(), "node-rfc internal error: Throughput without handle!").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+
+        RFC_ERROR_INFO errorInfo;
+        SAP_ULLONG counters[NODERFC_THROUGHPUT_COUNTERS];
+        if (RfcGetNumberOfCalls(this->__handle, &counters[0], &errorInfo) != RFC_OK ||
+            RfcGetSentBytes(this->__handle, &counters[1], &errorInfo) != RFC_OK ||
+            RfcGetReceivedBytes(this->__handle, &counters[2], &errorInfo) != RFC_OK ||
+            RfcGetApplicationTime(this->__handle, &counters[3], &errorInfo) != RFC_OK ||
+            RfcGetTotalTime(this->__handle, &counters[4], &errorInfo) != RFC_OK ||
+            RfcGetSerializationTime(this->__handle, &counters[5], &errorInfo) != RFC_OK ||
+            RfcGetDeserializationTime(this->__handle, &counters[6], &errorInfo) != RFC_OK)
+        {
+            return scope.Escape(wrapError(info.Env(), &errorInfo));
+        }
+
+        uint64_t now = uv_hrtime();
+        double interval = this->__sampled == 0 ? 0 : (double)(now - this->__sampled) / 1e9;
+        double delta[NODERFC_THROUGHPUT_COUNTERS];
+        double *values = info[0].As<Napi::Float64Array>().Data();
+        for (unsigned int i = 0; i < NODERFC_THROUGHPUT_COUNTERS; i++)
+        {
+            values[i] = (double)counters[i];
+            // after reset() counted from zero
+            delta[i] = (double)(this->__sampled == 0 || counters[i] < this->__sampledCounters[i] ? counters[i] : counters[i] - this->__sampledCounters[i]);
+            this->__sampledCounters[i] = counters[i];
+        }
+        this->__sampled = now;
+
+        values[7] = interval;
+        values[8] = interval > 0 ? delta[0] / interval : 0;
+        values[9] = interval > 0 ? delta[1] / interval : 0;
+        values[10] = interval > 0 ? delta[2] / interval : 0;
+        values[11] = delta[0] > 0 ? delta[3] / delta[0] : 0;
+
+        return info.Env().Undefined();
+    }
+
     Napi::Value Throughput::SetOnConnection(const Napi::CallbackInfo &info)
     {
         Napi::EscapableHandleScope scope(info.Env());
@@ -157,7 +205,7 @@ namespace node_rfc
         RFC_RC rc = RfcSetThroughputOnConnection(connectionHandle, this->__handle, &errorInfo);
         if (rc != RFC_OK)
         {
-            return scope.Escape(wrapError(&errorInfo));
+            return scope.Escape(wrapError(info.Env(), &errorInfo));
         }
 
         return info.Env().Undefined();
@@ -180,7 +228,7 @@ namespace node_rfc
         RFC_RC rc = RfcRemoveThroughputFromConnection(connectionHandle, &errorInfo);
         if (rc != RFC_OK)
         {
-            return scope.Escape(wrapError(&errorInfo));
+            return scope.Escape(wrapError(info.Env(), &errorInfo));
         }
 
         return info.Env().Undefined();
@@ -203,7 +251,7 @@ namespace node_rfc
         RFC_THROUGHPUT_HANDLE throughputHandle = RfcGetThroughputFromConnection(connectionHandle, &errorInfo);
         if (errorInfo.code != RFC_OK)
         {
-            return scope.Escape(wrapError(&errorInfo));
+            return scope.Escape(wrapError(info.Env(), &errorInfo));
         }
         return Napi::Number::New(info.Env(), static_cast<double>((uint64_t)throughputHandle));
     }
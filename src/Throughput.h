@@ -15,30 +15,28 @@
 #ifndef NODE_SAPNWRFC_THROUGHPUT_H_
 #define NODE_SAPNWRFC_THROUGHPUT_H_
 
+#include <uv.h>
 #include <napi.h>
 #include <sapnwrfc.h>
+#include "addon.h"
+
+// snapshot(): counters, interval seconds, calls/s, sent and received bytes/s, mean application time
+#define NODERFC_THROUGHPUT_COUNTERS 7
+#define NODERFC_THROUGHPUT_SNAPSHOT 12
 
 using namespace Napi;
 
 namespace node_rfc
 {
-    extern Napi::Env __env;
     class Throughput : public Napi::ObjectWrap<Throughput>
     {
     public:
-        static Napi::FunctionReference constructor;
         static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
-        void init(Napi::Env env)
-        {
-            node_rfc::__env = env;
-        };
-
         Throughput(const Napi::CallbackInfo &info);
         ~Throughput(void);
 
     private:
-        static unsigned int __refCounter;
         unsigned int __refId;
         Napi::Object __statusObj;
 
@@ -52,9 +50,14 @@ namespace node_rfc
         static Napi::Value GetFromConnection(const Napi::CallbackInfo &info);
         Napi::Value Reset(const Napi::CallbackInfo &info);
         Napi::Value Destroy(const Napi::CallbackInfo &info);
+        Napi::Value Snapshot(const Napi::CallbackInfo &info);
 
         // SAP NW RFC SDK
         RFC_THROUGHPUT_HANDLE __handle;
+
+        // counters of the previous snapshot, for interval rates
+        SAP_ULLONG __sampledCounters[NODERFC_THROUGHPUT_COUNTERS];
+        uint64_t __sampled; // uv_hrtime(), 0: not sampled
     };
 
 } // namespace node_rfc
@@ -0,0 +1,549 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#include "Transaction.h"
+#include "noderfcsdk.h"
+#include "macros.h"
+
+namespace node_rfc
+{
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Async workers
+    ////////////////////////////////////////////////////////////////////////////////
+
+    class TransactionCreateAsync : public Napi::AsyncWorker
+    {
+    public:
+        TransactionCreateAsync(Napi::Function &callback, Transaction *transaction)
+            : Napi::AsyncWorker(callback), transaction(transaction), client(transaction->client) {}
+        ~TransactionCreateAsync() {}
+
+        void Execute()
+        {
+            client->LockMutex();
+            errorInfo.code = RFC_OK;
+            if (transaction->unit)
+            {
+                RFC_UNITID unitID;
+                if (transaction->unitIdentifier.unitID[0] == 0)
+                {
+                    RfcGetUnitID(client->connectionHandle, transaction->unitIdentifier.unitID, &errorInfo);
+                }
+                if (errorInfo.code == RFC_OK)
+                {
+                    RFC_UNIT_ATTRIBUTES unitAttr;
+                    memset(&unitAttr, 0, sizeof(unitAttr));
+                    strcpyU(unitID, transaction->unitIdentifier.unitID);
+                    transaction->unitHandle = RfcCreateUnit(client->connectionHandle, unitID, transaction->queueNames, transaction->queueNameCount, &unitAttr, &transaction->unitIdentifier, &errorInfo);
+                }
+            }
+            else
+            {
+                if (transaction->tid[0] == 0)
+                {
+                    RfcGetTransactionID(client->connectionHandle, transaction->tid, &errorInfo);
+                }
+                if (errorInfo.code == RFC_OK)
+                {
+                    const SAP_UC *queueName = transaction->queueNameCount > 0 ? transaction->queueNames[0] : NULL;
+                    transaction->transactionHandle = RfcCreateTransaction(client->connectionHandle, transaction->tid, queueName, &errorInfo);
+                }
+            }
+        }
+
+        void OnOK()
+        {
+            client->UnlockMutex();
+            Napi::Value argv[2] = {Env().Undefined(), Env().Undefined()};
+            if (errorInfo.code != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &errorInfo, client->alive);
+            }
+            else
+            {
+                argv[1] = transaction->unit ? wrapString(Env(), transaction->unitIdentifier.unitID) : wrapString(Env(), transaction->tid);
+            }
+            CALLBACK_CALL(Env().Global(), Callback(), 2, argv);
+        }
+
+    private:
+        Transaction *transaction;
+        Client *client;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    class TransactionAddAsync : public Napi::AsyncWorker
+    {
+    public:
+        TransactionAddAsync(Napi::Function &callback, Transaction *transaction, Napi::String rfmName, Napi::Object &rfmParams)
+            : Napi::AsyncWorker(callback), transaction(transaction), client(transaction->client),
+              rfmParams(Napi::Persistent(rfmParams))
+        {
+            funcName = client->fillString(rfmName);
+        }
+        ~TransactionAddAsync() {}
+
+        void Execute()
+        {
+            client->LockMutex();
+            functionDescHandle = RfcGetFunctionDesc(client->connectionHandle, funcName, &errorInfo);
+            free(funcName);
+        }
+
+        void OnOK()
+        {
+            client->UnlockMutex();
+            RFC_FUNCTION_HANDLE functionHandle = NULL;
+            Napi::Value argv[1] = {Env().Undefined()};
+
+            if (functionDescHandle == NULL || errorInfo.code != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &errorInfo);
+            }
+            else
+            {
+                functionHandle = RfcCreateFunction(functionDescHandle, &errorInfo);
+                if (errorInfo.code != RFC_OK)
+                {
+                    argv[0] = wrapError(Env(), &errorInfo);
+                }
+            }
+
+            if (argv[0].IsUndefined())
+            {
+                Napi::Object params = rfmParams.Value();
+                Napi::Array paramNames = params.GetPropertyNames();
+                for (unsigned int i = 0; i < paramNames.Length(); i++)
+                {
+                    Napi::String name = paramNames.Get(i).ToString();
+                    argv[0] = client->fillFunctionParameter(functionDescHandle, functionHandle, name, params.Get(name));
+                    if (!argv[0].IsUndefined())
+                    {
+                        break;
+                    }
+                }
+            }
+
+            rfmParams.Reset();
+
+            // serialized into the transaction, sent by submit
+            if (argv[0].IsUndefined() && transaction->invokeIn(functionHandle, &errorInfo) != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &errorInfo);
+            }
+
+            if (functionHandle != NULL)
+            {
+                RfcDestroyFunction(functionHandle, NULL);
+            }
+
+            CALLBACK_CALL(Env().Global(), Callback(), 1, argv);
+        }
+
+    private:
+        Transaction *transaction;
+        Client *client;
+        SAP_UC *funcName;
+        Napi::Reference<Napi::Object> rfmParams;
+
+        RFC_FUNCTION_DESC_HANDLE functionDescHandle;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    class TransactionSubmitAsync : public Napi::AsyncWorker
+    {
+    public:
+        TransactionSubmitAsync(Napi::Function &callback, Transaction *transaction)
+            : Napi::AsyncWorker(callback), transaction(transaction), client(transaction->client) {}
+        ~TransactionSubmitAsync() {}
+
+        void Execute()
+        {
+            client->LockMutex();
+            if (transaction->unit)
+            {
+                RfcSubmitUnit(transaction->unitHandle, &errorInfo);
+            }
+            else
+            {
+                RfcSubmitTransaction(transaction->transactionHandle, &errorInfo);
+            }
+        }
+
+        void OnOK()
+        {
+            client->UnlockMutex();
+            Napi::Value argv[1] = {Env().Undefined()};
+            if (errorInfo.code != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &errorInfo, client->alive);
+            }
+            else
+            {
+                transaction->submitted = true;
+            }
+            CALLBACK_CALL(Env().Global(), Callback(), 1, argv);
+        }
+
+    private:
+        Transaction *transaction;
+        Client *client;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    class TransactionConfirmAsync : public Napi::AsyncWorker
+    {
+    public:
+        TransactionConfirmAsync(Napi::Function &callback, Transaction *transaction)
+            : Napi::AsyncWorker(callback), transaction(transaction), client(transaction->client) {}
+        ~TransactionConfirmAsync() {}
+
+        void Execute()
+        {
+            client->LockMutex();
+            if (transaction->unit)
+            {
+                RfcConfirmUnit(client->connectionHandle, &transaction->unitIdentifier, &errorInfo);
+            }
+            else
+            {
+                RfcConfirmTransaction(transaction->transactionHandle, &errorInfo);
+            }
+        }
+
+        void OnOK()
+        {
+            client->UnlockMutex();
+            Napi::Value argv[1] = {Env().Undefined()};
+            if (errorInfo.code != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &errorInfo, client->alive);
+            }
+            else
+            {
+                transaction->destroyHandle();
+            }
+            CALLBACK_CALL(Env().Global(), Callback(), 1, argv);
+        }
+
+    private:
+        Transaction *transaction;
+        Client *client;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Transaction API
+    ////////////////////////////////////////////////////////////////////////////////
+
+    Transaction::Transaction(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Transaction>(info)
+    {
+        std::string id;
+
+        init();
+
+        if (!info.IsConstructCall())
+        {
+            Napi::Error::New(info.Env(), "Use the new operator to create instances of Rfc transaction.").ThrowAsJavaScriptException();
+            return;
+        }
+
+        if (info.Length() < 1 || !info[0].IsObject() || !info[0].ToObject().InstanceOf(addonData(info.Env())->clientConstructor.Value()))
+        {
+            Napi::TypeError::New(info.Env(), "Client instance required as first argument").ThrowAsJavaScriptException();
+            return;
+        }
+
+        if (info.Length() > 1 && !info[1].IsUndefined())
+        {
+            if (!info[1].IsObject())
+            {
+                Napi::TypeError::New(info.Env(), "Options must be an object").ThrowAsJavaScriptException();
+                return;
+            }
+
+            Napi::Object options = info[1].ToObject();
+            Napi::Array props = options.GetPropertyNames();
+            for (unsigned int i = 0; i < props.Length(); i++)
+            {
+                Napi::String key = props.Get(i).ToString();
+                Napi::Value opt = options.Get(key);
+                if (key.Utf8Value().compare(std::string("unit")) == (int)0)
+                {
+                    unit = opt.ToBoolean();
+                }
+                else if (key.Utf8Value().compare(std::string("queue")) == (int)0)
+                {
+                    if (opt.IsString())
+                    {
+                        queues.push_back(opt.As<Napi::String>().Utf8Value());
+                    }
+                    else if (opt.IsArray())
+                    {
+                        Napi::Array queueArray = opt.As<Napi::Array>();
+                        for (unsigned int j = 0; j < queueArray.Length(); j++)
+                        {
+                            queues.push_back(queueArray.Get(j).ToString().Utf8Value());
+                        }
+                    }
+                    else if (!opt.IsUndefined())
+                    {
+                        Napi::TypeError::New(info.Env(), "Queue option must be a string or array of strings").ThrowAsJavaScriptException();
+                        return;
+                    }
+                }
+                else if (key.Utf8Value().compare(std::string("id")) == (int)0)
+                {
+                    if (!opt.IsString())
+                    {
+                        Napi::TypeError::New(info.Env(), "Transaction id option must be a string").ThrowAsJavaScriptException();
+                        return;
+                    }
+                    id = opt.As<Napi::String>().Utf8Value();
+                }
+                else
+                {
+                    Napi::TypeError::New(info.Env(), "Unknown option: " + key.Utf8Value()).ThrowAsJavaScriptException();
+                    return;
+                }
+            }
+        }
+
+        if (!unit && queues.size() > 1)
+        {
+            Napi::TypeError::New(info.Env(), "Only one queue supported for qRFC, use bgRFC unit for multiple queues").ThrowAsJavaScriptException();
+            return;
+        }
+
+        unsigned int idLength = unit ? RFC_UNITID_LN : RFC_TID_LN;
+        if (id.length() > 0 && id.length() != idLength)
+        {
+            // caller supplied id of any length, not formatted into a fixed buffer
+            Napi::TypeError::New(info.Env(), "Transaction id must be " + std::to_string(idLength) + " characters long, received: " + id).ThrowAsJavaScriptException();
+            return;
+        }
+
+        this->clientRef = Napi::Persistent(info[0].ToObject());
+        this->client = Client::Unwrap(info[0].ToObject());
+
+        if (id.length() > 0)
+        {
+            SAP_UC *sapId = client->fillString(id);
+            strncpyU(unit ? unitIdentifier.unitID : tid, sapId, idLength);
+            free(sapId);
+        }
+
+        queueNameCount = queues.size();
+        if (queueNameCount > 0)
+        {
+            queueNames = static_cast<const SAP_UC **>(malloc(queueNameCount * sizeof(SAP_UC *)));
+            for (unsigned int i = 0; i < queueNameCount; i++)
+            {
+                queueNames[i] = client->fillString(queues[i]);
+            }
+        }
+
+        this->__refId = ++addonData(info.Env())->transactionRefCounter;
+    }
+
+    Transaction::~Transaction(void)
+    {
+        destroyHandle();
+
+        for (unsigned int i = 0; i < queueNameCount; i++)
+        {
+            free(const_cast<SAP_UC *>(queueNames[i]));
+        }
+        free(queueNames);
+
+        clientRef.Reset();
+    }
+
+    Napi::Object Transaction::Init(Napi::Env env, Napi::Object exports)
+    {
+        Napi::HandleScope scope(env);
+
+        Napi::Function t = DefineClass(env,
+                                       "Transaction", {
+                                                          InstanceAccessor("id", &Transaction::IdGetter, nullptr),
+                                                          InstanceAccessor("tid", &Transaction::TidGetter, nullptr),
+                                                          InstanceAccessor("type", &Transaction::TypeGetter, nullptr),
+                                                          InstanceAccessor("queue", &Transaction::QueueGetter, nullptr),
+                                                          InstanceMethod("create", &Transaction::Create),
+                                                          InstanceMethod("add", &Transaction::Add),
+                                                          InstanceMethod("submit", &Transaction::Submit),
+                                                          InstanceMethod("confirm", &Transaction::Confirm),
+                                                          InstanceMethod("destroy", &Transaction::Destroy),
+                                                      });
+
+        addonData(env)->transactionConstructor = Napi::Persistent(t);
+
+        exports.Set("Transaction", t);
+        return exports;
+    }
+
+    bool Transaction::created(void)
+    {
+        return unit ? unitHandle != NULL : transactionHandle != NULL;
+    }
+
+    void Transaction::destroyHandle(void)
+    {
+        if (transactionHandle != NULL)
+        {
+            RfcDestroyTransaction(transactionHandle, NULL);
+            transactionHandle = NULL;
+        }
+        if (unitHandle != NULL)
+        {
+            RfcDestroyUnit(unitHandle, NULL);
+            unitHandle = NULL;
+        }
+        // TID/unit ID kept, create() again resends under the same id
+        submitted = false;
+    }
+
+    RFC_RC Transaction::invokeIn(RFC_FUNCTION_HANDLE functionHandle, RFC_ERROR_INFO *errorInfo)
+    {
+        if (unit)
+        {
+            return RfcInvokeInUnit(unitHandle, functionHandle, errorInfo);
+        }
+        return RfcInvokeInTransaction(transactionHandle, functionHandle, errorInfo);
+    }
+
+    Napi::Value Transaction::Create(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "First argument must be callback function").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[0].As<Napi::Function>();
+
+        if (created() || submitted)
+        {
+            Napi::Value argv[1] = {Napi::Error::New(info.Env(), "Transaction already created").Value()};
+            CALLBACK_CALL(info.Env().Global(), callback, 1, argv);
+            return info.Env().Undefined();
+        }
+
+        (new TransactionCreateAsync(callback, this))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Transaction::Add(const Napi::CallbackInfo &info)
+    {
+        if (info.Length() < 3 || !info[0].IsString() || !info[1].IsObject() || !info[2].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "Please provide remote function module name, parameters and callback as arguments").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[2].As<Napi::Function>();
+
+        if (!created() || submitted)
+        {
+            Napi::Value argv[1] = {Napi::Error::New(info.Env(), submitted ? "Transaction already submitted" : "Transaction not created").Value()};
+            CALLBACK_CALL(info.Env().Global(), callback, 1, argv);
+            return info.Env().Undefined();
+        }
+
+        Napi::String rfmName = info[0].As<Napi::String>();
+        Napi::Object rfmParams = info[1].As<Napi::Object>();
+
+        (new TransactionAddAsync(callback, this, rfmName, rfmParams))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Transaction::Submit(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "First argument must be callback function").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[0].As<Napi::Function>();
+
+        if (!created())
+        {
+            Napi::Value argv[1] = {Napi::Error::New(info.Env(), "Transaction not created").Value()};
+            CALLBACK_CALL(info.Env().Global(), callback, 1, argv);
+            return info.Env().Undefined();
+        }
+
+        (new TransactionSubmitAsync(callback, this))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Transaction::Confirm(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "First argument must be callback function").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[0].As<Napi::Function>();
+
+        if (!created() || !submitted)
+        {
+            Napi::Value argv[1] = {Napi::Error::New(info.Env(), "Transaction not submitted").Value()};
+            CALLBACK_CALL(info.Env().Global(), callback, 1, argv);
+            return info.Env().Undefined();
+        }
+
+        (new TransactionConfirmAsync(callback, this))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Transaction::Destroy(const Napi::CallbackInfo &info)
+    {
+        destroyHandle();
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Transaction::IdGetter(const Napi::CallbackInfo &info)
+    {
+        return Napi::Number::New(info.Env(), this->__refId);
+    }
+
+    Napi::Value Transaction::TidGetter(const Napi::CallbackInfo &info)
+    {
+        return unit ? wrapString(Env(), unitIdentifier.unitID) : wrapString(Env(), tid);
+    }
+
+    Napi::Value Transaction::TypeGetter(const Napi::CallbackInfo &info)
+    {
+        if (unit)
+        {
+            return Napi::String::New(info.Env(), "bgRFC");
+        }
+        return Napi::String::New(info.Env(), queueNameCount > 0 ? "qRFC" : "tRFC");
+    }
+
+    Napi::Value Transaction::QueueGetter(const Napi::CallbackInfo &info)
+    {
+        Napi::Array queueArray = Napi::Array::New(info.Env(), queues.size());
+        for (unsigned int i = 0; i < queues.size(); i++)
+        {
+            queueArray.Set(i, Napi::String::New(info.Env(), queues[i]));
+        }
+        return queueArray;
+    }
+
+} // namespace node_rfc
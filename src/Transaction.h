@@ -0,0 +1,96 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#ifndef NODE_SAPNWRFC_TRANSACTION_H_
+#define NODE_SAPNWRFC_TRANSACTION_H_
+
+#include <string>
+#include <vector>
+#include <napi.h>
+#include <sapnwrfc.h>
+#include "addon.h"
+#include "Client.h"
+
+using namespace Napi;
+
+namespace node_rfc
+{
+    // tRFC/qRFC transaction or bgRFC unit, sent in one round trip by submit()
+    class Transaction : public Napi::ObjectWrap<Transaction>
+    {
+    public:
+        friend class TransactionCreateAsync;
+        friend class TransactionAddAsync;
+        friend class TransactionSubmitAsync;
+        friend class TransactionConfirmAsync;
+
+        static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+        void init(void)
+        {
+            client = NULL;
+            unit = false;
+            transactionHandle = NULL;
+            unitHandle = NULL;
+            memsetU((SAP_UTF16 *)tid, 0, sizeof(tid) / sizeof(SAP_UC));
+            memsetU((SAP_UTF16 *)unitIdentifier.unitID, 0, sizeof(unitIdentifier.unitID) / sizeof(SAP_UC));
+            unitIdentifier.unitType = 0;
+            queueNames = NULL;
+            queueNameCount = 0;
+            submitted = false;
+        };
+
+        Transaction(const Napi::CallbackInfo &info);
+        ~Transaction(void);
+
+    private:
+        unsigned int __refId;
+
+        // Transaction API
+
+        Napi::Value IdGetter(const Napi::CallbackInfo &info);
+        Napi::Value TidGetter(const Napi::CallbackInfo &info);
+        Napi::Value TypeGetter(const Napi::CallbackInfo &info);
+        Napi::Value QueueGetter(const Napi::CallbackInfo &info);
+
+        Napi::Value Create(const Napi::CallbackInfo &info);
+        Napi::Value Add(const Napi::CallbackInfo &info);
+        Napi::Value Submit(const Napi::CallbackInfo &info);
+        Napi::Value Confirm(const Napi::CallbackInfo &info);
+        Napi::Value Destroy(const Napi::CallbackInfo &info);
+
+        bool created(void);
+        void destroyHandle(void);
+        RFC_RC invokeIn(RFC_FUNCTION_HANDLE functionHandle, RFC_ERROR_INFO *errorInfo);
+
+        Client *client;
+        Napi::ObjectReference clientRef;
+
+        // bgRFC unit, otherwise tRFC (no queue) or qRFC
+        bool unit;
+        bool submitted;
+
+        // SAP NW RFC SDK
+        RFC_TRANSACTION_HANDLE transactionHandle;
+        RFC_TID tid;
+        RFC_UNIT_HANDLE unitHandle;
+        RFC_UNIT_IDENTIFIER unitIdentifier;
+        const SAP_UC **queueNames;
+        unsigned int queueNameCount;
+        std::vector<std::string> queues;
+    };
+
+} // namespace node_rfc
+
+#endif // NODE_SAPNWRFC_TRANSACTION_H_
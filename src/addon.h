@@ -0,0 +1,44 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#ifndef NODE_SAPNWRFC_ADDON_H_
+#define NODE_SAPNWRFC_ADDON_H_
+
+#include <napi.h>
+
+namespace node_rfc
+{
+    // Per-environment addon state, one instance for the main thread and for each worker thread
+    typedef struct _AddonData
+    {
+        Napi::FunctionReference clientConstructor;
+        Napi::FunctionReference throughputConstructor;
+        Napi::FunctionReference serverConstructor;
+        Napi::FunctionReference transactionConstructor;
+        Napi::FunctionReference cacheConstructor;
+
+        unsigned int clientRefCounter;
+        unsigned int throughputRefCounter;
+        unsigned int serverRefCounter;
+        unsigned int transactionRefCounter;
+    } AddonData;
+
+    inline AddonData *addonData(Napi::Env env)
+    {
+        return env.GetInstanceData<AddonData>();
+    }
+
+} // namespace node_rfc
+
+#endif // NODE_SAPNWRFC_ADDON_H_
@@ -0,0 +1,832 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Client.h"
+#include "noderfcsdk.h"
+
+namespace node_rfc
+{
+    ////////////////////////////////////////////////////////////////////////////////
+    // Arrow IPC stream, built from table handle on the worker thread
+    //
+    // stream:  schema, dictionary batches, record batch, end-of-stream marker
+    // message: continuation 0xFFFFFFFF, metadata length, Message flatbuffer, body
+    //
+    // Flatbuffers and body written in host byte order, little-endian expected
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // Message.fbs and Schema.fbs ids
+    enum ArrowMessageHeader
+    {
+        ARROW_SCHEMA = 1,
+        ARROW_DICTIONARY_BATCH = 2,
+        ARROW_RECORD_BATCH = 3
+    };
+
+    enum ArrowType
+    {
+        ARROW_INT = 2,
+        ARROW_FLOATING_POINT = 3,
+        ARROW_BINARY = 4,
+        ARROW_UTF8 = 5,
+        ARROW_DECIMAL = 7,
+        ARROW_DATE = 8,
+        ARROW_TIME = 9
+    };
+
+    static const int16_t ARROW_METADATA_V5 = 4;
+    static const int16_t ARROW_PRECISION_DOUBLE = 2;
+    static const int16_t ARROW_DATE_DAY = 0;
+    static const int16_t ARROW_TIME_SECOND = 0;
+
+    // Minimal flatbuffer builder, built back to front like the reference
+    // implementation; offsets are counted from the buffer end
+    class FlatBuilder
+    {
+    public:
+        typedef uint32_t Offset;
+
+        Offset offset(void)
+        {
+            return buffer.size();
+        }
+
+        template <typename T>
+        void prepend(T value)
+        {
+            align(sizeof(T), sizeof(T));
+            buffer.insert(0, (const char *)&value, sizeof(T));
+        }
+
+        void prependOffset(Offset target)
+        {
+            align(4, 4);
+            uint32_t relative = buffer.size() + 4 - target;
+            buffer.insert(0, (const char *)&relative, 4);
+        }
+
+        Offset createString(const std::string &value)
+        {
+            align(value.size() + 1, 4);
+            buffer.insert(0, 1, '\0');
+            buffer.insert(0, value);
+            prepend<uint32_t>(value.size());
+            return offset();
+        }
+
+        Offset createOffsetVector(const std::vector<Offset> &elements)
+        {
+            for (size_t i = elements.size(); i-- > 0;)
+            {
+                prependOffset(elements[i]);
+            }
+            prepend<uint32_t>(elements.size());
+            return offset();
+        }
+
+        // vector of structs with int64 members only: FieldNode, Buffer
+        Offset createStructVector(const std::vector<int64_t> &values, unsigned int membersPerStruct)
+        {
+            align(values.size() * 8 + 4, 8);
+            for (size_t i = values.size(); i-- > 0;)
+            {
+                buffer.insert(0, (const char *)&values[i], 8);
+            }
+            prepend<uint32_t>(values.size() / membersPerStruct);
+            return offset();
+        }
+
+        void startTable(void)
+        {
+            fields.clear();
+            tableEnd = offset();
+        }
+
+        template <typename T>
+        void addScalar(uint16_t field, T value)
+        {
+            prepend<T>(value);
+            fields.push_back(std::make_pair(field, offset()));
+        }
+
+        void addOffset(uint16_t field, Offset target)
+        {
+            prependOffset(target);
+            fields.push_back(std::make_pair(field, offset()));
+        }
+
+        // vtable placed right before the table, soffset is the vtable size
+        Offset endTable(void)
+        {
+            uint16_t fieldCount = 0;
+            for (size_t i = 0; i < fields.size(); i++)
+            {
+                if (fields[i].first + 1 > fieldCount)
+                {
+                    fieldCount = fields[i].first + 1;
+                }
+            }
+            uint16_t vtableSize = 4 + 2 * fieldCount;
+            prepend<int32_t>(vtableSize);
+            Offset table = offset();
+
+            std::vector<uint16_t> vtable(fieldCount, 0);
+            for (size_t i = 0; i < fields.size(); i++)
+            {
+                vtable[fields[i].first] = table - fields[i].second;
+            }
+            for (size_t i = fieldCount; i-- > 0;)
+            {
+                prepend<uint16_t>(vtable[i]);
+            }
+            prepend<uint16_t>(table - tableEnd);
+            prepend<uint16_t>(vtableSize);
+            return table;
+        }
+
+        // root offset, total size a multiple of 8 for the IPC framing
+        std::string &finish(Offset root)
+        {
+            align(4, 8);
+            prependOffset(root);
+            return buffer;
+        }
+
+    private:
+        void align(size_t size, size_t alignment)
+        {
+            buffer.insert(0, (alignment - (buffer.size() + size) % alignment) % alignment, '\0');
+        }
+
+        std::string buffer;
+        std::vector<std::pair<uint16_t, Offset> > fields;
+        Offset tableEnd;
+    };
+
+    // Record batch body, buffers 8 byte aligned
+    class ArrowBody
+    {
+    public:
+        void add(const std::string &data)
+        {
+            buffers.push_back(body.size());
+            buffers.push_back(data.size());
+            body += data;
+            body.append((8 - body.size() % 8) % 8, '\0');
+        }
+
+        std::string body;
+        std::vector<int64_t> buffers;
+    };
+
+    class ArrowColumn
+    {
+    public:
+        ArrowColumn(unsigned int index, RFC_FIELD_DESC &fieldDesc, bool dictionary)
+            : index(index), rfcType(fieldDesc.type), nucLength(fieldDesc.nucLength), decimals(fieldDesc.decimals),
+              length(0), nullCount(0), dictionaryCount(0)
+        {
+            this->dictionary = dictionary && (rfcType == RFCTYPE_CHAR || rfcType == RFCTYPE_STRING);
+            int32_t zero = 0;
+            offsets.append((const char *)&zero, 4);
+            dictionaryOffsets.append((const char *)&zero, 4);
+        }
+
+        bool supported(void)
+        {
+            switch (rfcType)
+            {
+            case RFCTYPE_CHAR:
+            case RFCTYPE_NUM:
+            case RFCTYPE_STRING:
+            case RFCTYPE_UTCLONG:
+            case RFCTYPE_BYTE:
+            case RFCTYPE_XSTRING:
+            case RFCTYPE_INT:
+            case RFCTYPE_INT1:
+            case RFCTYPE_INT2:
+            case RFCTYPE_INT8:
+            case RFCTYPE_FLOAT:
+            case RFCTYPE_DECF16:
+            case RFCTYPE_DECF34:
+            case RFCTYPE_BCD:
+            case RFCTYPE_DATE:
+            case RFCTYPE_TIME:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        bool variableLength(void)
+        {
+            return !dictionary && (arrowType() == ARROW_UTF8 || arrowType() == ARROW_BINARY);
+        }
+
+        int arrowType(void)
+        {
+            switch (rfcType)
+            {
+            case RFCTYPE_BYTE:
+            case RFCTYPE_XSTRING:
+                return ARROW_BINARY;
+            case RFCTYPE_INT:
+            case RFCTYPE_INT1:
+            case RFCTYPE_INT2:
+            case RFCTYPE_INT8:
+                return ARROW_INT;
+            case RFCTYPE_FLOAT:
+            case RFCTYPE_DECF16:
+            case RFCTYPE_DECF34:
+                return ARROW_FLOATING_POINT;
+            case RFCTYPE_BCD:
+                return ARROW_DECIMAL;
+            case RFCTYPE_DATE:
+                return ARROW_DATE;
+            case RFCTYPE_TIME:
+                return ARROW_TIME;
+            default:
+                return ARROW_UTF8;
+            }
+        }
+
+        void appendValidity(bool valid)
+        {
+            if (length % 8 == 0)
+            {
+                validity += '\0';
+            }
+            if (valid)
+            {
+                validity[length / 8] |= (char)(1 << (length % 8));
+            }
+            else
+            {
+                nullCount++;
+            }
+            length++;
+        }
+
+        void appendFixed(const void *value, size_t size)
+        {
+            appendValidity(true);
+            data.append((const char *)value, size);
+        }
+
+        void appendNull(size_t size)
+        {
+            appendValidity(false);
+            data.append(size, '\0');
+        }
+
+        void appendVariable(const char *value, size_t size)
+        {
+            if (dictionary)
+            {
+                std::string key(value, size);
+                std::unordered_map<std::string, int32_t>::iterator it = dictionaryIndex.find(key);
+                int32_t id;
+                if (it == dictionaryIndex.end())
+                {
+                    id = dictionaryCount++;
+                    dictionaryIndex[key] = id;
+                    dictionaryData += key;
+                    int32_t end = dictionaryData.size();
+                    dictionaryOffsets.append((const char *)&end, 4);
+                }
+                else
+                {
+                    id = it->second;
+                }
+                appendFixed(&id, 4);
+                return;
+            }
+            appendValidity(true);
+            data.append(value, size);
+            int32_t end = data.size();
+            offsets.append((const char *)&end, 4);
+        }
+
+        unsigned int index;
+        RFCTYPE rfcType;
+        unsigned int nucLength;
+        unsigned int decimals;
+        bool dictionary;
+        std::string name;
+
+        int64_t length;
+        int64_t nullCount;
+        std::string validity;
+        std::string offsets;
+        std::string data;
+
+        int32_t dictionaryCount;
+        std::unordered_map<std::string, int32_t> dictionaryIndex;
+        std::string dictionaryOffsets;
+        std::string dictionaryData;
+    };
+
+    // (hi, lo) = (hi, lo) * 10 + digit
+    static void multiply10(uint64_t *hi, uint64_t *lo, unsigned int digit)
+    {
+        uint64_t low = (*lo & 0xFFFFFFFF) * 10 + digit;
+        uint64_t high = (*lo >> 32) * 10 + (low >> 32);
+        *lo = (high << 32) | (low & 0xFFFFFFFF);
+        *hi = *hi * 10 + (high >> 32);
+    }
+
+    // unscaled decimal digits, little-endian two's complement int128
+    static void decimal128(const std::string &text, unsigned int scale, char *out)
+    {
+        uint64_t lo = 0, hi = 0;
+        bool negative = false, fraction = false;
+        unsigned int fractionDigits = 0;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            char c = text[i];
+            if (c == '-')
+            {
+                negative = true;
+            }
+            else if (c == '.')
+            {
+                fraction = true;
+            }
+            else if (c >= '0' && c <= '9' && (!fraction || fractionDigits++ < scale))
+            {
+                multiply10(&hi, &lo, c - '0');
+            }
+        }
+        for (; fractionDigits < scale; fractionDigits++)
+        {
+            multiply10(&hi, &lo, 0);
+        }
+        if (negative)
+        {
+            lo = ~lo + 1;
+            hi = ~hi + (lo == 0 ? 1 : 0);
+        }
+        memcpy(out, &lo, 8);
+        memcpy(out + 8, &hi, 8);
+    }
+
+    static bool digits(const SAP_UC *value, unsigned int count, int *result)
+    {
+        *result = 0;
+        for (unsigned int i = 0; i < count; i++)
+        {
+            if (value[i] < '0' || value[i] > '9')
+            {
+                return false;
+            }
+            *result = *result * 10 + (value[i] - '0');
+        }
+        return true;
+    }
+
+    // days since epoch, initial or invalid date as null
+    static bool date32(const RFC_DATE value, int32_t *days)
+    {
+        int y, m, d;
+        if (!digits(value, 4, &y) || !digits(value + 4, 2, &m) || !digits(value + 6, 2, &d) ||
+            y == 0 || m < 1 || m > 12 || d < 1 || d > 31)
+        {
+            return false;
+        }
+        y -= m <= 2;
+        int era = (y >= 0 ? y : y - 399) / 400;
+        int yoe = y - era * 400;
+        int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        *days = era * 146097 + doe - 719468;
+        return true;
+    }
+
+    static bool time32(const RFC_TIME value, int32_t *seconds)
+    {
+        int h, m, s;
+        if (!digits(value, 2, &h) || !digits(value + 2, 2, &m) || !digits(value + 4, 2, &s))
+        {
+            return false;
+        }
+        *seconds = h * 3600 + m * 60 + s;
+        return true;
+    }
+
+    static bool arrowAppend(ArrowColumn &column, RFC_STRUCTURE_HANDLE row, std::vector<SAP_UC> &sapuc, std::string &utf8, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_RC rc = RFC_OK;
+        unsigned int index = column.index;
+        switch (column.rfcType)
+        {
+        case RFCTYPE_CHAR:
+        case RFCTYPE_NUM:
+        {
+            sapuc.resize(column.nucLength + 1);
+            if (column.rfcType == RFCTYPE_CHAR)
+            {
+                rc = RfcGetCharsByIndex(row, index, &sapuc[0], column.nucLength, errorInfo);
+            }
+            else
+            {
+                rc = RfcGetNumByIndex(row, index, &sapuc[0], column.nucLength, errorInfo);
+            }
+            if (rc != RFC_OK || !utf8String(&sapuc[0], column.nucLength, utf8, errorInfo))
+            {
+                return false;
+            }
+            column.appendVariable(utf8.data(), utf8.size());
+            break;
+        }
+        case RFCTYPE_STRING:
+        case RFCTYPE_UTCLONG:
+        {
+            unsigned int strLen = 27, resultLen = 0;
+            if (column.rfcType == RFCTYPE_STRING && RfcGetStringLengthByIndex(row, index, &strLen, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            sapuc.resize(strLen + 1);
+            if (RfcGetStringByIndex(row, index, &sapuc[0], strLen + 1, &resultLen, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            if (column.rfcType == RFCTYPE_UTCLONG)
+            {
+                // like wrapVariable()
+                sapuc[19] = '.';
+            }
+            if (!utf8String(&sapuc[0], strLen, utf8, errorInfo))
+            {
+                return false;
+            }
+            column.appendVariable(utf8.data(), utf8.size());
+            break;
+        }
+        case RFCTYPE_BYTE:
+        {
+            utf8.resize(column.nucLength);
+            if (RfcGetBytesByIndex(row, index, (SAP_RAW *)&utf8[0], column.nucLength, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            column.appendVariable(utf8.data(), utf8.size());
+            break;
+        }
+        case RFCTYPE_XSTRING:
+        {
+            unsigned int strLen = 0, resultLen = 0;
+            if (RfcGetStringLengthByIndex(row, index, &strLen, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            utf8.resize(strLen + 1);
+            if (RfcGetXStringByIndex(row, index, (SAP_RAW *)&utf8[0], strLen, &resultLen, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            column.appendVariable(utf8.data(), resultLen);
+            break;
+        }
+        case RFCTYPE_INT:
+        {
+            RFC_INT value;
+            rc = RfcGetIntByIndex(row, index, &value, errorInfo);
+            column.appendFixed(&value, 4);
+            break;
+        }
+        case RFCTYPE_INT1:
+        {
+            RFC_INT1 value;
+            rc = RfcGetInt1ByIndex(row, index, &value, errorInfo);
+            column.appendFixed(&value, 1);
+            break;
+        }
+        case RFCTYPE_INT2:
+        {
+            RFC_INT2 value;
+            rc = RfcGetInt2ByIndex(row, index, &value, errorInfo);
+            column.appendFixed(&value, 2);
+            break;
+        }
+        case RFCTYPE_INT8:
+        {
+            RFC_INT8 value;
+            rc = RfcGetInt8ByIndex(row, index, &value, errorInfo);
+            column.appendFixed(&value, 8);
+            break;
+        }
+        case RFCTYPE_FLOAT:
+        {
+            RFC_FLOAT value;
+            rc = RfcGetFloatByIndex(row, index, &value, errorInfo);
+            column.appendFixed(&value, 8);
+            break;
+        }
+        case RFCTYPE_BCD:
+        case RFCTYPE_DECF16:
+        case RFCTYPE_DECF34:
+        {
+            // string representation upper bound, see wrapVariable()
+            unsigned int resultLen = 0;
+            unsigned int strLen = 2 * column.nucLength + 10;
+            sapuc.resize(strLen + 1);
+            rc = RfcGetStringByIndex(row, index, &sapuc[0], strLen + 1, &resultLen, errorInfo);
+            if (rc == RFC_BUFFER_TOO_SMALL)
+            {
+                sapuc.resize(resultLen + 1);
+                rc = RfcGetStringByIndex(row, index, &sapuc[0], resultLen + 1, &resultLen, errorInfo);
+            }
+            if (rc != RFC_OK || !utf8String(&sapuc[0], resultLen, utf8, errorInfo))
+            {
+                return false;
+            }
+            if (column.rfcType == RFCTYPE_BCD)
+            {
+                char value[16];
+                decimal128(utf8, column.decimals, value);
+                column.appendFixed(value, 16);
+            }
+            else
+            {
+                double value = strtod(utf8.c_str(), NULL);
+                column.appendFixed(&value, 8);
+            }
+            break;
+        }
+        case RFCTYPE_DATE:
+        {
+            RFC_DATE value;
+            int32_t days;
+            rc = RfcGetDateByIndex(row, index, value, errorInfo);
+            if (rc == RFC_OK && date32(value, &days))
+            {
+                column.appendFixed(&days, 4);
+            }
+            else
+            {
+                column.appendNull(4);
+            }
+            break;
+        }
+        case RFCTYPE_TIME:
+        {
+            RFC_TIME value;
+            int32_t seconds;
+            rc = RfcGetTimeByIndex(row, index, value, errorInfo);
+            if (rc == RFC_OK && time32(value, &seconds))
+            {
+                column.appendFixed(&seconds, 4);
+            }
+            else
+            {
+                column.appendNull(4);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+        return rc == RFC_OK;
+    }
+
+    static FlatBuilder::Offset arrowIntType(FlatBuilder &builder, int32_t bitWidth, bool isSigned)
+    {
+        builder.startTable();
+        builder.addScalar<int32_t>(0, bitWidth);
+        builder.addScalar<uint8_t>(1, isSigned ? 1 : 0);
+        return builder.endTable();
+    }
+
+    static FlatBuilder::Offset arrowField(FlatBuilder &builder, ArrowColumn &column, int64_t dictionaryId)
+    {
+        FlatBuilder::Offset type, dictionary = 0;
+
+        switch (column.arrowType())
+        {
+        case ARROW_INT:
+            switch (column.rfcType)
+            {
+            case RFCTYPE_INT1:
+                type = arrowIntType(builder, 8, false);
+                break;
+            case RFCTYPE_INT2:
+                type = arrowIntType(builder, 16, true);
+                break;
+            case RFCTYPE_INT8:
+                type = arrowIntType(builder, 64, true);
+                break;
+            default:
+                type = arrowIntType(builder, 32, true);
+            }
+            break;
+        case ARROW_FLOATING_POINT:
+            builder.startTable();
+            builder.addScalar<int16_t>(0, ARROW_PRECISION_DOUBLE);
+            type = builder.endTable();
+            break;
+        case ARROW_DECIMAL:
+            // BCD packed, two digits per byte, sign in last half-byte
+            builder.startTable();
+            builder.addScalar<int32_t>(0, 2 * column.nucLength - 1);
+            builder.addScalar<int32_t>(1, column.decimals);
+            builder.addScalar<int32_t>(2, 128);
+            type = builder.endTable();
+            break;
+        case ARROW_DATE:
+            builder.startTable();
+            builder.addScalar<int16_t>(0, ARROW_DATE_DAY);
+            type = builder.endTable();
+            break;
+        case ARROW_TIME:
+            builder.startTable();
+            builder.addScalar<int16_t>(0, ARROW_TIME_SECOND);
+            builder.addScalar<int32_t>(1, 32);
+            type = builder.endTable();
+            break;
+        default:
+            // Utf8 and Binary have no members
+            builder.startTable();
+            type = builder.endTable();
+        }
+
+        if (column.dictionary)
+        {
+            FlatBuilder::Offset indexType = arrowIntType(builder, 32, true);
+            builder.startTable();
+            builder.addScalar<int64_t>(0, dictionaryId);
+            builder.addOffset(1, indexType);
+            dictionary = builder.endTable();
+        }
+
+        FlatBuilder::Offset children = builder.createOffsetVector(std::vector<FlatBuilder::Offset>());
+        FlatBuilder::Offset name = builder.createString(column.name);
+
+        builder.startTable();
+        builder.addOffset(0, name);
+        builder.addScalar<uint8_t>(1, 1); // nullable
+        builder.addScalar<uint8_t>(2, (uint8_t)column.arrowType());
+        builder.addOffset(3, type);
+        if (column.dictionary)
+        {
+            builder.addOffset(4, dictionary);
+        }
+        builder.addOffset(5, children);
+        return builder.endTable();
+    }
+
+    static FlatBuilder::Offset arrowRecordBatch(FlatBuilder &builder, int64_t length, const std::vector<int64_t> &nodes, const std::vector<int64_t> &buffers)
+    {
+        FlatBuilder::Offset nodesVector = builder.createStructVector(nodes, 2);
+        FlatBuilder::Offset buffersVector = builder.createStructVector(buffers, 2);
+        builder.startTable();
+        builder.addScalar<int64_t>(0, length);
+        builder.addOffset(1, nodesVector);
+        builder.addOffset(2, buffersVector);
+        return builder.endTable();
+    }
+
+    static void arrowMessage(std::string &stream, FlatBuilder &builder, uint8_t headerType, FlatBuilder::Offset header, const std::string &body)
+    {
+        builder.startTable();
+        builder.addScalar<int64_t>(3, body.size());
+        builder.addOffset(2, header);
+        builder.addScalar<int16_t>(0, ARROW_METADATA_V5);
+        builder.addScalar<uint8_t>(1, headerType);
+        std::string &metadata = builder.finish(builder.endTable());
+
+        uint32_t continuation = 0xFFFFFFFF;
+        int32_t metadataLength = metadata.size();
+        stream.append((const char *)&continuation, 4);
+        stream.append((const char *)&metadataLength, 4);
+        stream += metadata;
+        stream += body;
+    }
+
+    bool Client::arrowTable(RFC_TABLE_HANDLE tableHandle, RFC_TYPE_DESC_HANDLE typeDesc, bool dictionary, std::string &stream, std::string &errorMessage, RFC_ERROR_INFO *errorInfo)
+    {
+        std::vector<ArrowColumn> columns;
+        RFC_FIELD_DESC fieldDesc;
+        unsigned int fieldCount, rowCount;
+        std::vector<SAP_UC> sapuc;
+        std::string utf8;
+
+        if (RfcGetFieldCount(typeDesc, &fieldCount, errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+        columns.reserve(fieldCount);
+        for (unsigned int i = 0; i < fieldCount; i++)
+        {
+            if (RfcGetFieldDescByIndex(typeDesc, i, &fieldDesc, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            columns.push_back(ArrowColumn(i, fieldDesc, dictionary));
+            if (!utf8String(fieldDesc.name, -1, columns.back().name, errorInfo))
+            {
+                return false;
+            }
+            if (!columns.back().supported())
+            {
+                char err[256];
+                snprintf(err, sizeof(err), "Unsupported RFC type %d for Arrow field %s", fieldDesc.type, columns.back().name.c_str());
+                errorMessage = err;
+                return false;
+            }
+        }
+
+        if (RfcGetRowCount(tableHandle, &rowCount, errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+        for (unsigned int row = 0; row < rowCount; row++)
+        {
+            RfcMoveTo(tableHandle, row, NULL);
+            for (unsigned int i = 0; i < fieldCount; i++)
+            {
+                if (!arrowAppend(columns[i], tableHandle, sapuc, utf8, errorInfo))
+                {
+                    return false;
+                }
+            }
+        }
+
+        // schema
+        {
+            FlatBuilder builder;
+            std::vector<FlatBuilder::Offset> fields;
+            for (unsigned int i = 0; i < fieldCount; i++)
+            {
+                fields.push_back(arrowField(builder, columns[i], i));
+            }
+            FlatBuilder::Offset fieldsVector = builder.createOffsetVector(fields);
+            builder.startTable();
+            builder.addOffset(1, fieldsVector);
+            arrowMessage(stream, builder, ARROW_SCHEMA, builder.endTable(), std::string());
+        }
+
+        // dictionaries, dictionary id is the field index
+        for (unsigned int i = 0; i < fieldCount; i++)
+        {
+            if (!columns[i].dictionary)
+            {
+                continue;
+            }
+            FlatBuilder builder;
+            ArrowBody body;
+            std::vector<int64_t> nodes;
+            nodes.push_back(columns[i].dictionaryCount);
+            nodes.push_back(0);
+            body.add(std::string());
+            body.add(columns[i].dictionaryOffsets);
+            body.add(columns[i].dictionaryData);
+            FlatBuilder::Offset data = arrowRecordBatch(builder, columns[i].dictionaryCount, nodes, body.buffers);
+            builder.startTable();
+            builder.addScalar<int64_t>(0, i);
+            builder.addOffset(1, data);
+            arrowMessage(stream, builder, ARROW_DICTIONARY_BATCH, builder.endTable(), body.body);
+        }
+
+        // record batch
+        {
+            FlatBuilder builder;
+            ArrowBody body;
+            std::vector<int64_t> nodes;
+            for (unsigned int i = 0; i < fieldCount; i++)
+            {
+                nodes.push_back(columns[i].length);
+                nodes.push_back(columns[i].nullCount);
+                body.add(columns[i].nullCount > 0 ? columns[i].validity : std::string());
+                if (columns[i].variableLength())
+                {
+                    body.add(columns[i].offsets);
+                }
+                body.add(columns[i].data);
+            }
+            FlatBuilder::Offset batch = arrowRecordBatch(builder, rowCount, nodes, body.buffers);
+            arrowMessage(stream, builder, ARROW_RECORD_BATCH, batch, body.body);
+        }
+
+        // end-of-stream
+        uint64_t endOfStream = 0xFFFFFFFF;
+        stream.append((const char *)&endOfStream, 8);
+        return true;
+    }
+
+} // namespace node_rfc
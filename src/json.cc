@@ -0,0 +1,1107 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "Client.h"
+#include "noderfcsdk.h"
+
+namespace node_rfc
+{
+    ////////////////////////////////////////////////////////////////////////////////
+    // JSON result, serialized from function handle on the worker thread
+    //
+    // Same conventions as wrapResult() + JSON.stringify(): trailing blanks removed,
+    // BCD as string or number, BYTE and XSTRING as serialized Buffer
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static void jsonEscape(std::string &json, const std::string &utf8)
+    {
+        json += '"';
+        for (std::string::const_iterator it = utf8.begin(); it != utf8.end(); ++it)
+        {
+            unsigned char c = (unsigned char)*it;
+            switch (c)
+            {
+            case '"':
+                json += "\\\"";
+                break;
+            case '\\':
+                json += "\\\\";
+                break;
+            case '\b':
+                json += "\\b";
+                break;
+            case '\f':
+                json += "\\f";
+                break;
+            case '\n':
+                json += "\\n";
+                break;
+            case '\r':
+                json += "\\r";
+                break;
+            case '\t':
+                json += "\\t";
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    char esc[8];
+                    snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    json += esc;
+                }
+                else
+                {
+                    json += (char)c;
+                }
+            }
+        }
+        json += '"';
+    }
+
+    static void jsonNumber(std::string &json, double value)
+    {
+        char num[32];
+        if (!std::isfinite(value))
+        {
+            json += "null";
+            return;
+        }
+        if (value == 0)
+        {
+            json += "0";
+            return;
+        }
+        if (value == std::floor(value) && std::fabs(value) < 1e21)
+        {
+            snprintf(num, sizeof(num), "%.0f", value);
+        }
+        else
+        {
+            // shortest representation reading back the same double
+            for (int precision = 15; precision <= 17; precision++)
+            {
+                snprintf(num, sizeof(num), "%.*g", precision, value);
+                if (strtod(num, NULL) == value)
+                {
+                    break;
+                }
+            }
+            char *exponent = strchr(num, 'e');
+            int power = exponent != NULL ? atoi(exponent + 1) : 0;
+            if (exponent != NULL && power >= -6 && power < 0)
+            {
+                // fixed notation down to 1e-6, like JavaScript: 1.5e-05 as 0.000015
+                std::string digits;
+                for (char *c = num; c < exponent; c++)
+                {
+                    if (*c >= '0' && *c <= '9')
+                    {
+                        digits += *c;
+                    }
+                }
+                if (value < 0)
+                {
+                    json += '-';
+                }
+                json += "0.";
+                json.append((size_t)(-power - 1), '0');
+                json += digits;
+                return;
+            }
+            // exponent without leading zeros, like JavaScript
+            if (exponent != NULL && exponent[2] == '0')
+            {
+                memmove(exponent + 2, exponent + 3, strlen(exponent + 3) + 1);
+            }
+        }
+        json += num;
+    }
+
+    static void jsonBuffer(std::string &json, SAP_RAW *bytes, unsigned int length)
+    {
+        char num[8];
+        json += "{\"type\":\"Buffer\",\"data\":[";
+        for (unsigned int i = 0; i < length; i++)
+        {
+            if (i > 0)
+            {
+                json += ',';
+            }
+            snprintf(num, sizeof(num), "%u", (unsigned int)bytes[i]);
+            json += num;
+        }
+        json += "]}";
+    }
+
+    bool Client::jsonConversions(void)
+    {
+        return __bcd == NODERFC_BCD_FUNCTION || !__dateFromABAP.IsEmpty() || !__timeFromABAP.IsEmpty() ||
+               __bytes == NODERFC_BYTES_HEX || __bytes == NODERFC_BYTES_BASE64;
+    }
+
+    bool Client::jsonResult(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, std::string &json, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_PARAMETER_DESC paramDesc;
+        unsigned int paramCount = 0;
+        std::string name;
+        bool first = true;
+
+        if (RfcGetParameterCount(functionDescHandle, &paramCount, errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+
+        json += '{';
+        for (unsigned int i = 0; i < paramCount; i++)
+        {
+            if (RfcGetParameterDescByIndex(functionDescHandle, i, &paramDesc, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            if (paramDesc.direction == __filter_param_direction)
+            {
+                continue;
+            }
+            if (!utf8String(paramDesc.name, -1, name, errorInfo))
+            {
+                return false;
+            }
+            if (!first)
+            {
+                json += ',';
+            }
+            first = false;
+            jsonEscape(json, name);
+            json += ':';
+            if (!jsonVariable(paramDesc.type, functionHandle, paramDesc.name, paramDesc.nucLength, paramDesc.typeDescHandle, json, errorInfo))
+            {
+                return false;
+            }
+        }
+        json += '}';
+        return true;
+    }
+
+    bool Client::jsonStructure(RFC_TYPE_DESC_HANDLE typeDesc, RFC_STRUCTURE_HANDLE structHandle, std::string &json, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_FIELD_DESC fieldDesc;
+        unsigned int fieldCount;
+        std::string name;
+
+        if (RfcGetFieldCount(typeDesc, &fieldCount, errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+
+        // structure with one unnamed field, wrapped as field value
+        if (fieldCount == 1)
+        {
+            if (RfcGetFieldDescByIndex(typeDesc, 0, &fieldDesc, errorInfo) != RFC_OK ||
+                !utf8String(fieldDesc.name, -1, name, errorInfo))
+            {
+                return false;
+            }
+            if (name.size() == 0)
+            {
+                return jsonVariable(fieldDesc.type, structHandle, fieldDesc.name, fieldDesc.nucLength, fieldDesc.typeDescHandle, json, errorInfo);
+            }
+        }
+
+        json += '{';
+        for (unsigned int i = 0; i < fieldCount; i++)
+        {
+            if (RfcGetFieldDescByIndex(typeDesc, i, &fieldDesc, errorInfo) != RFC_OK ||
+                !utf8String(fieldDesc.name, -1, name, errorInfo))
+            {
+                return false;
+            }
+            if (i > 0)
+            {
+                json += ',';
+            }
+            jsonEscape(json, name);
+            json += ':';
+            if (!jsonVariable(fieldDesc.type, structHandle, fieldDesc.name, fieldDesc.nucLength, fieldDesc.typeDescHandle, json, errorInfo))
+            {
+                return false;
+            }
+        }
+        json += '}';
+        return true;
+    }
+
+    bool Client::jsonVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, unsigned int cLen, RFC_TYPE_DESC_HANDLE typeDesc, std::string &json, RFC_ERROR_INFO *errorInfo)
+    {
+        switch (typ)
+        {
+        case RFCTYPE_STRUCTURE:
+        {
+            RFC_STRUCTURE_HANDLE structHandle;
+            if (RfcGetStructure(functionHandle, cName, &structHandle, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            return jsonStructure(typeDesc, structHandle, json, errorInfo);
+        }
+        case RFCTYPE_TABLE:
+        {
+            RFC_TABLE_HANDLE tableHandle;
+            unsigned int rowCount;
+            if (RfcGetTable(functionHandle, cName, &tableHandle, errorInfo) != RFC_OK ||
+                RfcGetRowCount(tableHandle, &rowCount, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            json += '[';
+            for (unsigned int i = 0; i < rowCount; i++)
+            {
+                RfcMoveTo(tableHandle, i, NULL);
+                if (i > 0)
+                {
+                    json += ',';
+                }
+                if (!jsonStructure(typeDesc, tableHandle, json, errorInfo))
+                {
+                    return false;
+                }
+            }
+            json += ']';
+            return true;
+        }
+        default:
+        {
+            std::string text;
+            int kind;
+            if (!textVariable(typ, functionHandle, cName, cLen, text, &kind, errorInfo))
+            {
+                return false;
+            }
+            if (kind == NODERFC_TEXT_STRING)
+            {
+                jsonEscape(json, text);
+            }
+            else if (kind == NODERFC_TEXT_BYTES)
+            {
+                jsonBuffer(json, (SAP_RAW *)text.data(), text.size());
+            }
+            else
+            {
+                json += text;
+            }
+            return true;
+        }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Elementary value as UTF-8 text, for JSON and CSV writers
+    //
+    // string: trailing blanks removed; number: JSON number format; bytes: raw
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool Client::textVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, unsigned int cLen, std::string &text, int *kind, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_RC rc = RFC_OK;
+        char num[32];
+
+        text.clear();
+        *kind = NODERFC_TEXT_STRING;
+
+        switch (typ)
+        {
+        case RFCTYPE_CHAR:
+        case RFCTYPE_NUM:
+        {
+            RFC_CHAR *charValue = (RFC_CHAR *)mallocU(cLen);
+            if (typ == RFCTYPE_CHAR)
+            {
+                rc = RfcGetChars(functionHandle, cName, charValue, cLen, errorInfo);
+            }
+            else
+            {
+                rc = RfcGetNum(functionHandle, cName, charValue, cLen, errorInfo);
+            }
+            bool converted = rc == RFC_OK && utf8String(charValue, cLen, text, errorInfo);
+            free(charValue);
+            return converted;
+        }
+        case RFCTYPE_STRING:
+        {
+            unsigned int resultLen = 0, strLen = 0;
+            rc = RfcGetStringLength(functionHandle, cName, &strLen, errorInfo);
+            if (rc != RFC_OK)
+            {
+                return false;
+            }
+            SAP_UC *stringValue = (SAP_UC *)mallocU(strLen + 1);
+            rc = RfcGetString(functionHandle, cName, stringValue, strLen + 1, &resultLen, errorInfo);
+            bool converted = rc == RFC_OK && utf8String(stringValue, strLen, text, errorInfo);
+            free(stringValue);
+            return converted;
+        }
+        case RFCTYPE_BYTE:
+        {
+            *kind = NODERFC_TEXT_BYTES;
+            text.resize(cLen);
+            return RfcGetBytes(functionHandle, cName, (SAP_RAW *)&text[0], cLen, errorInfo) == RFC_OK;
+        }
+        case RFCTYPE_XSTRING:
+        {
+            unsigned int strLen = 0, resultLen = 0;
+            *kind = NODERFC_TEXT_BYTES;
+            rc = RfcGetStringLength(functionHandle, cName, &strLen, errorInfo);
+            if (rc != RFC_OK)
+            {
+                return false;
+            }
+            text.resize(strLen + 1);
+            rc = RfcGetXString(functionHandle, cName, (SAP_RAW *)&text[0], strLen, &resultLen, errorInfo);
+            text.resize(resultLen);
+            return rc == RFC_OK;
+        }
+        case RFCTYPE_BCD:
+        case RFCTYPE_DECF16:
+        case RFCTYPE_DECF34:
+        {
+            // string representation upper bound, see wrapVariable()
+            unsigned int resultLen;
+            unsigned int strLen = (typ == RFCTYPE_BCD) ? 2 * cLen + 1 : 2 * cLen + 10;
+            SAP_UC *sapuc = (SAP_UC *)mallocU(strLen + 1);
+            rc = RfcGetString(functionHandle, cName, sapuc, strLen + 1, &resultLen, errorInfo);
+            if (rc == RFC_BUFFER_TOO_SMALL)
+            {
+                free(sapuc);
+                strLen = resultLen;
+                sapuc = (SAP_UC *)mallocU(strLen + 1);
+                rc = RfcGetString(functionHandle, cName, sapuc, strLen + 1, &resultLen, errorInfo);
+            }
+            bool converted = rc == RFC_OK && utf8String(sapuc, resultLen, text, errorInfo);
+            free(sapuc);
+            if (converted && __bcd == NODERFC_BCD_NUMBER)
+            {
+                double value = strtod(text.c_str(), NULL);
+                text.clear();
+                jsonNumber(text, value);
+                *kind = NODERFC_TEXT_NUMBER;
+            }
+            return converted;
+        }
+        case RFCTYPE_FLOAT:
+        {
+            RFC_FLOAT floatValue;
+            *kind = NODERFC_TEXT_NUMBER;
+            rc = RfcGetFloat(functionHandle, cName, &floatValue, errorInfo);
+            jsonNumber(text, floatValue);
+            return rc == RFC_OK;
+        }
+        case RFCTYPE_INT:
+        case RFCTYPE_INT1:
+        case RFCTYPE_INT2:
+        {
+            *kind = NODERFC_TEXT_NUMBER;
+            if (typ == RFCTYPE_INT)
+            {
+                RFC_INT intValue;
+                rc = RfcGetInt(functionHandle, cName, &intValue, errorInfo);
+                snprintf(num, sizeof(num), "%d", (int)intValue);
+            }
+            else if (typ == RFCTYPE_INT1)
+            {
+                RFC_INT1 intValue;
+                rc = RfcGetInt1(functionHandle, cName, &intValue, errorInfo);
+                snprintf(num, sizeof(num), "%d", (int)intValue);
+            }
+            else
+            {
+                RFC_INT2 intValue;
+                rc = RfcGetInt2(functionHandle, cName, &intValue, errorInfo);
+                snprintf(num, sizeof(num), "%d", (int)intValue);
+            }
+            text = num;
+            return rc == RFC_OK;
+        }
+        case RFCTYPE_INT8:
+        {
+            RFC_INT8 intValue;
+            *kind = NODERFC_TEXT_NUMBER;
+            rc = RfcGetInt8(functionHandle, cName, &intValue, errorInfo);
+            jsonNumber(text, (double)intValue);
+            return rc == RFC_OK;
+        }
+        case RFCTYPE_UTCLONG:
+        {
+            unsigned int resultLen = 0, strLen = 27;
+            SAP_UC *stringValue = (SAP_UC *)mallocU(strLen + 1);
+            rc = RfcGetString(functionHandle, cName, stringValue, strLen + 1, &resultLen, errorInfo);
+            bool converted = false;
+            if (rc == RFC_OK)
+            {
+                stringValue[19] = '.';
+                converted = utf8String(stringValue, strLen, text, errorInfo);
+            }
+            free(stringValue);
+            return converted;
+        }
+        case RFCTYPE_DATE:
+        {
+            RFC_DATE dateValue;
+            rc = RfcGetDate(functionHandle, cName, dateValue, errorInfo);
+            return rc == RFC_OK && utf8String(dateValue, 8, text, errorInfo);
+        }
+        case RFCTYPE_TIME:
+        {
+            RFC_TIME timeValue;
+            rc = RfcGetTime(functionHandle, cName, timeValue, errorInfo);
+            return rc == RFC_OK && utf8String(timeValue, 6, text, errorInfo);
+        }
+        default:
+        {
+            // reported like SDK errors, the worker thread has no JS context
+            errorInfo->code = RFC_INVALID_PARAMETER;
+            errorInfo->group = EXTERNAL_RUNTIME_FAILURE;
+            strncpyU(errorInfo->key, cU("RFC_INVALID_PARAMETER"), sizeofU(errorInfo->key));
+            strncpyU(errorInfo->message, cU("Unknown RFC type when serializing"), sizeofU(errorInfo->message));
+            return false;
+        }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // JSON parameters, filled into function handle on the worker thread
+    //
+    // Single pass over UTF-8 input, values written into the function handle
+    // as parsed, by type descriptions, without intermediate document
+    ////////////////////////////////////////////////////////////////////////////////
+
+    class JsonReader
+    {
+    public:
+        JsonReader(const char *data, size_t length, RFC_ERROR_INFO *errorInfo)
+            : errorInfo(errorInfo), begin(data), pos(data), end(data + length)
+        {
+        }
+
+        char peek(void)
+        {
+            while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r'))
+            {
+                pos++;
+            }
+            return pos < end ? *pos : '\0';
+        }
+
+        bool atEnd(void)
+        {
+            return peek() == '\0' && pos == end;
+        }
+
+        bool consume(char c)
+        {
+            if (peek() != c)
+            {
+                return false;
+            }
+            pos++;
+            return true;
+        }
+
+        bool expect(char c)
+        {
+            if (!consume(c))
+            {
+                return syntaxError();
+            }
+            return true;
+        }
+
+        bool getString(std::string &utf8)
+        {
+            utf8.clear();
+            if (!consume('"'))
+            {
+                return syntaxError();
+            }
+            while (pos < end && *pos != '"')
+            {
+                unsigned char c = (unsigned char)*pos++;
+                if (c < 0x20)
+                {
+                    return syntaxError();
+                }
+                if (c != '\\')
+                {
+                    utf8 += (char)c;
+                    continue;
+                }
+                if (pos == end)
+                {
+                    return syntaxError();
+                }
+                switch (*pos++)
+                {
+                case '"':
+                    utf8 += '"';
+                    break;
+                case '\\':
+                    utf8 += '\\';
+                    break;
+                case '/':
+                    utf8 += '/';
+                    break;
+                case 'b':
+                    utf8 += '\b';
+                    break;
+                case 'f':
+                    utf8 += '\f';
+                    break;
+                case 'n':
+                    utf8 += '\n';
+                    break;
+                case 'r':
+                    utf8 += '\r';
+                    break;
+                case 't':
+                    utf8 += '\t';
+                    break;
+                case 'u':
+                {
+                    unsigned int codePoint;
+                    if (!getHex4(&codePoint))
+                    {
+                        return syntaxError();
+                    }
+                    // surrogate pair
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF && end - pos >= 6 && pos[0] == '\\' && pos[1] == 'u')
+                    {
+                        unsigned int low;
+                        pos += 2;
+                        if (!getHex4(&low) || low < 0xDC00 || low > 0xDFFF)
+                        {
+                            return syntaxError();
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    putUtf8(utf8, codePoint);
+                    break;
+                }
+                default:
+                    return syntaxError();
+                }
+            }
+            if (pos == end)
+            {
+                return syntaxError();
+            }
+            pos++;
+            return true;
+        }
+
+        // number token, validated by JSON grammar
+        bool getNumber(std::string &token)
+        {
+            peek();
+            const char *start = pos;
+            if (pos < end && *pos == '-')
+            {
+                pos++;
+            }
+            if (pos < end && *pos == '0')
+            {
+                pos++;
+            }
+            else if (!getDigits())
+            {
+                return syntaxError();
+            }
+            if (pos < end && *pos == '.')
+            {
+                pos++;
+                if (!getDigits())
+                {
+                    return syntaxError();
+                }
+            }
+            if (pos < end && (*pos == 'e' || *pos == 'E'))
+            {
+                pos++;
+                if (pos < end && (*pos == '+' || *pos == '-'))
+                {
+                    pos++;
+                }
+                if (!getDigits())
+                {
+                    return syntaxError();
+                }
+            }
+            token.assign(start, pos - start);
+            return true;
+        }
+
+        bool isNumber(void)
+        {
+            char c = peek();
+            return c == '-' || (c >= '0' && c <= '9');
+        }
+
+        bool syntaxError(void)
+        {
+            char err[256];
+            snprintf(err, sizeof(err), "Invalid JSON parameters at position %u", (unsigned int)(pos - begin));
+            errorMessage = err;
+            return false;
+        }
+
+        bool typeError(const char *format, SAP_UC *cName, RFCTYPE typ)
+        {
+            char err[256];
+            std::string fieldName;
+            utf8String(cName, -1, fieldName, errorInfo);
+            snprintf(err, sizeof(err), format, &fieldName[0], typ);
+            errorMessage = err;
+            return false;
+        }
+
+        std::string errorMessage;
+        RFC_ERROR_INFO *errorInfo;
+
+    private:
+        bool getDigits(void)
+        {
+            const char *start = pos;
+            while (pos < end && *pos >= '0' && *pos <= '9')
+            {
+                pos++;
+            }
+            return pos > start;
+        }
+
+        bool getHex4(unsigned int *value)
+        {
+            *value = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                if (pos == end || !isxdigit((unsigned char)*pos))
+                {
+                    return false;
+                }
+                char c = *pos++;
+                *value = (*value << 4) | (unsigned int)(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+            }
+            return true;
+        }
+
+        static void putUtf8(std::string &utf8, unsigned int codePoint)
+        {
+            if (codePoint < 0x80)
+            {
+                utf8 += (char)codePoint;
+            }
+            else if (codePoint < 0x800)
+            {
+                utf8 += (char)(0xC0 | (codePoint >> 6));
+                utf8 += (char)(0x80 | (codePoint & 0x3F));
+            }
+            else if (codePoint < 0x10000)
+            {
+                utf8 += (char)(0xE0 | (codePoint >> 12));
+                utf8 += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+                utf8 += (char)(0x80 | (codePoint & 0x3F));
+            }
+            else
+            {
+                utf8 += (char)(0xF0 | (codePoint >> 18));
+                utf8 += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+                utf8 += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+                utf8 += (char)(0x80 | (codePoint & 0x3F));
+            }
+        }
+
+        const char *begin;
+        const char *pos;
+        const char *end;
+    };
+
+    // like fillString(), without V8 and reporting conversion errors
+    static SAP_UC *sapucString(const std::string &utf8, RFC_ERROR_INFO *errorInfo)
+    {
+        unsigned int sapucSize = utf8.length() + 1, resultLen = 0;
+        SAP_UC *sapuc = (SAP_UC *)mallocU(sapucSize);
+        memsetU((SAP_UTF16 *)sapuc, 0, sapucSize);
+        if (RfcUTF8ToSAPUC((RFC_BYTE *)utf8.c_str(), utf8.length(), sapuc, &sapucSize, &resultLen, errorInfo) != RFC_OK)
+        {
+            free(sapuc);
+            return NULL;
+        }
+        return sapuc;
+    }
+
+    // Buffer in toJSON() form: {"type":"Buffer","data":[...]}
+    static bool jsonBytes(JsonReader &reader, std::string &bytes)
+    {
+        std::string key, type, number;
+        bytes.clear();
+        if (!reader.expect('{'))
+        {
+            return false;
+        }
+        if (reader.consume('}'))
+        {
+            return false;
+        }
+        do
+        {
+            if (!reader.getString(key) || !reader.expect(':'))
+            {
+                return false;
+            }
+            if (key.compare("type") == 0)
+            {
+                if (!reader.getString(type) || type.compare("Buffer") != 0)
+                {
+                    return false;
+                }
+            }
+            else if (key.compare("data") == 0)
+            {
+                if (!reader.expect('['))
+                {
+                    return false;
+                }
+                if (!reader.consume(']'))
+                {
+                    do
+                    {
+                        if (!reader.isNumber() || !reader.getNumber(number))
+                        {
+                            return false;
+                        }
+                        int byte = atoi(number.c_str());
+                        if (number.find_first_not_of("0123456789") != std::string::npos || byte > 255)
+                        {
+                            return false;
+                        }
+                        bytes += (char)byte;
+                    } while (reader.consume(','));
+                    if (!reader.expect(']'))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                return false;
+            }
+        } while (reader.consume(','));
+        return reader.expect('}') && type.compare("Buffer") == 0;
+    }
+
+    static bool jsonFillVariable(JsonReader &reader, RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, RFC_TYPE_DESC_HANDLE typeDesc);
+
+    static bool jsonFillStructure(JsonReader &reader, RFC_STRUCTURE_HANDLE structHandle, RFC_TYPE_DESC_HANDLE typeDesc)
+    {
+        RFC_FIELD_DESC fieldDesc;
+        std::string name;
+
+        if (!reader.expect('{'))
+        {
+            return false;
+        }
+        if (reader.consume('}'))
+        {
+            return true;
+        }
+        do
+        {
+            if (!reader.getString(name) || !reader.expect(':'))
+            {
+                return false;
+            }
+            SAP_UC *cName = sapucString(name, reader.errorInfo);
+            if (cName == NULL)
+            {
+                return false;
+            }
+            RFC_RC rc = RfcGetFieldDescByName(typeDesc, cName, &fieldDesc, reader.errorInfo);
+            free(cName);
+            if (rc != RFC_OK || !jsonFillVariable(reader, fieldDesc.type, structHandle, fieldDesc.name, fieldDesc.typeDescHandle))
+            {
+                return false;
+            }
+        } while (reader.consume(','));
+        return reader.expect('}');
+    }
+
+    static bool jsonFillVariable(JsonReader &reader, RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, RFC_TYPE_DESC_HANDLE typeDesc)
+    {
+        RFC_RC rc = RFC_OK;
+        RFC_ERROR_INFO *errorInfo = reader.errorInfo;
+        std::string value;
+        SAP_UC *cValue;
+
+        switch (typ)
+        {
+        case RFCTYPE_STRUCTURE:
+        {
+            RFC_STRUCTURE_HANDLE structHandle;
+            rc = RfcGetStructure(functionHandle, cName, &structHandle, errorInfo);
+            if (rc != RFC_OK)
+            {
+                return false;
+            }
+            return jsonFillStructure(reader, structHandle, typeDesc);
+        }
+        case RFCTYPE_TABLE:
+        {
+            RFC_TABLE_HANDLE tableHandle;
+            rc = RfcGetTable(functionHandle, cName, &tableHandle, errorInfo);
+            if (rc != RFC_OK)
+            {
+                return false;
+            }
+            if (reader.peek() != '[')
+            {
+                return reader.typeError("Array expected when filling field %s of type %d", cName, typ);
+            }
+            reader.consume('[');
+            if (reader.consume(']'))
+            {
+                return true;
+            }
+            do
+            {
+                RFC_STRUCTURE_HANDLE structHandle = RfcAppendNewRow(tableHandle, errorInfo);
+                if (structHandle == NULL)
+                {
+                    return false;
+                }
+                if (reader.peek() == '{')
+                {
+                    if (!jsonFillStructure(reader, structHandle, typeDesc))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    // table line of elementary type, one unnamed field
+                    RFC_FIELD_DESC fieldDesc;
+                    if (RfcGetFieldDescByName(typeDesc, cU(""), &fieldDesc, errorInfo) != RFC_OK ||
+                        !jsonFillVariable(reader, fieldDesc.type, structHandle, fieldDesc.name, fieldDesc.typeDescHandle))
+                    {
+                        return false;
+                    }
+                }
+            } while (reader.consume(','));
+            return reader.expect(']');
+        }
+        case RFCTYPE_CHAR:
+        case RFCTYPE_STRING:
+        case RFCTYPE_NUM:
+        case RFCTYPE_UTCLONG:
+        case RFCTYPE_DATE:
+        case RFCTYPE_TIME:
+        {
+            if (reader.peek() != '"')
+            {
+                switch (typ)
+                {
+                case RFCTYPE_UTCLONG:
+                    return reader.typeError("UTCLONG string expected when filling field %s of type %d", cName, typ);
+                case RFCTYPE_DATE:
+                    return reader.typeError("ABAP date format YYYYMMDD expected when filling field %s of type %d", cName, typ);
+                case RFCTYPE_TIME:
+                    return reader.typeError("ABAP time format HHMMSS expected when filling field %s of type %d", cName, typ);
+                default:
+                    return reader.typeError("Char expected when filling field %s of type %d", cName, typ);
+                }
+            }
+            if (!reader.getString(value) || (cValue = sapucString(value, errorInfo)) == NULL)
+            {
+                return false;
+            }
+            switch (typ)
+            {
+            case RFCTYPE_CHAR:
+                rc = RfcSetChars(functionHandle, cName, cValue, strlenU((SAP_UTF16 *)cValue), errorInfo);
+                break;
+            case RFCTYPE_NUM:
+                rc = RfcSetNum(functionHandle, cName, cValue, strlenU((SAP_UTF16 *)cValue), errorInfo);
+                break;
+            case RFCTYPE_DATE:
+                rc = RfcSetDate(functionHandle, cName, cValue, errorInfo);
+                break;
+            case RFCTYPE_TIME:
+                rc = RfcSetTime(functionHandle, cName, cValue, errorInfo);
+                break;
+            default:
+                rc = RfcSetString(functionHandle, cName, cValue, strlenU((SAP_UTF16 *)cValue), errorInfo);
+            }
+            free(cValue);
+            break;
+        }
+        case RFCTYPE_BYTE:
+        case RFCTYPE_XSTRING:
+        {
+            if (reader.peek() != '{' || !jsonBytes(reader, value))
+            {
+                if (reader.errorMessage.empty())
+                {
+                    return reader.typeError("Buffer expected when filling field '%s' of type %d", cName, typ);
+                }
+                return false;
+            }
+            if (typ == RFCTYPE_BYTE)
+            {
+                rc = RfcSetBytes(functionHandle, cName, (SAP_RAW *)value.data(), value.size(), errorInfo);
+            }
+            else
+            {
+                rc = RfcSetXString(functionHandle, cName, (SAP_RAW *)value.data(), value.size(), errorInfo);
+            }
+            break;
+        }
+        case RFCTYPE_BCD:
+        case RFCTYPE_DECF16:
+        case RFCTYPE_DECF34:
+        case RFCTYPE_FLOAT:
+        {
+            // number token passed as is, like number ToString()
+            if (reader.peek() == '"')
+            {
+                if (!reader.getString(value))
+                {
+                    return false;
+                }
+            }
+            else if (reader.isNumber())
+            {
+                if (!reader.getNumber(value))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return reader.typeError("Number, number object or string expected when filling field %s of type %d", cName, typ);
+            }
+            if ((cValue = sapucString(value, errorInfo)) == NULL)
+            {
+                return false;
+            }
+            rc = RfcSetString(functionHandle, cName, cValue, strlenU((SAP_UTF16 *)cValue), errorInfo);
+            free(cValue);
+            break;
+        }
+        case RFCTYPE_INT:
+        case RFCTYPE_INT1:
+        case RFCTYPE_INT2:
+        case RFCTYPE_INT8:
+        {
+            if (!reader.isNumber())
+            {
+                return reader.typeError("Integer number expected when filling field %s of type %d", cName, typ);
+            }
+            if (!reader.getNumber(value))
+            {
+                return false;
+            }
+            // digits parsed exactly, INT8 beyond 2^53 without a double round trip
+            char *numEnd;
+            errno = 0;
+            long long numInt = strtoll(value.c_str(), &numEnd, 10);
+            if (*numEnd != 0)
+            {
+                // fraction or exponent, integral values in the exact double range only
+                double numDouble = strtod(value.c_str(), NULL);
+                if (numDouble != std::floor(numDouble) || std::fabs(numDouble) > 9007199254740992.0)
+                {
+                    return reader.typeError("Integer number expected when filling field %s of type %d", cName, typ);
+                }
+                numInt = (long long)numDouble;
+            }
+            else if (errno == ERANGE)
+            {
+                return reader.typeError("Overflow or other error when filling integer field %s of type %d", cName, typ);
+            }
+            if (typ == RFCTYPE_INT8)
+            {
+                rc = RfcSetInt8(functionHandle, cName, (RFC_INT8)numInt, errorInfo);
+            }
+            else
+            {
+                if (numInt > INT32_MAX || numInt < INT32_MIN ||
+                    (typ == RFCTYPE_INT1 && numInt > UINT8_MAX) ||
+                    (typ == RFCTYPE_INT2 && ((numInt > INT16_MAX) || (numInt < INT16_MIN))))
+                {
+                    return reader.typeError("Overflow or other error when filling integer field %s of type %d", cName, typ);
+                }
+                RFC_INT rfcInt = (RFC_INT)numInt;
+                rc = RfcSetInt(functionHandle, cName, rfcInt, errorInfo);
+            }
+            break;
+        }
+        default:
+            return reader.typeError("Unknown RFC type when filling %s (%d)", cName, typ);
+        }
+        return rc == RFC_OK;
+    }
+
+    bool Client::jsonFill(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, const char *json, size_t length, std::string &errorMessage, RFC_ERROR_INFO *errorInfo)
+    {
+        JsonReader reader(json, length, errorInfo);
+        RFC_PARAMETER_DESC paramDesc;
+        std::string name;
+
+        errorInfo->code = RFC_OK;
+        bool filled = reader.expect('{');
+        if (filled && !reader.consume('}'))
+        {
+            do
+            {
+                if (!reader.getString(name) || !reader.expect(':'))
+                {
+                    filled = false;
+                    break;
+                }
+                SAP_UC *cName = sapucString(name, errorInfo);
+                if (cName == NULL)
+                {
+                    filled = false;
+                    break;
+                }
+                RFC_RC rc = RfcGetParameterDescByName(functionDescHandle, cName, &paramDesc, errorInfo);
+                free(cName);
+                if (rc != RFC_OK || !jsonFillVariable(reader, paramDesc.type, functionHandle, paramDesc.name, paramDesc.typeDescHandle))
+                {
+                    filled = false;
+                    break;
+                }
+            } while (reader.consume(','));
+            filled = filled && reader.expect('}');
+        }
+        if (filled && !reader.atEnd())
+        {
+            filled = reader.syntaxError();
+        }
+        errorMessage = reader.errorMessage;
+        return filled;
+    }
+
+} // namespace node_rfc
@@ -0,0 +1,140 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "Client.h"
+#include "noderfcsdk.h"
+
+namespace node_rfc
+{
+    ////////////////////////////////////////////////////////////////////////////////
+    // Lazy result, parameters decoded on first access
+    //
+    // Result properties are getters, replaced by data properties with the decoded
+    // value. Function handle released when all parameters are decoded, by
+    // releaseResult() or when the result object is collected.
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static void lazyRelease(LazyResult *lazy)
+    {
+        if (lazy->functionHandle != NULL)
+        {
+            RfcDestroyFunction(lazy->functionHandle, NULL);
+            lazy->functionHandle = NULL;
+        }
+        lazy->client.Reset();
+    }
+
+    static void lazyFinalize(napi_env env, void *data, void *hint)
+    {
+        LazyResult *lazy = static_cast<LazyResult *>(data);
+        lazyRelease(lazy);
+        delete lazy;
+    }
+
+    Napi::Value Client::wrapLazy(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, InvokeOptions &options, SAP_UC *skipName)
+    {
+        Napi::EscapableHandleScope scope(Env());
+
+        RFC_PARAMETER_DESC paramDesc;
+        RFC_ERROR_INFO errorInfo;
+        unsigned int paramCount = 0;
+        std::string name;
+
+        LazyResult *lazy = new LazyResult();
+        lazy->functionHandle = functionHandle;
+        lazy->client = Napi::Persistent(Value());
+
+        // Arrow and split tables set by the caller
+        std::vector<std::string> eager(options.arrow);
+        if (!options.split.empty())
+        {
+            eager.push_back(options.split);
+        }
+
+        RfcGetParameterCount(functionDescHandle, &paramCount, NULL);
+        for (unsigned int i = 0; i < paramCount; i++)
+        {
+            RfcGetParameterDescByIndex(functionDescHandle, i, &paramDesc, NULL);
+            if ((skipName != NULL && strcmpU(paramDesc.name, skipName) == 0) || paramDesc.direction == __filter_param_direction)
+            {
+                continue;
+            }
+            if (utf8String(paramDesc.name, -1, name, &errorInfo) && std::find(eager.begin(), eager.end(), name) != eager.end())
+            {
+                continue;
+            }
+            lazy->parameters.push_back(paramDesc);
+        }
+        lazy->pending = (unsigned int)lazy->parameters.size();
+
+        Napi::Object resultObj = Napi::Object::New(Env());
+        std::vector<Napi::PropertyDescriptor> properties;
+        for (size_t i = 0; i < lazy->parameters.size(); i++)
+        {
+            properties.push_back(Napi::PropertyDescriptor::Accessor(
+                Env(), resultObj, wrapString(Env(), lazy->parameters[i].name).As<Napi::String>(),
+                [this, lazy, i](const Napi::CallbackInfo &info) -> Napi::Value {
+                    RFC_PARAMETER_DESC *paramDesc = &lazy->parameters[i];
+                    Napi::Value name = wrapString(info.Env(), paramDesc->name);
+                    if (lazy->functionHandle == NULL)
+                    {
+                        Napi::Error::New(info.Env(), "Result released, parameter not decoded: " + name.ToString().Utf8Value()).ThrowAsJavaScriptException();
+                        return info.Env().Undefined();
+                    }
+                    Napi::Value value = wrapVariable(paramDesc->type, lazy->functionHandle, paramDesc->name, paramDesc->nucLength, paramDesc->typeDescHandle);
+                    info.This().As<Napi::Object>().DefineProperty(
+                        Napi::PropertyDescriptor::Value(name.As<Napi::Name>(), value, static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable)));
+                    if (--lazy->pending == 0)
+                    {
+                        // all decoded, handle not needed anymore
+                        lazyRelease(lazy);
+                    }
+                    return value;
+                },
+                static_cast<napi_property_attributes>(napi_enumerable | napi_configurable)));
+        }
+        if (!properties.empty())
+        {
+            resultObj.DefineProperties(properties);
+        }
+        else
+        {
+            lazyRelease(lazy);
+        }
+
+        napi_status status = napi_wrap(Env(), resultObj, lazy, lazyFinalize, NULL, NULL);
+        if (status != napi_ok)
+        {
+            lazyFinalize(Env(), lazy, NULL);
+            Napi::Error::New(Env()).ThrowAsJavaScriptException();
+        }
+        return scope.Escape(resultObj);
+    }
+
+    Napi::Value Client::ReleaseResult(const Napi::CallbackInfo &info)
+    {
+        void *data = NULL;
+        if (!info[0].IsObject() || napi_unwrap(info.Env(), info[0], &data) != napi_ok || data == NULL)
+        {
+            Napi::TypeError::New(info.Env(), "First argument (lazy result) must be returned by invoke").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        lazyRelease(static_cast<LazyResult *>(data));
+        return info.Env().Undefined();
+    }
+
+} // namespace node_rfc
@@ -30,7 +30,7 @@
 #define THROUGHPUT_CALL(Property, property)                       \
     rc = RfcGet##Property(this->__handle, &property, &errorInfo); \
     if (rc != RFC_OK)                                             \
-        return scope.Escape(wrapError(&errorInfo));               \
+        return scope.Escape(wrapError(info.Env(), &errorInfo));   \
     status.Set(Napi::String::New(info.Env(), #property), Napi::Number::New(info.Env(), static_cast<double>(property)));
 
 #ifdef RFC_CLIENT_LOG
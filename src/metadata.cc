@@ -0,0 +1,592 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "Client.h"
+#include "noderfcsdk.h"
+#include "macros.h"
+
+// maximum string length of a SAP_UC array, without terminating zero
+#define UC_MAX(ucArray) (sizeof(ucArray) / sizeof(SAP_UC) - 1)
+
+namespace node_rfc
+{
+    ////////////////////////////////////////////////////////////////////////////////
+    // Metadata snapshot, binary format in native byte order
+    //
+    // header:    magic, version, sysId, partnerRel
+    // types:     count, [name, nucLength, ucLength, field count, [field]]
+    //            nested types precede the types using them
+    // functions: count, [name, parameter count, [parameter], exception count, [exception]]
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static const char METADATA_MAGIC[8] = {'N', 'R', 'F', 'C', 'M', 'E', 'T', 'A'};
+
+    class MetadataWriter
+    {
+    public:
+        void putInt(uint32_t value)
+        {
+            buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        void putString(const SAP_UC *uc)
+        {
+            uint32_t length = strlenU((SAP_UTF16 *)uc);
+            putInt(length);
+            buffer.append(reinterpret_cast<const char *>(uc), length * sizeof(SAP_UC));
+        }
+
+        void append(const MetadataWriter &writer)
+        {
+            buffer.append(writer.buffer);
+        }
+
+        std::string buffer;
+    };
+
+    class MetadataReader
+    {
+    public:
+        MetadataReader(const std::string &buffer) : pos(buffer.data()), end(buffer.data() + buffer.size()) {}
+
+        bool getBytes(void *dst, size_t size)
+        {
+            if ((size_t)(end - pos) < size)
+                return false;
+            memcpy(dst, pos, size);
+            pos += size;
+            return true;
+        }
+
+        bool getInt(uint32_t *value)
+        {
+            return getBytes(value, sizeof(uint32_t));
+        }
+
+        bool getString(SAP_UC *uc, size_t maxLength)
+        {
+            uint32_t length;
+            if (!getInt(&length) || length > maxLength || !getBytes(uc, length * sizeof(SAP_UC)))
+                return false;
+            uc[length] = 0;
+            return true;
+        }
+
+        bool atEnd()
+        {
+            return pos == end;
+        }
+
+    private:
+        const char *pos;
+        const char *end;
+    };
+
+    static std::string typeKey(const SAP_UC *typeName)
+    {
+        return std::string(reinterpret_cast<const char *>(typeName), strlenU((SAP_UTF16 *)typeName) * sizeof(SAP_UC));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Async workers
+    ////////////////////////////////////////////////////////////////////////////////
+
+    class ExportMetadataAsync : public Napi::AsyncWorker
+    {
+    public:
+        ExportMetadataAsync(Napi::Function &callback, Client *client, Napi::Array rfmNames)
+            : Napi::AsyncWorker(callback), client(client), typeCount(0), functionCount(0)
+        {
+            for (unsigned int i = 0; i < rfmNames.Length(); i++)
+            {
+                funcNames.push_back(client->fillString(rfmNames.Get(i).ToString()));
+            }
+        }
+        ~ExportMetadataAsync() {}
+
+        void Execute()
+        {
+            RFC_ATTRIBUTES attributes;
+            MetadataWriter header, types, functions;
+
+            client->LockMutex();
+            errorInfo.code = RFC_OK;
+
+            if (RfcGetConnectionAttributes(client->connectionHandle, &attributes, &errorInfo) == RFC_OK)
+            {
+                for (unsigned int i = 0; i < funcNames.size(); i++)
+                {
+                    RFC_FUNCTION_DESC_HANDLE functionDescHandle = RfcGetFunctionDesc(client->connectionHandle, funcNames[i], &errorInfo);
+                    if (functionDescHandle == NULL || !writeFunction(functionDescHandle, functions, types))
+                    {
+                        break;
+                    }
+                }
+            }
+
+            for (unsigned int i = 0; i < funcNames.size(); i++)
+            {
+                free(funcNames[i]);
+            }
+
+            if (errorInfo.code != RFC_OK)
+            {
+                return;
+            }
+
+            header.buffer.append(METADATA_MAGIC, sizeof(METADATA_MAGIC));
+            header.putInt(NODERFC_METADATA_VERSION);
+            header.putString(attributes.sysId);
+            header.putString(attributes.partnerRel);
+            header.putInt(typeCount);
+            header.append(types);
+            header.putInt(functionCount);
+            header.append(functions);
+            snapshot.swap(header.buffer);
+        }
+
+        void OnOK()
+        {
+            client->UnlockMutex();
+            Napi::Value argv[2] = {Env().Undefined(), Env().Undefined()};
+            if (errorInfo.code != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &errorInfo);
+            }
+            else
+            {
+                argv[1] = Napi::Buffer<char>::Copy(Env(), snapshot.data(), snapshot.size());
+            }
+            CALLBACK_CALL(Env().Global(), Callback(), 2, argv);
+        }
+
+    private:
+        bool writeTypeName(RFC_TYPE_DESC_HANDLE typeDescHandle, MetadataWriter &writer, MetadataWriter &types)
+        {
+            RFC_ABAP_NAME typeName;
+            typeName[0] = 0;
+            if (typeDescHandle != NULL)
+            {
+                if (!writeType(typeDescHandle, types) || RfcGetTypeName(typeDescHandle, typeName, &errorInfo) != RFC_OK)
+                {
+                    return false;
+                }
+            }
+            writer.putString(typeName);
+            return true;
+        }
+
+        bool writeType(RFC_TYPE_DESC_HANDLE typeDescHandle, MetadataWriter &types)
+        {
+            RFC_ABAP_NAME typeName;
+            RFC_FIELD_DESC fieldDesc;
+            unsigned int fieldCount, nucLength, ucLength;
+            MetadataWriter fields;
+
+            if (RfcGetTypeName(typeDescHandle, typeName, &errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            if (!typeNames.insert(typeKey(typeName)).second)
+            {
+                // already written
+                return true;
+            }
+            if (RfcGetFieldCount(typeDescHandle, &fieldCount, &errorInfo) != RFC_OK ||
+                RfcGetTypeLength(typeDescHandle, &nucLength, &ucLength, &errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+
+            for (unsigned int i = 0; i < fieldCount; i++)
+            {
+                if (RfcGetFieldDescByIndex(typeDescHandle, i, &fieldDesc, &errorInfo) != RFC_OK)
+                {
+                    return false;
+                }
+                fields.putString(fieldDesc.name);
+                fields.putInt(fieldDesc.type);
+                fields.putInt(fieldDesc.nucLength);
+                fields.putInt(fieldDesc.nucOffset);
+                fields.putInt(fieldDesc.ucLength);
+                fields.putInt(fieldDesc.ucOffset);
+                fields.putInt(fieldDesc.decimals);
+                if (!writeTypeName(fieldDesc.typeDescHandle, fields, types))
+                {
+                    return false;
+                }
+            }
+
+            types.putString(typeName);
+            types.putInt(nucLength);
+            types.putInt(ucLength);
+            types.putInt(fieldCount);
+            types.append(fields);
+            typeCount++;
+            return true;
+        }
+
+        bool writeFunction(RFC_FUNCTION_DESC_HANDLE functionDescHandle, MetadataWriter &functions, MetadataWriter &types)
+        {
+            RFC_ABAP_NAME functionName;
+            RFC_PARAMETER_DESC paramDesc;
+            RFC_EXCEPTION_DESC excDesc;
+            unsigned int paramCount, excCount;
+
+            if (RfcGetFunctionName(functionDescHandle, functionName, &errorInfo) != RFC_OK ||
+                RfcGetParameterCount(functionDescHandle, &paramCount, &errorInfo) != RFC_OK ||
+                RfcGetExceptionCount(functionDescHandle, &excCount, &errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+
+            functions.putString(functionName);
+            functions.putInt(paramCount);
+            for (unsigned int i = 0; i < paramCount; i++)
+            {
+                if (RfcGetParameterDescByIndex(functionDescHandle, i, &paramDesc, &errorInfo) != RFC_OK)
+                {
+                    return false;
+                }
+                functions.putString(paramDesc.name);
+                functions.putInt(paramDesc.type);
+                functions.putInt(paramDesc.direction);
+                functions.putInt(paramDesc.nucLength);
+                functions.putInt(paramDesc.ucLength);
+                functions.putInt(paramDesc.decimals);
+                if (!writeTypeName(paramDesc.typeDescHandle, functions, types))
+                {
+                    return false;
+                }
+                functions.putString(paramDesc.defaultValue);
+                functions.putString(paramDesc.parameterText);
+                functions.putInt(paramDesc.optional);
+            }
+
+            functions.putInt(excCount);
+            for (unsigned int i = 0; i < excCount; i++)
+            {
+                if (RfcGetExceptionDescByIndex(functionDescHandle, i, &excDesc, &errorInfo) != RFC_OK)
+                {
+                    return false;
+                }
+                functions.putString(excDesc.key);
+                functions.putString(excDesc.message);
+            }
+
+            functionCount++;
+            return true;
+        }
+
+        Client *client;
+        std::vector<SAP_UC *> funcNames;
+        std::set<std::string> typeNames;
+        uint32_t typeCount;
+        uint32_t functionCount;
+        std::string snapshot;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    class ImportMetadataAsync : public Napi::AsyncWorker
+    {
+    public:
+        ImportMetadataAsync(Napi::Function &callback, Client *client, Napi::Buffer<char> buffer)
+            : Napi::AsyncWorker(callback), client(client), snapshot(buffer.Data(), buffer.Length()), functionCount(0) {}
+        ~ImportMetadataAsync() {}
+
+        void Execute()
+        {
+            RFC_ATTRIBUTES attributes;
+            char magic[sizeof(METADATA_MAGIC)];
+            uint32_t version;
+            SAP_UC sysId[UC_MAX(attributes.sysId) + 1];
+            SAP_UC partnerRel[UC_MAX(attributes.partnerRel) + 1];
+            MetadataReader reader(snapshot);
+
+            client->LockMutex();
+            errorInfo.code = RFC_OK;
+
+            if (RfcGetConnectionAttributes(client->connectionHandle, &attributes, &errorInfo) != RFC_OK)
+            {
+                return;
+            }
+
+            if (!reader.getBytes(magic, sizeof(magic)) || memcmp(magic, METADATA_MAGIC, sizeof(magic)) != 0 ||
+                !reader.getInt(&version) || version != NODERFC_METADATA_VERSION ||
+                !reader.getString(sysId, UC_MAX(sysId)) || !reader.getString(partnerRel, UC_MAX(partnerRel)))
+            {
+                errorMessage = "Invalid metadata snapshot";
+                return;
+            }
+
+            if (strcmpU(sysId, attributes.sysId) != 0 || strcmpU(partnerRel, attributes.partnerRel) != 0)
+            {
+                errorMessage = "Metadata snapshot does not match partner system ID or release";
+                return;
+            }
+
+            // descriptions are added to the repository of the partner system
+            if (readTypes(reader, attributes.sysId) && readFunctions(reader, attributes.sysId) && !reader.atEnd())
+            {
+                errorMessage = "Invalid metadata snapshot";
+            }
+        }
+
+        void OnOK()
+        {
+            client->UnlockMutex();
+            Napi::Value argv[2] = {Env().Undefined(), Env().Undefined()};
+            if (!errorMessage.empty())
+            {
+                argv[0] = Napi::Error::New(Env(), errorMessage).Value();
+            }
+            else if (errorInfo.code != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &errorInfo);
+            }
+            else
+            {
+                argv[1] = Napi::Number::New(Env(), functionCount);
+            }
+            CALLBACK_CALL(Env().Global(), Callback(), 2, argv);
+        }
+
+    private:
+        bool readTypeName(MetadataReader &reader, RFC_TYPE_DESC_HANDLE *typeDescHandle)
+        {
+            RFC_ABAP_NAME typeName;
+            if (!reader.getString(typeName, UC_MAX(typeName)))
+            {
+                return false;
+            }
+            *typeDescHandle = NULL;
+            if (typeName[0] != 0)
+            {
+                std::map<std::string, RFC_TYPE_DESC_HANDLE>::iterator it = typeDescs.find(typeKey(typeName));
+                if (it == typeDescs.end())
+                {
+                    return false;
+                }
+                *typeDescHandle = it->second;
+            }
+            return true;
+        }
+
+        bool readTypes(MetadataReader &reader, const SAP_UC *repositoryId)
+        {
+            uint32_t typeCount, nucLength, ucLength, fieldCount, value;
+            RFC_ABAP_NAME typeName;
+            RFC_FIELD_DESC fieldDesc;
+
+            if (!reader.getInt(&typeCount))
+            {
+                errorMessage = "Invalid metadata snapshot";
+                return false;
+            }
+
+            for (uint32_t i = 0; i < typeCount; i++)
+            {
+                if (!reader.getString(typeName, UC_MAX(typeName)) || !reader.getInt(&nucLength) ||
+                    !reader.getInt(&ucLength) || !reader.getInt(&fieldCount))
+                {
+                    errorMessage = "Invalid metadata snapshot";
+                    return false;
+                }
+
+                RFC_TYPE_DESC_HANDLE typeDescHandle = RfcCreateTypeDesc(typeName, &errorInfo);
+                if (typeDescHandle == NULL)
+                {
+                    return false;
+                }
+
+                for (uint32_t j = 0; j < fieldCount; j++)
+                {
+                    memset(&fieldDesc, 0, sizeof(fieldDesc));
+                    if (!reader.getString(fieldDesc.name, UC_MAX(fieldDesc.name)) || !reader.getInt(&value))
+                    {
+                        errorMessage = "Invalid metadata snapshot";
+                        break;
+                    }
+                    fieldDesc.type = (RFCTYPE)value;
+                    if (!reader.getInt(&fieldDesc.nucLength) || !reader.getInt(&fieldDesc.nucOffset) ||
+                        !reader.getInt(&fieldDesc.ucLength) || !reader.getInt(&fieldDesc.ucOffset) ||
+                        !reader.getInt(&fieldDesc.decimals) || !readTypeName(reader, &fieldDesc.typeDescHandle))
+                    {
+                        errorMessage = "Invalid metadata snapshot";
+                        break;
+                    }
+                    if (RfcAddTypeField(typeDescHandle, &fieldDesc, &errorInfo) != RFC_OK)
+                    {
+                        break;
+                    }
+                }
+
+                if (errorMessage.empty() && errorInfo.code == RFC_OK &&
+                    RfcSetTypeLength(typeDescHandle, nucLength, ucLength, &errorInfo) == RFC_OK &&
+                    RfcAddTypeDesc(repositoryId, typeDescHandle, &errorInfo) == RFC_OK)
+                {
+                    typeDescs[typeKey(typeName)] = typeDescHandle;
+                }
+                else
+                {
+                    RfcDestroyTypeDesc(typeDescHandle, NULL);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool readFunctions(MetadataReader &reader, const SAP_UC *repositoryId)
+        {
+            uint32_t count, paramCount, excCount = 0, value;
+            RFC_ABAP_NAME functionName;
+            RFC_PARAMETER_DESC paramDesc;
+            RFC_EXCEPTION_DESC excDesc;
+
+            if (!reader.getInt(&count))
+            {
+                errorMessage = "Invalid metadata snapshot";
+                return false;
+            }
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (!reader.getString(functionName, UC_MAX(functionName)) || !reader.getInt(&paramCount))
+                {
+                    errorMessage = "Invalid metadata snapshot";
+                    return false;
+                }
+
+                RFC_FUNCTION_DESC_HANDLE functionDescHandle = RfcCreateFunctionDesc(functionName, &errorInfo);
+                if (functionDescHandle == NULL)
+                {
+                    return false;
+                }
+
+                for (uint32_t j = 0; j < paramCount && errorMessage.empty(); j++)
+                {
+                    memset(&paramDesc, 0, sizeof(paramDesc));
+                    if (!reader.getString(paramDesc.name, UC_MAX(paramDesc.name)) || !reader.getInt(&value))
+                    {
+                        errorMessage = "Invalid metadata snapshot";
+                        break;
+                    }
+                    paramDesc.type = (RFCTYPE)value;
+                    if (!reader.getInt(&value))
+                    {
+                        errorMessage = "Invalid metadata snapshot";
+                        break;
+                    }
+                    paramDesc.direction = (RFC_DIRECTION)value;
+                    if (!reader.getInt(&paramDesc.nucLength) || !reader.getInt(&paramDesc.ucLength) ||
+                        !reader.getInt(&paramDesc.decimals) || !readTypeName(reader, &paramDesc.typeDescHandle) ||
+                        !reader.getString(paramDesc.defaultValue, UC_MAX(paramDesc.defaultValue)) ||
+                        !reader.getString(paramDesc.parameterText, UC_MAX(paramDesc.parameterText)) ||
+                        !reader.getInt(&value))
+                    {
+                        errorMessage = "Invalid metadata snapshot";
+                        break;
+                    }
+                    paramDesc.optional = (RFC_BYTE)value;
+                    if (RfcAddParameter(functionDescHandle, &paramDesc, &errorInfo) != RFC_OK)
+                    {
+                        break;
+                    }
+                }
+
+                if (errorMessage.empty() && errorInfo.code == RFC_OK && !reader.getInt(&excCount))
+                {
+                    errorMessage = "Invalid metadata snapshot";
+                }
+
+                for (uint32_t j = 0; j < excCount && errorMessage.empty() && errorInfo.code == RFC_OK; j++)
+                {
+                    memset(&excDesc, 0, sizeof(excDesc));
+                    if (!reader.getString(excDesc.key, UC_MAX(excDesc.key)) || !reader.getString(excDesc.message, UC_MAX(excDesc.message)))
+                    {
+                        errorMessage = "Invalid metadata snapshot";
+                        break;
+                    }
+                    RfcAddException(functionDescHandle, &excDesc, &errorInfo);
+                }
+
+                if (errorMessage.empty() && errorInfo.code == RFC_OK &&
+                    RfcAddFunctionDesc(repositoryId, functionDescHandle, &errorInfo) == RFC_OK)
+                {
+                    functionCount++;
+                }
+                else
+                {
+                    RfcDestroyFunctionDesc(functionDescHandle, NULL);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        Client *client;
+        std::string snapshot;
+        std::string errorMessage;
+        std::map<std::string, RFC_TYPE_DESC_HANDLE> typeDescs;
+        uint32_t functionCount;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Client API
+    ////////////////////////////////////////////////////////////////////////////////
+
+    Napi::Value Client::ExportMetadata(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsArray())
+        {
+            Napi::TypeError::New(info.Env(), "First argument (remote function module names) must be an array").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        if (!info[1].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "Second argument must be callback function").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[1].As<Napi::Function>();
+
+        (new ExportMetadataAsync(callback, this, info[0].As<Napi::Array>()))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Client::ImportMetadata(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsBuffer())
+        {
+            Napi::TypeError::New(info.Env(), "First argument (metadata snapshot) must be a Buffer").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        if (!info[1].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "Second argument must be callback function").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[1].As<Napi::Function>();
+
+        (new ImportMetadataAsync(callback, this, info[0].As<Napi::Buffer<char>>()))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+} // namespace node_rfc
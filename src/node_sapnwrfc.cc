@@ -12,16 +12,26 @@
 // either express or implied. See the License for the specific
 // language governing permissions and limitations under the License.
 
+#include "addon.h"
 #include "Client.h"
 #include "Throughput.h"
+#include "Server.h"
+#include "Transaction.h"
+#include "Cache.h"
 #include "macros.h"
 
 using namespace node_rfc;
 
 Napi::Object RegisterModule(Napi::Env env, Napi::Object exports)
 {
+    // separate constructors and counters for each environment (main and worker threads)
+    env.SetInstanceData(new AddonData());
+
     Client::Init(env, exports);
     Throughput::Init(env, exports);
+    Server::Init(env, exports);
+    Transaction::Init(env, exports);
+    Cache::Init(env, exports);
     return exports;
 }
 
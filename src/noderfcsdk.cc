@@ -16,18 +16,16 @@
 
 namespace node_rfc
 {
-    Napi::Env __env = NULL;
-
     ////////////////////////////////////////////////////////////////////////////////
     // SAP to JS String
     ////////////////////////////////////////////////////////////////////////////////
 
-    Napi::Value wrapString(SAP_UC *uc, int length)
+    Napi::Value wrapString(Napi::Env env, SAP_UC *uc, int length)
     {
         RFC_RC rc;
         RFC_ERROR_INFO errorInfo;
 
-        Napi::EscapableHandleScope scope(node_rfc::__env);
+        Napi::EscapableHandleScope scope(env);
 
         if (length == -1)
         {
@@ -35,7 +33,7 @@ namespace node_rfc
         }
         if (length == 0)
         {
-            return Napi::String::New(node_rfc::__env, "");
+            return Napi::String::New(env, "");
         }
         // try with 3 bytes per unicode character
         unsigned int utf8Size = length * 3;
@@ -69,60 +67,112 @@ namespace node_rfc
         }
         utf8[i + 1] = '\0';
 
-        Napi::Value resultValue = Napi::String::New(node_rfc::__env, utf8);
+        Napi::Value resultValue = Napi::String::New(env, utf8);
         free((char *)utf8);
         return scope.Escape(resultValue);
     }
 
+    // SAP to UTF-8 string, trailing blanks removed like wrapString(), without V8
+    bool utf8String(SAP_UC *uc, int length, std::string &utf8, RFC_ERROR_INFO *errorInfo)
+    {
+        utf8.clear();
+        if (length == -1)
+        {
+            length = strlenU((SAP_UTF16 *)uc);
+        }
+        if (length == 0)
+        {
+            return true;
+        }
+        // try with 3 bytes per unicode character, 6 if not enough
+        unsigned int utf8Size = length * 3;
+        unsigned int resultLen = 0;
+        utf8.resize(utf8Size + 1);
+        if (RfcSAPUCToUTF8(uc, length, (RFC_BYTE *)&utf8[0], &utf8Size, &resultLen, errorInfo) != RFC_OK)
+        {
+            utf8Size = length * 6;
+            resultLen = 0;
+            utf8.resize(utf8Size + 1);
+            if (RfcSAPUCToUTF8(uc, length, (RFC_BYTE *)&utf8[0], &utf8Size, &resultLen, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+        }
+        utf8.resize(strlen(utf8.c_str()));
+        while (!utf8.empty() && isspace((unsigned char)utf8[utf8.size() - 1]))
+        {
+            utf8.erase(utf8.size() - 1);
+        }
+        return true;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////
     // RFC ERRORS
     ////////////////////////////////////////////////////////////////////////////////
 
-    Napi::Value NodeRfcError(Napi::Value errorObj)
+    Napi::Value NodeRfcError(Napi::Env env, Napi::Value errorObj)
     {
-        Napi::EscapableHandleScope scope(node_rfc::__env);
+        Napi::EscapableHandleScope scope(env);
         return scope.Escape(errorObj);
     }
 
-    Napi::Value RfcLibError(RFC_ERROR_INFO *errorInfo, bool alive)
+    Napi::Value RfcLibError(Napi::Env env, RFC_ERROR_INFO *errorInfo, bool alive)
     {
-        Napi::EscapableHandleScope scope(node_rfc::__env);
-
-        Napi::Object errorObj = Napi::Object::New(node_rfc::__env);
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "alive"), Napi::Boolean::New(node_rfc::__env, alive));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "name"), "RfcLibError");
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "code"), Napi::Number::New(node_rfc::__env, errorInfo->code));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "codeString"), wrapString((SAP_UC *)RfcGetRcAsString(errorInfo->code)));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "key"), wrapString(errorInfo->key));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "message"), wrapString(errorInfo->message));
+        Napi::EscapableHandleScope scope(env);
+
+        Napi::Object errorObj = Napi::Object::New(env);
+        (errorObj).Set(Napi::String::New(env, "alive"), Napi::Boolean::New(env, alive));
+        (errorObj).Set(Napi::String::New(env, "name"), "RfcLibError");
+        (errorObj).Set(Napi::String::New(env, "code"), Napi::Number::New(env, errorInfo->code));
+        (errorObj).Set(Napi::String::New(env, "codeString"), wrapString(env, (SAP_UC *)RfcGetRcAsString(errorInfo->code)));
+        (errorObj).Set(Napi::String::New(env, "key"), wrapString(env, errorInfo->key));
+        (errorObj).Set(Napi::String::New(env, "message"), wrapString(env, errorInfo->message));
         return scope.Escape(errorObj);
     }
 
-    Napi::Value AbapError(RFC_ERROR_INFO *errorInfo, bool alive)
+    Napi::Value AbapError(Napi::Env env, RFC_ERROR_INFO *errorInfo, bool alive)
     {
-        Napi::EscapableHandleScope scope(node_rfc::__env);
-
-        Napi::Object errorObj = Napi::Object::New(node_rfc::__env);
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "alive"), Napi::Boolean::New(node_rfc::__env, alive));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "name"), "ABAPError");
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "code"), Napi::Number::New(node_rfc::__env, errorInfo->code));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "codeString"), wrapString((SAP_UC *)RfcGetRcAsString(errorInfo->code)));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "key"), wrapString(errorInfo->key));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "message"), wrapString(errorInfo->message));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "abapMsgClass"), wrapString(errorInfo->abapMsgClass));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "abapMsgType"), wrapString(errorInfo->abapMsgType));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "abapMsgNumber"), wrapString(errorInfo->abapMsgNumber));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "abapMsgV1"), wrapString(errorInfo->abapMsgV1));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "abapMsgV2"), wrapString(errorInfo->abapMsgV2));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "abapMsgV3"), wrapString(errorInfo->abapMsgV3));
-        (errorObj).Set(Napi::String::New(node_rfc::__env, "abapMsgV4"), wrapString(errorInfo->abapMsgV4));
+        Napi::EscapableHandleScope scope(env);
+
+        Napi::Object errorObj = Napi::Object::New(env);
+        (errorObj).Set(Napi::String::New(env, "alive"), Napi::Boolean::New(env, alive));
+        (errorObj).Set(Napi::String::New(env, "name"), "ABAPError");
+        (errorObj).Set(Napi::String::New(env, "code"), Napi::Number::New(env, errorInfo->code));
+        (errorObj).Set(Napi::String::New(env, "codeString"), wrapString(env, (SAP_UC *)RfcGetRcAsString(errorInfo->code)));
+        (errorObj).Set(Napi::String::New(env, "key"), wrapString(env, errorInfo->key));
+        (errorObj).Set(Napi::String::New(env, "message"), wrapString(env, errorInfo->message));
+        (errorObj).Set(Napi::String::New(env, "abapMsgClass"), wrapString(env, errorInfo->abapMsgClass));
+        (errorObj).Set(Napi::String::New(env, "abapMsgType"), wrapString(env, errorInfo->abapMsgType));
+        (errorObj).Set(Napi::String::New(env, "abapMsgNumber"), wrapString(env, errorInfo->abapMsgNumber));
+        (errorObj).Set(Napi::String::New(env, "abapMsgV1"), wrapString(env, errorInfo->abapMsgV1));
+        (errorObj).Set(Napi::String::New(env, "abapMsgV2"), wrapString(env, errorInfo->abapMsgV2));
+        (errorObj).Set(Napi::String::New(env, "abapMsgV3"), wrapString(env, errorInfo->abapMsgV3));
+        (errorObj).Set(Napi::String::New(env, "abapMsgV4"), wrapString(env, errorInfo->abapMsgV4));
+
+        return scope.Escape(errorObj);
+    }
 
+    Napi::Value RfcTimeoutError(Napi::Env env, unsigned int timeout, bool alive)
+    {
+        Napi::EscapableHandleScope scope(env);
+
+        char cBuf[64];
+        snprintf(cBuf, sizeof(cBuf), "RFC call timed out after %u ms", timeout);
+
+        Napi::Object errorObj = Napi::Object::New(env);
+        (errorObj).Set(Napi::String::New(env, "alive"), Napi::Boolean::New(env, alive));
+        (errorObj).Set(Napi::String::New(env, "name"), "RfcTimeoutError");
+        (errorObj).Set(Napi::String::New(env, "code"), Napi::Number::New(env, RFC_CANCELED));
+        (errorObj).Set(Napi::String::New(env, "codeString"), wrapString(env, (SAP_UC *)RfcGetRcAsString(RFC_CANCELED)));
+        (errorObj).Set(Napi::String::New(env, "key"), "RFC_CANCELED");
+        (errorObj).Set(Napi::String::New(env, "message"), cBuf);
+        (errorObj).Set(Napi::String::New(env, "timeout"), Napi::Number::New(env, timeout));
         return scope.Escape(errorObj);
     }
 
-    Napi::Value wrapError(RFC_ERROR_INFO *errorInfo, bool alive)
+    Napi::Value wrapError(Napi::Env env, RFC_ERROR_INFO *errorInfo, bool alive)
     {
-        Napi::EscapableHandleScope scope(node_rfc::__env);
+        Napi::EscapableHandleScope scope(env);
 
         char cBuf[256];
 
@@ -135,14 +185,14 @@ namespace node_rfc
         case LOGON_FAILURE:            // 3: Error message raised when logon fails
         case COMMUNICATION_FAILURE:    // 4: Problems with the network connection (or backend broke down and killed the connection)
         case EXTERNAL_RUNTIME_FAILURE: // 5: Problems in the RFC runtime of the external program (i.e "this" library)
-            return scope.Escape(RfcLibError(errorInfo, alive));
+            return scope.Escape(RfcLibError(env, errorInfo, alive));
             break;
 
         case ABAP_APPLICATION_FAILURE:       // 1: ABAP Exception raised in ABAP function modules
         case ABAP_RUNTIME_FAILURE:           // 2: ABAP Message raised in ABAP function modules or in ABAP runtime of the backend (e.g Kernel)
         case EXTERNAL_APPLICATION_FAILURE:   // 6: Problems in the external program (e.g in the external server implementation)
         case EXTERNAL_AUTHORIZATION_FAILURE: // 7: Problems raised in the authorization check handler provided by the external server implementation
-            return scope.Escape(AbapError(errorInfo, alive));
+            return scope.Escape(AbapError(env, errorInfo, alive));
             break;
         }
 
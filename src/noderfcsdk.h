@@ -15,6 +15,7 @@
 #ifndef NODE_SAPNWRFC_NODERFCSDK_H_
 #define NODE_SAPNWRFC_NODERFCSDK_H_
 
+#include <string>
 #include <napi.h>
 #include <sapnwrfc.h>
 using namespace Napi;
@@ -22,12 +23,14 @@ using namespace Napi;
 namespace node_rfc
 {
     // SAP string wrapper, required for errors
-    Napi::Value wrapString(SAP_UC *uc, int length = -1);
+    Napi::Value wrapString(Napi::Env env, SAP_UC *uc, int length = -1);
+    bool utf8String(SAP_UC *uc, int length, std::string &utf8, RFC_ERROR_INFO *errorInfo);
 
     // RFC ERRORS
-    Napi::Value NodeRfcError(Napi::Value errorObj);
-    Napi::Value RfcLibError(RFC_ERROR_INFO *errorInfo, bool alive);
-    Napi::Value AbapError(RFC_ERROR_INFO *errorInfoi, bool alive);
-    Napi::Value wrapError(RFC_ERROR_INFO *errorInfo, bool alive = true);
+    Napi::Value NodeRfcError(Napi::Env env, Napi::Value errorObj);
+    Napi::Value RfcLibError(Napi::Env env, RFC_ERROR_INFO *errorInfo, bool alive);
+    Napi::Value AbapError(Napi::Env env, RFC_ERROR_INFO *errorInfoi, bool alive);
+    Napi::Value RfcTimeoutError(Napi::Env env, unsigned int timeout, bool alive);
+    Napi::Value wrapError(Napi::Env env, RFC_ERROR_INFO *errorInfo, bool alive = true);
 } // namespace node_rfc
 #endif
@@ -12,17 +12,78 @@
 // either express or implied. See the License for the specific
 // language governing permissions and limitations under the License.
 
+#include <cctype>
+#include <cmath>
+#include <cstring>
 #include "Client.h"
 #include "noderfcsdk.h"
 
 using namespace node_rfc;
 
-extern Napi::Env __env;
-
 ////////////////////////////////////////////////////////////////////////////////
 // FILL FUNCTIONS (to RFC)
 ////////////////////////////////////////////////////////////////////////////////
 
+static const char hexDigits[] = "0123456789abcdef";
+static const char base64Digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// hex or base64 text to bytes, false if invalid
+static bool decodeBytes(const std::string &text, int format, std::string &bytes)
+{
+    bytes.clear();
+    if (format == NODERFC_BYTES_HEX)
+    {
+        if (text.size() % 2 != 0)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < text.size(); i += 2)
+        {
+            const char *high = strchr(hexDigits, tolower((unsigned char)text[i]));
+            const char *low = strchr(hexDigits, tolower((unsigned char)text[i + 1]));
+            if (high == NULL || low == NULL || text[i] == 0 || text[i + 1] == 0)
+            {
+                return false;
+            }
+            bytes += (char)(((high - hexDigits) << 4) | (low - hexDigits));
+        }
+        return true;
+    }
+    // padding only at the end, completing the last group of four
+    size_t data = text.find('=');
+    if (data == std::string::npos)
+    {
+        data = text.size();
+    }
+    else if (text.find_first_not_of('=', data) != std::string::npos ||
+             text.size() % 4 != 0 || text.size() - data > 2)
+    {
+        return false;
+    }
+    if (data % 4 == 1)
+    {
+        return false;
+    }
+    unsigned int bits = 0;
+    int count = 0;
+    for (size_t i = 0; i < data; i++)
+    {
+        const char *digit = strchr(base64Digits, text[i]);
+        if (digit == NULL || text[i] == 0)
+        {
+            return false;
+        }
+        bits = (bits << 6) | (unsigned int)(digit - base64Digits);
+        count += 6;
+        if (count >= 8)
+        {
+            count -= 8;
+            bytes += (char)((bits >> count) & 0xFF);
+        }
+    }
+    return true;
+}
+
 SAP_UC *Client::fillString(const Napi::String napistr)
 {
     RFC_RC rc;
@@ -79,7 +140,7 @@ Napi::Value Client::fillFunctionParameter(RFC_FUNCTION_DESC_HANDLE functionDescH
     free(cName);
     if (rc != RFC_OK)
     {
-        return scope.Escape(wrapError(&errorInfo));
+        return scope.Escape(wrapError(Env(), &errorInfo));
     }
     return scope.Escape(fillVariable(paramDesc.type, functionHandle, paramDesc.name, value, paramDesc.typeDescHandle));
 }
@@ -109,7 +170,7 @@ Napi::Value Client::fillStructure(RFC_STRUCTURE_HANDLE structHandle, RFC_TYPE_DE
         free(cValue);
         if (rc != RFC_OK)
         {
-            retVal = wrapError(&errorInfo);
+            retVal = wrapError(Env(), &errorInfo);
             break;
         }
         retVal = fillVariable(fieldDesc.type, structHandle, fieldDesc.name, value, fieldDesc.typeDescHandle);
@@ -121,6 +182,282 @@ Napi::Value Client::fillStructure(RFC_STRUCTURE_HANDLE structHandle, RFC_TYPE_DE
     return retVal;
 }
 
+// CHAR fields only: rows set from one char buffer, blank for missing fields
+bool Client::flatTemplate(RFC_TYPE_DESC_HANDLE typeDesc, FlatRow *flatRow)
+{
+    RFC_ERROR_INFO errorInfo;
+    unsigned int fieldCount, nucLength, ucLength;
+    if (RfcGetFieldCount(typeDesc, &fieldCount, &errorInfo) != RFC_OK || fieldCount == 0 ||
+        RfcGetTypeLength(typeDesc, &nucLength, &ucLength, &errorInfo) != RFC_OK)
+    {
+        return false;
+    }
+    flatRow->fields.resize(fieldCount);
+    for (unsigned int i = 0; i < fieldCount; i++)
+    {
+        if (RfcGetFieldDescByIndex(typeDesc, i, &flatRow->fields[i], &errorInfo) != RFC_OK || flatRow->fields[i].type != RFCTYPE_CHAR)
+        {
+            return false;
+        }
+        flatRow->index[wrapString(Env(), flatRow->fields[i].name).ToString().Utf8Value()] = i;
+    }
+    flatRow->blank.assign(ucLength / sizeof(SAP_UC), 0x20);
+    return true;
+}
+
+// false when the row has to be filled field by field, for other values or errors
+bool Client::fillFlat(FlatRow *flatRow, RFC_STRUCTURE_HANDLE structHandle, Napi::Value line)
+{
+    Napi::HandleScope scope(Env());
+
+    flatRow->charBuffer = flatRow->blank;
+    if (line.IsString() && flatRow->fields.size() == 1 && flatRow->fields[0].name[0] == 0)
+    {
+        if (!flatChars(flatRow, &flatRow->fields[0], line.As<Napi::String>()))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if (!line.IsObject() || line.IsArray() || line.IsBuffer())
+        {
+            return false;
+        }
+        Napi::Object lineObj = line.As<Napi::Object>();
+        Napi::Array names = lineObj.GetPropertyNames();
+        for (unsigned int i = 0; i < names.Length(); i++)
+        {
+            Napi::String name = names.Get(i).ToString();
+            std::unordered_map<std::string, unsigned int>::iterator found = flatRow->index.find(name.Utf8Value());
+            Napi::Value value = lineObj.Get(name);
+            if (found == flatRow->index.end() || !value.IsString() ||
+                !flatChars(flatRow, &flatRow->fields[found->second], value.As<Napi::String>()))
+            {
+                return false;
+            }
+        }
+    }
+
+    RFC_ERROR_INFO errorInfo;
+    return RfcSetStructureFromCharBuffer(structHandle, &flatRow->charBuffer[0], (unsigned int)flatRow->charBuffer.size(), &errorInfo) == RFC_OK;
+}
+
+// value copied into its field, false when longer than the field
+bool Client::flatChars(FlatRow *flatRow, RFC_FIELD_DESC *fieldDesc, Napi::String value)
+{
+    SAP_UC *cValue = fillString(value);
+    unsigned int length = strlenU((SAP_UTF16 *)cValue);
+    bool fits = length <= fieldDesc->nucLength;
+    if (fits)
+    {
+        memcpy(&flatRow->charBuffer[fieldDesc->ucOffset / sizeof(SAP_UC)], cValue, length * sizeof(SAP_UC));
+    }
+    free(cValue);
+    return fits;
+}
+
+// table as columns: arrays of any values, Float64Array or Int32Array for numeric fields,
+// Buffer with newline delimited UTF-8 values for text fields; rows appended at once
+Napi::Value Client::fillColumns(RFC_TABLE_HANDLE tableHandle, RFC_TYPE_DESC_HANDLE typeDesc, SAP_UC *cName, Napi::Object columns)
+{
+    Napi::EscapableHandleScope scope(Env());
+
+    RFC_ERROR_INFO errorInfo;
+    char err[256];
+    std::string tableName = wrapString(Env(), cName).ToString().Utf8Value();
+    Napi::Array names = columns.GetPropertyNames();
+    std::vector<TableColumn> plan(names.Length());
+    unsigned int rowCount = 0;
+
+    for (unsigned int i = 0; i < plan.size(); i++)
+    {
+        Napi::String name = names.Get(i).ToString();
+        std::string columnName = name.Utf8Value();
+        Napi::Value values = columns.Get(name);
+        TableColumn *column = &plan[i];
+
+        SAP_UC *cFieldName = fillString(name);
+        RFC_RC rc = RfcGetFieldDescByName(typeDesc, cFieldName, &column->fieldDesc, &errorInfo);
+        free(cFieldName);
+        if (rc != RFC_OK)
+        {
+            return scope.Escape(wrapError(Env(), &errorInfo));
+        }
+
+        unsigned int length = 0;
+        if (values.IsTypedArray())
+        {
+            Napi::TypedArray typedArray = values.As<Napi::TypedArray>();
+            switch (column->fieldDesc.type)
+            {
+            case RFCTYPE_INT:
+            case RFCTYPE_INT1:
+            case RFCTYPE_INT2:
+            case RFCTYPE_INT8:
+            case RFCTYPE_FLOAT:
+            case RFCTYPE_BCD:
+            case RFCTYPE_DECF16:
+            case RFCTYPE_DECF34:
+                break;
+            default:
+                sprintf(err, "Numeric field expected for typed array column %s of table %s", &columnName[0], &tableName[0]);
+                return scope.Escape(Napi::TypeError::New(Env(), err).Value());
+            }
+            if (typedArray.TypedArrayType() == napi_float64_array)
+            {
+                column->kind = NODERFC_COLUMN_FLOAT64;
+                column->f64 = values.As<Napi::Float64Array>().Data();
+            }
+            else if (typedArray.TypedArrayType() == napi_int32_array)
+            {
+                column->kind = NODERFC_COLUMN_INT32;
+                column->i32 = values.As<Napi::Int32Array>().Data();
+            }
+            else
+            {
+                sprintf(err, "Float64Array or Int32Array expected for column %s of table %s", &columnName[0], &tableName[0]);
+                return scope.Escape(Napi::TypeError::New(Env(), err).Value());
+            }
+            length = typedArray.ElementLength();
+        }
+        else if (values.IsBuffer())
+        {
+            Napi::Buffer<char> buffer = values.As<Napi::Buffer<char>>();
+            column->kind = NODERFC_COLUMN_TEXT;
+            column->text = buffer.Data();
+            column->textSize = buffer.Length();
+            column->textOffset = 0;
+            // trailing newline optional
+            for (size_t j = 0; j < column->textSize; j++)
+            {
+                length += column->text[j] == '\n' ? 1 : 0;
+            }
+            if (column->textSize > 0 && column->text[column->textSize - 1] != '\n')
+            {
+                length++;
+            }
+        }
+        else if (values.IsArray())
+        {
+            column->kind = NODERFC_COLUMN_ARRAY;
+            column->array = values.As<Napi::Array>();
+            length = column->array.Length();
+        }
+        else
+        {
+            sprintf(err, "Array, typed array or Buffer expected for column %s of table %s", &columnName[0], &tableName[0]);
+            return scope.Escape(Napi::TypeError::New(Env(), err).Value());
+        }
+
+        if (i == 0)
+        {
+            rowCount = length;
+        }
+        else if (length != rowCount)
+        {
+            sprintf(err, "Column %s of table %s has %u values, %u expected", &columnName[0], &tableName[0], length, rowCount);
+            return scope.Escape(Napi::TypeError::New(Env(), err).Value());
+        }
+    }
+
+    if (rowCount == 0)
+    {
+        return Env().Undefined();
+    }
+
+    unsigned int firstRow;
+    if (RfcGetRowCount(tableHandle, &firstRow, &errorInfo) != RFC_OK || RfcAppendNewRows(tableHandle, rowCount, &errorInfo) != RFC_OK)
+    {
+        return scope.Escape(wrapError(Env(), &errorInfo));
+    }
+    for (unsigned int row = 0; row < rowCount; row++)
+    {
+        if (RfcMoveTo(tableHandle, firstRow + row, &errorInfo) != RFC_OK)
+        {
+            return scope.Escape(wrapError(Env(), &errorInfo));
+        }
+        for (unsigned int i = 0; i < plan.size(); i++)
+        {
+            Napi::Value rv = fillCell(tableHandle, &plan[i], row);
+            if (!rv.IsUndefined())
+            {
+                return scope.Escape(rv);
+            }
+        }
+    }
+    return Env().Undefined();
+}
+
+// current row field from one column value, numbers and text set without JS values
+Napi::Value Client::fillCell(RFC_TABLE_HANDLE tableHandle, TableColumn *column, unsigned int row)
+{
+    RFC_RC rc = RFC_OK;
+    RFC_ERROR_INFO errorInfo;
+    RFC_FIELD_DESC *fieldDesc = &column->fieldDesc;
+
+    switch (column->kind)
+    {
+    case NODERFC_COLUMN_ARRAY:
+    {
+        // value handles released per row
+        Napi::EscapableHandleScope scope(Env());
+        Napi::Value rv = fillVariable(fieldDesc->type, tableHandle, fieldDesc->name, column->array.Get(row), fieldDesc->typeDescHandle);
+        if (!rv.IsUndefined())
+        {
+            return scope.Escape(rv);
+        }
+        return scope.Env().Undefined();
+    }
+    case NODERFC_COLUMN_TEXT:
+    {
+        const char *start = column->text + column->textOffset;
+        const char *end = (const char *)memchr(start, '\n', column->textSize - column->textOffset);
+        size_t length = end == NULL ? column->textSize - column->textOffset : end - start;
+        column->textOffset += length + 1;
+        // CRLF delimited lines
+        if (length > 0 && start[length - 1] == '\r')
+        {
+            length--;
+        }
+        SAP_UC *cValue = fillString(std::string(start, length));
+        rc = RfcSetString(tableHandle, fieldDesc->name, cValue, strlenU((SAP_UTF16 *)cValue), &errorInfo);
+        free(cValue);
+        break;
+    }
+    default:
+    {
+        double value = column->kind == NODERFC_COLUMN_FLOAT64 ? column->f64[row] : (double)column->i32[row];
+        if (fieldDesc->type == RFCTYPE_FLOAT || fieldDesc->type == RFCTYPE_BCD || fieldDesc->type == RFCTYPE_DECF16 || fieldDesc->type == RFCTYPE_DECF34)
+        {
+            rc = RfcSetFloat(tableHandle, fieldDesc->name, (RFC_FLOAT)value, &errorInfo);
+            break;
+        }
+        // NaN, infinite and fractional values rejected before any integer cast
+        if (!std::isfinite(value) || std::trunc(value) != value ||
+            (fieldDesc->type == RFCTYPE_INT8 && (value < -9223372036854775808.0 || value >= 9223372036854775808.0)) ||
+            (fieldDesc->type == RFCTYPE_INT1 && (value < 0 || value > UINT8_MAX)) ||
+            (fieldDesc->type == RFCTYPE_INT2 && (value < INT16_MIN || value > INT16_MAX)) ||
+            (fieldDesc->type == RFCTYPE_INT && (value < INT32_MIN || value > INT32_MAX)))
+        {
+            char err[256];
+            std::string fieldName = wrapString(Env(), fieldDesc->name).ToString().Utf8Value();
+            sprintf(err, "Integer in field range expected in row %u of column %s, got %a", row, &fieldName[0], value);
+            return Napi::TypeError::New(Env(), err).Value();
+        }
+        rc = fieldDesc->type == RFCTYPE_INT8
+                 ? RfcSetInt8(tableHandle, fieldDesc->name, (RFC_INT8)value, &errorInfo)
+                 : RfcSetInt(tableHandle, fieldDesc->name, (RFC_INT)value, &errorInfo);
+        break;
+    }
+    }
+    if (rc != RFC_OK)
+    {
+        return wrapError(Env(), &errorInfo);
+    }
+    return Env().Undefined();
+}
+
 Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, Napi::Value value, RFC_TYPE_DESC_HANDLE functionDescHandle)
 {
     Napi::EscapableHandleScope scope(value.Env());
@@ -135,7 +472,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         rc = RfcGetStructure(functionHandle, cName, &structHandle, &errorInfo);
         if (rc != RFC_OK)
         {
-            return scope.Escape(wrapError(&errorInfo));
+            return scope.Escape(wrapError(Env(), &errorInfo));
         }
         Napi::Value rv = fillStructure(structHandle, functionDescHandle, cName, value);
         if (!rv.IsUndefined())
@@ -153,20 +490,36 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
+        if (value.IsObject() && !value.IsArray() && !value.IsBuffer())
+        {
+            Napi::Value rv = fillColumns(tableHandle, functionDescHandle, cName, value.As<Napi::Object>());
+            if (!rv.IsUndefined())
+            {
+                return scope.Escape(rv);
+            }
+            break;
+        }
         if (!value.IsArray())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Array expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
         Napi::Array array = value.As<Napi::Array>();
         unsigned int rowCount = array.Length();
 
+        FlatRow flatRow;
+        bool flat = rowCount > 0 && flatTemplate(functionDescHandle, &flatRow);
+
         for (unsigned int i = 0; i < rowCount; i++)
         {
             RFC_STRUCTURE_HANDLE structHandle = RfcAppendNewRow(tableHandle, &errorInfo);
             Napi::Value line = array.Get(i);
+            if (flat && fillFlat(&flatRow, structHandle, line))
+            {
+                continue;
+            }
             if (line.IsBuffer() || line.IsString() || line.IsNumber())
             {
                 Napi::Object lineObj = Napi::Object::New(value.Env());
@@ -186,7 +539,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsString())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Char expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -197,10 +550,24 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
     }
     case RFCTYPE_BYTE:
     {
+        if (value.IsString() && (__bytes == NODERFC_BYTES_HEX || __bytes == NODERFC_BYTES_BASE64))
+        {
+            // hex or base64 string, as returned with the bytes option
+            std::string bytes;
+            if (!decodeBytes(value.As<Napi::String>().Utf8Value(), __bytes, bytes))
+            {
+                char err[256];
+                std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
+                sprintf(err, "Invalid %s string when filling field '%s' of type %d", __bytes == NODERFC_BYTES_HEX ? "hex" : "base64", &fieldName[0], typ);
+                return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
+            }
+            rc = RfcSetBytes(functionHandle, cName, (SAP_RAW *)bytes.data(), (unsigned int)bytes.size(), &errorInfo);
+            break;
+        }
         if (!value.IsBuffer())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Buffer expected when filling field '%s' of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -219,7 +586,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsBuffer())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Buffer expected when filling field '%s' of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -238,7 +605,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsString())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Char expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -252,7 +619,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsString())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Char expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -269,7 +636,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsNumber() && !value.IsObject() && !value.IsString())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Number, number object or string expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -286,7 +653,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsNumber())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Integer number expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -296,7 +663,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if ((int64_t)numDouble != numDouble) // or std::trunc(numDouble) == numDouble;
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "Integer number expected when filling field %s of type %d, got %a", &fieldName[0], typ, numDouble);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -314,7 +681,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
                 (typ == RFCTYPE_INT2 && ((rfcInt > INT16_MAX) || (rfcInt < INT16_MIN))))
             {
                 char err[256];
-                std::string fieldName = wrapString(cName).ToString().Utf8Value();
+                std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
                 sprintf(err, "Overflow or other error when filling integer field %s of type %d, value: %d", &fieldName[0], typ, rfcInt);
                 return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
             }
@@ -328,7 +695,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsString())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "UTCLONG string expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -347,7 +714,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsString())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "ABAP date format YYYYMMDD expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -366,7 +733,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         if (!value.IsString())
         {
             char err[256];
-            std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             sprintf(err, "ABAP time format HHMMSS expected when filling field %s of type %d", &fieldName[0], typ);
             return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         }
@@ -378,7 +745,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
     default:
     {
         char err[256];
-        std::string fieldName = wrapString(cName).ToString().Utf8Value();
+        std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
         sprintf(err, "Unknown RFC type %u when filling %s", typ, &fieldName[0]);
         return scope.Escape(Napi::TypeError::New(value.Env(), err).Value());
         break;
@@ -386,7 +753,7 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
     }
     if (rc != RFC_OK)
     {
-        return scope.Escape(wrapError(&errorInfo));
+        return scope.Escape(wrapError(Env(), &errorInfo));
     }
     return scope.Env().Undefined();
 } // namespace node_rfc
@@ -395,22 +762,39 @@ Napi::Value Client::fillVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
 // WRAP FUNCTIONS (from RFC)
 ////////////////////////////////////////////////////////////////////////////////
 
-Napi::Value Client::wrapResult(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle)
+Napi::Value Client::wrapResult(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *skipName, std::vector<RFC_PARAMETER_DESC> *tables)
 {
-    Napi::EscapableHandleScope scope(node_rfc::__env);
+    Napi::EscapableHandleScope scope(Env());
 
     RFC_PARAMETER_DESC paramDesc;
     unsigned int paramCount = 0;
 
     RfcGetParameterCount(functionDescHandle, &paramCount, NULL);
-    Napi::Object resultObj = Napi::Object::New(node_rfc::__env);
+    Napi::Object resultObj = Napi::Object::New(Env());
 
     for (unsigned int i = 0; i < paramCount; i++)
     {
         RfcGetParameterDescByIndex(functionDescHandle, i, &paramDesc, NULL);
+        if (skipName != NULL && strcmpU(paramDesc.name, skipName) == 0)
+        {
+            continue;
+        }
+        if (tables != NULL && paramDesc.type == RFCTYPE_TABLE && paramDesc.direction != __filter_param_direction)
+        {
+            // tables with rows left to the caller, placeholder keeps the parameter order
+            RFC_TABLE_HANDLE tableHandle;
+            unsigned int rowCount = 0;
+            if (RfcGetTable(functionHandle, paramDesc.name, &tableHandle, NULL) == RFC_OK &&
+                RfcGetRowCount(tableHandle, &rowCount, NULL) == RFC_OK && rowCount > 0)
+            {
+                tables->push_back(paramDesc);
+                resultObj.Set(wrapString(Env(), paramDesc.name), Napi::Array::New(Env()));
+                continue;
+            }
+        }
         if (paramDesc.direction != __filter_param_direction)
         {
-            Napi::String name = wrapString(paramDesc.name).As<Napi::String>();
+            Napi::String name = wrapString(Env(), paramDesc.name).As<Napi::String>();
             Napi::Value value = wrapVariable(paramDesc.type, functionHandle, paramDesc.name, paramDesc.nucLength, paramDesc.typeDescHandle);
             (resultObj).Set(name, value);
         }
@@ -420,7 +804,7 @@ Napi::Value Client::wrapResult(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_
 
 Napi::Value Client::wrapStructure(RFC_TYPE_DESC_HANDLE typeDesc, RFC_STRUCTURE_HANDLE structHandle)
 {
-    Napi::EscapableHandleScope scope(node_rfc::__env);
+    Napi::EscapableHandleScope scope(Env());
 
     RFC_RC rc;
     RFC_ERROR_INFO errorInfo;
@@ -429,19 +813,19 @@ Napi::Value Client::wrapStructure(RFC_TYPE_DESC_HANDLE typeDesc, RFC_STRUCTURE_H
     rc = RfcGetFieldCount(typeDesc, &fieldCount, &errorInfo);
     if (rc != RFC_OK)
     {
-        Napi::Error::New(node_rfc::__env, wrapError(&errorInfo).ToString()).ThrowAsJavaScriptException();
+        Napi::Error::New(Env(), wrapError(Env(), &errorInfo).ToString()).ThrowAsJavaScriptException();
     }
 
-    Napi::Object resultObj = Napi::Object::New(node_rfc::__env);
+    Napi::Object resultObj = Napi::Object::New(Env());
 
     for (unsigned int i = 0; i < fieldCount; i++)
     {
         rc = RfcGetFieldDescByIndex(typeDesc, i, &fieldDesc, &errorInfo);
         if (rc != RFC_OK)
         {
-            Napi::Error::New(node_rfc::__env, wrapError(&errorInfo).ToString()).ThrowAsJavaScriptException();
+            Napi::Error::New(Env(), wrapError(Env(), &errorInfo).ToString()).ThrowAsJavaScriptException();
         }
-        (resultObj).Set(wrapString(fieldDesc.name), wrapVariable(fieldDesc.type, structHandle, fieldDesc.name, fieldDesc.nucLength, fieldDesc.typeDescHandle));
+        (resultObj).Set(wrapString(Env(), fieldDesc.name), wrapVariable(fieldDesc.type, structHandle, fieldDesc.name, fieldDesc.nucLength, fieldDesc.typeDescHandle));
     }
 
     if (fieldCount == 1)
@@ -456,9 +840,252 @@ Napi::Value Client::wrapStructure(RFC_TYPE_DESC_HANDLE typeDesc, RFC_STRUCTURE_H
     return scope.Escape(resultObj);
 }
 
+// field descriptions and names of the row type, names created in the caller's scope
+bool Client::rowTemplate(RFC_TYPE_DESC_HANDLE typeDesc, RowTemplate *row, RFC_ERROR_INFO *errorInfo)
+{
+    unsigned int fieldCount;
+    if (RfcGetFieldCount(typeDesc, &fieldCount, errorInfo) != RFC_OK)
+    {
+        return false;
+    }
+    row->fields.resize(fieldCount);
+    row->properties.resize(fieldCount);
+    for (unsigned int i = 0; i < fieldCount; i++)
+    {
+        if (RfcGetFieldDescByIndex(typeDesc, i, &row->fields[i], errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+        napi_property_descriptor property = {NULL, wrapString(Env(), row->fields[i].name), NULL, NULL, NULL, NULL,
+                                             (napi_property_attributes)(napi_writable | napi_enumerable | napi_configurable), NULL};
+        row->properties[i] = property;
+    }
+    row->unnamed = fieldCount == 1 && row->fields[0].name[0] == 0;
+
+    // character-like fields only: whole row read at once, fields split at their offsets
+    row->flat = fieldCount > 0;
+    for (unsigned int i = 0; i < fieldCount && row->flat; i++)
+    {
+        RFCTYPE type = row->fields[i].type;
+        row->flat = type == RFCTYPE_CHAR || type == RFCTYPE_NUM || type == RFCTYPE_DATE || type == RFCTYPE_TIME;
+    }
+    unsigned int nucLength, ucLength;
+    if (row->flat && RfcGetTypeLength(typeDesc, &nucLength, &ucLength, errorInfo) == RFC_OK)
+    {
+        row->charBuffer.resize(ucLength / sizeof(SAP_UC));
+    }
+    else
+    {
+        row->flat = false;
+    }
+
+    if (row->intern != NULL)
+    {
+        InternColumn column;
+        column.seen = 0;
+        column.disabled = false;
+        row->intern->columns.resize(fieldCount, column);
+    }
+    return true;
+}
+
+Napi::Value Client::wrapRow(RowTemplate *row, RFC_STRUCTURE_HANDLE structHandle)
+{
+    Napi::EscapableHandleScope scope(Env());
+
+    RFC_ERROR_INFO errorInfo;
+    if (row->flat && RfcGetStructureIntoCharBuffer(structHandle, &row->charBuffer[0], (unsigned int)row->charBuffer.size(), &errorInfo) != RFC_OK)
+    {
+        // field by field from now on
+        row->flat = false;
+    }
+
+    for (unsigned int i = 0; i < row->fields.size(); i++)
+    {
+        RFC_FIELD_DESC *fieldDesc = &row->fields[i];
+        if (row->flat)
+        {
+            row->properties[i].value = wrapChars(row, i);
+            continue;
+        }
+        if (fieldDesc->type == RFCTYPE_BYTE && !row->slab.IsEmpty() && fieldDesc->nucLength <= NODERFC_SLAB_FIELD)
+        {
+            row->properties[i].value = wrapSlab(row, structHandle, fieldDesc);
+            continue;
+        }
+        row->properties[i].value = row->intern != NULL && fieldDesc->type == RFCTYPE_CHAR
+                                       ? internChars(row->intern, i, structHandle, fieldDesc)
+                                       : wrapVariable(fieldDesc->type, structHandle, fieldDesc->name, fieldDesc->nucLength, fieldDesc->typeDescHandle);
+    }
+
+    if (row->unnamed)
+    {
+        return scope.Escape(row->properties[0].value);
+    }
+
+    Napi::Object rowObj = Napi::Object::New(Env());
+    napi_status status = napi_define_properties(Env(), rowObj, row->properties.size(), row->properties.data());
+    if (status != napi_ok)
+    {
+        Napi::Error::New(Env()).ThrowAsJavaScriptException();
+    }
+    return scope.Escape(rowObj);
+}
+
+// field of the row char buffer, converted like wrapVariable()
+Napi::Value Client::wrapChars(RowTemplate *row, unsigned int column)
+{
+    RFC_FIELD_DESC *fieldDesc = &row->fields[column];
+    RFC_CHAR *chars = &row->charBuffer[fieldDesc->ucOffset / sizeof(SAP_UC)];
+    switch (fieldDesc->type)
+    {
+    case RFCTYPE_CHAR:
+        if (row->intern != NULL)
+        {
+            return internChars(row->intern, column, NULL, fieldDesc, chars);
+        }
+        return wrapString(Env(), chars, fieldDesc->nucLength);
+    case RFCTYPE_DATE:
+        if (!__dateFromABAP.IsEmpty())
+        {
+            return __dateFromABAP.Call({wrapString(Env(), chars, 8)});
+        }
+        return wrapString(Env(), chars, 8);
+    case RFCTYPE_TIME:
+        if (!__timeFromABAP.IsEmpty())
+        {
+            return __timeFromABAP.Call({wrapString(Env(), chars, 6)});
+        }
+        return wrapString(Env(), chars, 6);
+    default:
+        return wrapString(Env(), chars, fieldDesc->nucLength);
+    }
+}
+
+// short CHAR value of a table column, same string returned for repeated values,
+// chars read from the row buffer or from the structure when NULL
+Napi::Value Client::internChars(InternTable *intern, unsigned int column, RFC_STRUCTURE_HANDLE structHandle, RFC_FIELD_DESC *fieldDesc, RFC_CHAR *chars)
+{
+    InternColumn &internColumn = intern->columns[column];
+    if (internColumn.disabled || fieldDesc->nucLength > NODERFC_INTERN_LENGTH)
+    {
+        internColumn.disabled = true;
+        return chars != NULL ? wrapString(Env(), chars, fieldDesc->nucLength)
+                             : wrapVariable(fieldDesc->type, structHandle, fieldDesc->name, fieldDesc->nucLength, fieldDesc->typeDescHandle);
+    }
+
+    RFC_ERROR_INFO errorInfo;
+    RFC_CHAR charValue[NODERFC_INTERN_LENGTH];
+    if (chars == NULL)
+    {
+        if (RfcGetChars(structHandle, fieldDesc->name, charValue, fieldDesc->nucLength, &errorInfo) != RFC_OK)
+        {
+            return wrapVariable(fieldDesc->type, structHandle, fieldDesc->name, fieldDesc->nucLength, fieldDesc->typeDescHandle);
+        }
+        chars = charValue;
+    }
+    unsigned int length = fieldDesc->nucLength;
+    while (length > 0 && chars[length - 1] == 0x20)
+    {
+        length--;
+    }
+
+    std::string key((char *)chars, length * sizeof(RFC_CHAR));
+    std::unordered_map<std::string, uint32_t>::iterator found = internColumn.index.find(key);
+    internColumn.seen++;
+    if (found != internColumn.index.end())
+    {
+        return intern->strings.Get(found->second);
+    }
+
+    Napi::Value value = wrapString(Env(), chars, length);
+
+    // mostly distinct values not worth the lookup
+    if (internColumn.index.size() >= NODERFC_INTERN_DISTINCT ||
+        (internColumn.seen >= NODERFC_INTERN_SAMPLE && internColumn.index.size() * 2 > internColumn.seen))
+    {
+        internColumn.disabled = true;
+        internColumn.index.clear();
+        return value;
+    }
+    intern->strings.Set(intern->count, value);
+    internColumn.index[key] = intern->count++;
+    return value;
+}
+
+// short BYTE fields of all table rows in one ArrayBuffer, no Buffer and finalizer per value
+void Client::rowSlab(RowTemplate *row, unsigned int rowCount)
+{
+    size_t rowBytes = 0;
+    for (unsigned int i = 0; i < row->fields.size(); i++)
+    {
+        if (row->fields[i].type == RFCTYPE_BYTE && row->fields[i].nucLength <= NODERFC_SLAB_FIELD)
+        {
+            rowBytes += row->fields[i].nucLength;
+        }
+    }
+    row->slabOffset = 0;
+    if (rowBytes > 0 && rowCount > 0)
+    {
+        row->slab = Napi::ArrayBuffer::New(Env(), rowBytes * rowCount);
+    }
+}
+
+// BYTE field read into the slab, Uint8Array view returned
+Napi::Value Client::wrapSlab(RowTemplate *row, RFC_STRUCTURE_HANDLE structHandle, RFC_FIELD_DESC *fieldDesc)
+{
+    RFC_ERROR_INFO errorInfo;
+    if (row->slabOffset + fieldDesc->nucLength > row->slab.ByteLength() ||
+        RfcGetBytes(structHandle, fieldDesc->name, static_cast<SAP_RAW *>(row->slab.Data()) + row->slabOffset, fieldDesc->nucLength, &errorInfo) != RFC_OK)
+    {
+        return wrapVariable(fieldDesc->type, structHandle, fieldDesc->name, fieldDesc->nucLength, fieldDesc->typeDescHandle);
+    }
+    Napi::Uint8Array view = Napi::Uint8Array::New(Env(), fieldDesc->nucLength, row->slab, row->slabOffset);
+    row->slabOffset += fieldDesc->nucLength;
+    return view;
+}
+
+// BYTE value as Buffer copy, hex or base64 string
+Napi::Value Client::wrapBytes(SAP_RAW *bytes, unsigned int length)
+{
+    std::string text;
+    if (__bytes == NODERFC_BYTES_HEX)
+    {
+        text.reserve(length * 2);
+        for (unsigned int i = 0; i < length; i++)
+        {
+            text += hexDigits[bytes[i] >> 4];
+            text += hexDigits[bytes[i] & 0x0F];
+        }
+        return Napi::String::New(Env(), text);
+    }
+    if (__bytes == NODERFC_BYTES_BASE64)
+    {
+        text.reserve((length + 2) / 3 * 4);
+        for (unsigned int i = 0; i < length; i += 3)
+        {
+            unsigned int bits = (unsigned int)bytes[i] << 16;
+            if (i + 1 < length)
+            {
+                bits |= (unsigned int)bytes[i + 1] << 8;
+            }
+            if (i + 2 < length)
+            {
+                bits |= bytes[i + 2];
+            }
+            text += base64Digits[(bits >> 18) & 0x3F];
+            text += base64Digits[(bits >> 12) & 0x3F];
+            text += i + 1 < length ? base64Digits[(bits >> 6) & 0x3F] : '=';
+            text += i + 2 < length ? base64Digits[bits & 0x3F] : '=';
+        }
+        return Napi::String::New(Env(), text);
+    }
+    return Napi::Buffer<char>::Copy(Env(), reinterpret_cast<char *>(bytes), length);
+}
+
 Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle, SAP_UC *cName, unsigned int cLen, RFC_TYPE_DESC_HANDLE typeDesc)
 {
-    Napi::EscapableHandleScope scope(node_rfc::__env);
+    Napi::EscapableHandleScope scope(Env());
 
     Napi::Value resultValue;
 
@@ -489,12 +1116,31 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         unsigned int rowCount;
         rc = RfcGetRowCount(tableHandle, &rowCount, &errorInfo);
 
-        Napi::Array table = Napi::Array::New(node_rfc::__env);
+        Napi::Array table = Napi::Array::New(Env());
+
+        InternTable intern;
+        RowTemplate rowType;
+        rowType.intern = NULL;
+        if (__intern)
+        {
+            intern.strings = Napi::Array::New(Env());
+            intern.count = 0;
+            rowType.intern = &intern;
+        }
+        if (!rowTemplate(typeDesc, &rowType, &errorInfo))
+        {
+            rc = errorInfo.code;
+            break;
+        }
+        if (__bytes == NODERFC_BYTES_VIEW)
+        {
+            rowSlab(&rowType, rowCount);
+        }
 
         while (rowCount-- > 0)
         {
             RfcMoveTo(tableHandle, rowCount, NULL);
-            Napi::Value row = wrapStructure(typeDesc, tableHandle);
+            Napi::Value row = wrapRow(&rowType, tableHandle);
             RfcDeleteCurrentRow(tableHandle, &errorInfo);
             (table).Set(rowCount, row);
         }
@@ -509,7 +1155,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
-        resultValue = wrapString(charValue, cLen);
+        resultValue = wrapString(Env(), charValue, cLen);
         free(charValue);
         break;
     }
@@ -523,7 +1169,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
-        resultValue = wrapString(stringValue, strLen);
+        resultValue = wrapString(Env(), stringValue, strLen);
         free(stringValue);
         break;
     }
@@ -536,26 +1182,20 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
             free(numValue);
             break;
         }
-        resultValue = wrapString(numValue, cLen);
+        resultValue = wrapString(Env(), numValue, cLen);
         free(numValue);
         break;
     }
     case RFCTYPE_BYTE:
     {
-        SAP_RAW *byteValue = (SAP_RAW *)malloc(cLen);
-
-        //std::string fieldName = wrapString(cName).ToString().Utf8Value();
-        //printf("\nbout %d %s cLen: %u", rc, &fieldName[0], cLen);
-
-        rc = RfcGetBytes(functionHandle, cName, byteValue, cLen, &errorInfo);
+        // fixed length, copied into the Buffer or string
+        std::vector<SAP_RAW> byteValue(cLen > 0 ? cLen : 1);
+        rc = RfcGetBytes(functionHandle, cName, &byteValue[0], cLen, &errorInfo);
         if (rc != RFC_OK)
         {
-            free(byteValue);
             break;
         }
-        resultValue = Napi::Buffer<char>::New(node_rfc::__env, reinterpret_cast<char *>(byteValue), cLen); // .As<Napi::Uint8Array>(); // as a buffer
-        //resultValue = Napi::String::New(env, reinterpret_cast<const char *>(byteValue)); // or as a string
-        // do not free byteValue - it will be freed when the buffer is garbage collected
+        resultValue = wrapBytes(&byteValue[0], cLen);
         break;
     }
 
@@ -570,7 +1210,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
 
         rc = RfcGetXString(functionHandle, cName, byteValue, strLen, &resultLen, &errorInfo);
 
-        //std::string fieldName = wrapString(cName).ToString().Utf8Value();
+        //std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
         //printf("\nxout %d %s cLen: %u strLen %u resultLen %u", rc, &fieldName[0], cLen, strLen, resultLen);
 
         if (rc != RFC_OK)
@@ -578,8 +1218,8 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
             free(byteValue);
             break;
         }
-        resultValue = Napi::Buffer<char>::New(node_rfc::__env, reinterpret_cast<char *>(byteValue), resultLen); // as a buffer
-        //resultValue = Napi::String::New(node_rfc::__env, reinterpret_cast<const char *>(byteValue)); // or as a string
+        resultValue = Napi::Buffer<char>::New(Env(), reinterpret_cast<char *>(byteValue), resultLen); // as a buffer
+        //resultValue = Napi::String::New(Env(), reinterpret_cast<const char *>(byteValue)); // or as a string
         // do not free byteValue - it will be freed when the buffer is garbage collected
         break;
     }
@@ -596,7 +1236,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         rc = RfcGetString(functionHandle, cName, sapuc, strLen + 1, &resultLen, &errorInfo);
         if (rc == 23) // Buffer too small, use returned requried result length
         {
-            //std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            //std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             //printf("\nWarning: Buffer for BCD type %d to small when wrapping %s\ncLen=%u, buffer=%u, trying with %u", typ, &fieldName[0], cLen, strLen, resultLen);
             free(sapuc);
             strLen = resultLen;
@@ -608,7 +1248,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
             free(sapuc);
             break;
         }
-        resultValue = wrapString(sapuc, resultLen).ToString();
+        resultValue = wrapString(Env(), sapuc, resultLen).ToString();
         free(sapuc);
 
         if (__bcd == NODERFC_BCD_FUNCTION)
@@ -625,7 +1265,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
     {
         RFC_FLOAT floatValue;
         rc = RfcGetFloat(functionHandle, cName, &floatValue, &errorInfo);
-        resultValue = Napi::Number::New(node_rfc::__env, floatValue);
+        resultValue = Napi::Number::New(Env(), floatValue);
         break;
     }
     case RFCTYPE_DECF16:
@@ -644,7 +1284,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         rc = RfcGetString(functionHandle, cName, sapuc, strLen + 1, &resultLen, &errorInfo);
         if (rc == 23) // Buffer too small, use returned requried result length
         {
-            //std::string fieldName = wrapString(cName).ToString().Utf8Value();
+            //std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
             //printf("\nWarning: Buffer for BCD type %d to small when wrapping %s\ncLen=%u, buffer=%u, trying with %u", typ, &fieldName[0], cLen, strLen, resultLen);
             free(sapuc);
             strLen = resultLen;
@@ -656,7 +1296,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
             free(sapuc);
             break;
         }
-        resultValue = wrapString(sapuc, resultLen).ToString();
+        resultValue = wrapString(Env(), sapuc, resultLen).ToString();
         free(sapuc);
 
         if (__bcd == NODERFC_BCD_FUNCTION)
@@ -677,7 +1317,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
-        resultValue = Napi::Number::New(node_rfc::__env, intValue);
+        resultValue = Napi::Number::New(Env(), intValue);
         break;
     }
     case RFCTYPE_INT1:
@@ -688,7 +1328,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
-        resultValue = Napi::Number::New(node_rfc::__env, intValue);
+        resultValue = Napi::Number::New(Env(), intValue);
         break;
     }
     case RFCTYPE_INT2:
@@ -699,7 +1339,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
-        resultValue = Napi::Number::New(node_rfc::__env, intValue);
+        resultValue = Napi::Number::New(Env(), intValue);
         break;
     }
     case RFCTYPE_INT8:
@@ -710,7 +1350,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
-        resultValue = Napi::Number::New(node_rfc::__env, (double)intValue);
+        resultValue = Napi::Number::New(Env(), (double)intValue);
         break;
     }
     case RFCTYPE_UTCLONG:
@@ -723,7 +1363,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
             break;
         }
         stringValue[19] = '.';
-        resultValue = wrapString(stringValue, strLen);
+        resultValue = wrapString(Env(), stringValue, strLen);
         free(stringValue);
         break;
     }
@@ -735,7 +1375,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
-        resultValue = wrapString(dateValue, 8);
+        resultValue = wrapString(Env(), dateValue, 8);
         if (!__dateFromABAP.IsEmpty())
         {
             resultValue = __dateFromABAP.Call({resultValue});
@@ -750,7 +1390,7 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
         {
             break;
         }
-        resultValue = wrapString(timeValue, 6);
+        resultValue = wrapString(Env(), timeValue, 6);
         if (!__timeFromABAP.IsEmpty())
         {
             resultValue = __timeFromABAP.Call({resultValue});
@@ -759,15 +1399,15 @@ Napi::Value Client::wrapVariable(RFCTYPE typ, RFC_FUNCTION_HANDLE functionHandle
     }
     default:
         char err[256];
-        std::string fieldName = wrapString(cName).ToString().Utf8Value();
+        std::string fieldName = wrapString(Env(), cName).ToString().Utf8Value();
         sprintf(err, "Unknown RFC type %d when wrapping %s", typ, &fieldName[0]);
-        Napi::TypeError::New(node_rfc::__env, err).ThrowAsJavaScriptException();
+        Napi::TypeError::New(Env(), err).ThrowAsJavaScriptException();
 
         break;
     }
     if (rc != RFC_OK)
     {
-        return scope.Escape(wrapError(&errorInfo));
+        return scope.Escape(wrapError(Env(), &errorInfo));
     }
 
     return scope.Escape(resultValue);
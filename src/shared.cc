@@ -0,0 +1,412 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include "shared.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// hash table slots probed for one key
+#define SHARED_PROBES 8
+// ring bytes per hash table slot
+#define SHARED_BYTES_PER_SLOT 512
+
+namespace node_rfc
+{
+    static const char SHARED_MAGIC[8] = {'N', 'R', 'F', 'C', 'S', 'H', 'M', 'C'};
+
+    struct SharedHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t slotCount;
+        uint64_t ringSize;
+        std::atomic<uint32_t> ready;   // layout initialized
+        std::atomic<uint32_t> owner;   // pid of the writer, 0: unlocked
+        std::atomic<uint64_t> written; // bytes appended to the ring, reserved before copied
+    };
+
+    struct SharedSlot
+    {
+        std::atomic<uint32_t> seq; // odd while written
+        std::atomic<uint32_t> length;
+        std::atomic<uint64_t> hash;
+        std::atomic<uint64_t> position; // absolute ring position
+        std::atomic<uint64_t> expires;  // epoch milliseconds, 0: empty
+    };
+
+    // record: key length, key, value
+    static const size_t RECORD_HEADER = sizeof(uint32_t);
+
+    static size_t headerSize(void)
+    {
+        return (sizeof(SharedHeader) + 63) & ~(size_t)63;
+    }
+
+    static uint64_t epochMs(void)
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // FNV-1a
+    static uint64_t keyHash(const std::string &key)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < key.size(); i++)
+        {
+            hash ^= (unsigned char)key[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash == 0 ? 1 : hash;
+    }
+
+    SharedStore::SharedStore(void) : header(NULL), slots(NULL), ring(NULL), mapped(0) {}
+
+#ifdef _WIN32
+
+    SharedStore::~SharedStore(void) {}
+
+    bool SharedStore::open(const std::string &path, size_t ringSize, std::string &errorMessage)
+    {
+        errorMessage = "Shared cache not supported on Windows";
+        return false;
+    }
+
+    void SharedStore::lock(void) {}
+    void SharedStore::unlock(void) {}
+
+#else
+
+    SharedStore::~SharedStore(void)
+    {
+        if (header != NULL)
+        {
+            munmap(header, mapped);
+        }
+    }
+
+    bool SharedStore::open(const std::string &path, size_t ringSize, std::string &errorMessage)
+    {
+        // creator sizes and initializes the file, others wait until ready
+        bool creator = true;
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0 && errno == EEXIST)
+        {
+            creator = false;
+            fd = ::open(path.c_str(), O_RDWR);
+        }
+        if (fd < 0)
+        {
+            errorMessage = "Shared cache file could not be opened: " + path;
+            return false;
+        }
+
+        uint32_t slotCount = (uint32_t)(ringSize / SHARED_BYTES_PER_SLOT);
+        slotCount = slotCount < 1024 ? 1024 : slotCount;
+        size_t size = headerSize() + slotCount * sizeof(SharedSlot) + ringSize;
+
+        if (creator && ftruncate(fd, size) != 0)
+        {
+            ::close(fd);
+            unlink(path.c_str());
+            errorMessage = "Shared cache file could not be sized: " + path;
+            return false;
+        }
+
+        struct stat st;
+        for (int i = 0; !creator; i++)
+        {
+            if (fstat(fd, &st) == 0 && (size_t)st.st_size >= headerSize())
+            {
+                size = st.st_size;
+                break;
+            }
+            if (i == 5000)
+            {
+                ::close(fd);
+                errorMessage = "Shared cache file not initialized: " + path;
+                return false;
+            }
+            usleep(1000);
+        }
+
+        void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+        {
+            errorMessage = "Shared cache file could not be mapped: " + path;
+            return false;
+        }
+        header = (SharedHeader *)map;
+        mapped = size;
+
+        if (creator)
+        {
+            memcpy(header->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC));
+            header->version = NODERFC_SHARED_VERSION;
+            header->slotCount = slotCount;
+            header->ringSize = ringSize;
+            header->written.store(0);
+            header->owner.store(0);
+            header->ready.store(1, std::memory_order_release);
+        }
+        else
+        {
+            for (int i = 0; header->ready.load(std::memory_order_acquire) == 0; i++)
+            {
+                if (i == 5000)
+                {
+                    errorMessage = "Shared cache file not initialized: " + path;
+                    return false;
+                }
+                usleep(1000);
+            }
+            if (memcmp(header->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC)) != 0 || header->version != NODERFC_SHARED_VERSION ||
+                headerSize() + header->slotCount * sizeof(SharedSlot) + header->ringSize != size)
+            {
+                errorMessage = "Invalid shared cache file: " + path;
+                return false;
+            }
+        }
+
+        slots = (SharedSlot *)((char *)header + headerSize());
+        ring = (char *)(slots + header->slotCount);
+        return true;
+    }
+
+    void SharedStore::lock(void)
+    {
+        uint32_t self = (uint32_t)getpid();
+        for (unsigned int spins = 1;; spins++)
+        {
+            uint32_t owner = 0;
+            if (header->owner.compare_exchange_weak(owner, self, std::memory_order_acquire))
+            {
+                return;
+            }
+            // lock of a terminated process released
+            if (owner != 0 && owner != self && spins % 1024 == 0 && kill((pid_t)owner, 0) != 0 && errno == ESRCH)
+            {
+                header->owner.compare_exchange_strong(owner, 0);
+            }
+            sched_yield();
+        }
+    }
+
+    void SharedStore::unlock(void)
+    {
+        header->owner.store(0, std::memory_order_release);
+    }
+
+#endif
+
+    bool SharedStore::readSlot(SharedSlot *slot, uint64_t *hash, uint64_t *position, uint32_t *length, uint64_t *expires)
+    {
+        for (int attempt = 0; attempt < 16; attempt++)
+        {
+            uint32_t seq = slot->seq.load(std::memory_order_acquire);
+            if (seq & 1)
+            {
+                continue;
+            }
+            *hash = slot->hash.load(std::memory_order_relaxed);
+            *position = slot->position.load(std::memory_order_relaxed);
+            *length = slot->length.load(std::memory_order_relaxed);
+            *expires = slot->expires.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) == seq)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void SharedStore::writeSlot(SharedSlot *slot, uint64_t hash, uint64_t position, uint32_t length, uint64_t expires)
+    {
+        uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+        slot->seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot->hash.store(hash, std::memory_order_relaxed);
+        slot->position.store(position, std::memory_order_relaxed);
+        slot->length.store(length, std::memory_order_relaxed);
+        slot->expires.store(expires, std::memory_order_relaxed);
+        slot->seq.store(seq + 2, std::memory_order_release);
+    }
+
+    int SharedStore::get(const std::string &key, std::string &value)
+    {
+        uint64_t hash = keyHash(key);
+        uint64_t ringSize = header->ringSize;
+        uint64_t slotHash, position, expires;
+        uint32_t length;
+        std::string record;
+
+        for (uint32_t i = 0; i < SHARED_PROBES; i++)
+        {
+            SharedSlot *slot = &slots[(hash + i) % header->slotCount];
+            if (!readSlot(slot, &slotHash, &position, &length, &expires) || slotHash != hash || expires == 0)
+            {
+                continue;
+            }
+            if (expires <= epochMs())
+            {
+                return 2;
+            }
+            if (length > ringSize - position % ringSize)
+            {
+                continue;
+            }
+            record.assign(ring + position % ringSize, length);
+            // ring wrapped over the record while copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (header->written.load(std::memory_order_relaxed) > position + ringSize)
+            {
+                return 3;
+            }
+            uint32_t keyLength;
+            memcpy(&keyLength, record.data(), RECORD_HEADER);
+            if (RECORD_HEADER + keyLength <= record.size() && record.compare(RECORD_HEADER, keyLength, key) == 0)
+            {
+                value = record.substr(RECORD_HEADER + keyLength);
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    bool SharedStore::set(const std::string &key, const char *data, size_t length, uint64_t ttl)
+    {
+        uint64_t hash = keyHash(key);
+        uint64_t ringSize = header->ringSize;
+        size_t recordLength = RECORD_HEADER + key.size() + length;
+        if (recordLength > ringSize / 2)
+        {
+            return false;
+        }
+
+        lock();
+
+        // space reserved before copied, for readers to detect overwritten records
+        uint64_t position = header->written.load(std::memory_order_relaxed);
+        if (position % ringSize + recordLength > ringSize)
+        {
+            position += ringSize - position % ringSize;
+        }
+        header->written.store(position + recordLength, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        char *record = ring + position % ringSize;
+        uint32_t keyLength = (uint32_t)key.size();
+        memcpy(record, &keyLength, RECORD_HEADER);
+        memcpy(record + RECORD_HEADER, key.data(), key.size());
+        memcpy(record + RECORD_HEADER + key.size(), data, length);
+
+        // same key, else empty or expired, else oldest slot replaced
+        uint64_t now = epochMs();
+        SharedSlot *target = NULL;
+        uint64_t oldest = UINT64_MAX;
+        for (uint32_t i = 0; i < SHARED_PROBES; i++)
+        {
+            SharedSlot *slot = &slots[(hash + i) % header->slotCount];
+            uint64_t slotHash = slot->hash.load(std::memory_order_relaxed);
+            uint64_t slotPosition = slot->position.load(std::memory_order_relaxed);
+            uint64_t slotExpires = slot->expires.load(std::memory_order_relaxed);
+            if (slotHash == hash)
+            {
+                target = slot;
+                break;
+            }
+            if (slotExpires <= now || slotPosition + ringSize < position)
+            {
+                slotPosition = 0;
+            }
+            if (slotPosition < oldest)
+            {
+                oldest = slotPosition;
+                target = slot;
+            }
+        }
+        writeSlot(target, hash, position, (uint32_t)recordLength, now + ttl);
+
+        unlock();
+        return true;
+    }
+
+    bool SharedStore::remove(const std::string &key)
+    {
+        uint64_t hash = keyHash(key);
+        bool removed = false;
+        lock();
+        for (uint32_t i = 0; i < SHARED_PROBES; i++)
+        {
+            SharedSlot *slot = &slots[(hash + i) % header->slotCount];
+            if (slot->hash.load(std::memory_order_relaxed) == hash)
+            {
+                writeSlot(slot, 0, 0, 0, 0);
+                removed = true;
+            }
+        }
+        unlock();
+        return removed;
+    }
+
+    void SharedStore::clear(void)
+    {
+        lock();
+        for (uint32_t i = 0; i < header->slotCount; i++)
+        {
+            if (slots[i].expires.load(std::memory_order_relaxed) != 0)
+            {
+                writeSlot(&slots[i], 0, 0, 0, 0);
+            }
+        }
+        unlock();
+    }
+
+    size_t SharedStore::entries(void)
+    {
+        uint64_t now = epochMs();
+        uint64_t written = header->written.load(std::memory_order_relaxed);
+        size_t count = 0;
+        for (uint32_t i = 0; i < header->slotCount; i++)
+        {
+            uint64_t expires = slots[i].expires.load(std::memory_order_relaxed);
+            uint64_t position = slots[i].position.load(std::memory_order_relaxed);
+            if (expires > now && position + header->ringSize >= written)
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    size_t SharedStore::bytes(void)
+    {
+        uint64_t written = header->written.load(std::memory_order_relaxed);
+        return (size_t)(written < header->ringSize ? written : header->ringSize);
+    }
+
+} // namespace node_rfc
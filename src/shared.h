@@ -0,0 +1,64 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+
+#ifndef NODE_SAPNWRFC_SHARED_H_
+#define NODE_SAPNWRFC_SHARED_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#define NODERFC_SHARED_VERSION 1
+
+namespace node_rfc
+{
+    struct SharedHeader;
+    struct SharedSlot;
+
+    // Memory mapped store shared by processes on one host
+    //
+    // Records are appended to a ring and indexed by a hash table of slots.
+    // Readers take no lock: slots are read under a sequence counter and a
+    // record copy is discarded when the ring has wrapped over it meanwhile.
+    // Writers are serialized by a spin lock in the mapping, owned by a pid.
+    class SharedStore
+    {
+    public:
+        SharedStore(void);
+        ~SharedStore(void);
+
+        bool open(const std::string &path, size_t ringSize, std::string &errorMessage);
+        // 0: found, 1: not found, 2: expired, 3: overwritten
+        int get(const std::string &key, std::string &value);
+        bool set(const std::string &key, const char *data, size_t length, uint64_t ttl);
+        bool remove(const std::string &key);
+        void clear(void);
+        size_t entries(void);
+        size_t bytes(void);
+
+    private:
+        void lock(void);
+        void unlock(void);
+        bool readSlot(SharedSlot *slot, uint64_t *hash, uint64_t *position, uint32_t *length, uint64_t *expires);
+        void writeSlot(SharedSlot *slot, uint64_t hash, uint64_t position, uint32_t length, uint64_t expires);
+
+        SharedHeader *header;
+        SharedSlot *slots;
+        char *ring;
+        size_t mapped;
+    };
+} // namespace node_rfc
+
+#endif // NODE_SAPNWRFC_SHARED_H_
@@ -0,0 +1,147 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#include "Client.h"
+#include "noderfcsdk.h"
+#include "macros.h"
+
+namespace node_rfc
+{
+    ////////////////////////////////////////////////////////////////////////////////
+    // Result tables converted in slices
+    //
+    // Rows converted until the client slice time is used up, the next slice
+    // scheduled with setImmediate(), after pending I/O callbacks. The callback
+    // is called with the complete result, after the last slice.
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void Client::sliceResult(ResultSlices *slices)
+    {
+        Napi::HandleScope scope(Env());
+        Napi::Value error = Env().Undefined();
+        bool done;
+
+        // errors of a slice, from JS conversion functions too, passed to the callback
+        try
+        {
+            done = wrapSlice(slices);
+        }
+        catch (const Napi::Error &e)
+        {
+            error = e.Value();
+            done = true;
+        }
+        if (error.IsUndefined() && Env().IsExceptionPending())
+        {
+            error = Env().GetAndClearPendingException().Value();
+            done = true;
+        }
+
+        if (!done)
+        {
+            Napi::Function next = Napi::Function::New(
+                Env(), [this](const Napi::CallbackInfo &info) {
+                    sliceResult(static_cast<ResultSlices *>(info.Data()));
+                },
+                "nodeRfcSlice", slices);
+            Env().Global().Get("setImmediate").As<Napi::Function>().Call({next});
+            return;
+        }
+
+        Napi::Value argv[2] = {error, Env().Undefined()};
+        if (error.IsUndefined())
+        {
+            if (slices->errorInfo.code != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &slices->errorInfo);
+            }
+            else
+            {
+                argv[1] = slices->result.Value();
+            }
+        }
+        RfcDestroyFunction(slices->functionHandle, NULL);
+        Napi::Function callback = slices->callback.Value();
+        delete slices;
+        CALLBACK_CALL(Env().Global(), callback, 2, argv)
+    }
+
+    // false: time used up, rows left
+    bool Client::wrapSlice(ResultSlices *slices)
+    {
+        uint64_t expires = uv_hrtime() + (uint64_t)__slice * 1000000;
+        Napi::Object result = slices->result.Value();
+
+        while (slices->current < slices->tables.size())
+        {
+            RFC_PARAMETER_DESC *paramDesc = &slices->tables[slices->current];
+            if (slices->table.IsEmpty())
+            {
+                if (RfcGetTable(slices->functionHandle, paramDesc->name, &slices->tableHandle, &slices->errorInfo) != RFC_OK ||
+                    RfcGetRowCount(slices->tableHandle, &slices->row, &slices->errorInfo) != RFC_OK)
+                {
+                    return true;
+                }
+                slices->table = Napi::Persistent(Napi::Array::New(Env()).As<Napi::Object>());
+                slices->strings = Napi::Persistent(Napi::Array::New(Env()).As<Napi::Object>());
+                slices->intern.count = 0;
+                slices->intern.columns.clear();
+                slices->rowType.slab = Napi::ArrayBuffer();
+                if (__bytes == NODERFC_BYTES_VIEW && rowTemplate(paramDesc->typeDescHandle, &slices->rowType, &slices->errorInfo))
+                {
+                    rowSlab(&slices->rowType, slices->row);
+                    if (!slices->rowType.slab.IsEmpty())
+                    {
+                        slices->slab = Napi::Persistent(slices->rowType.slab.As<Napi::Object>());
+                    }
+                }
+            }
+            Napi::Array table = slices->table.Value().As<Napi::Array>();
+
+            // field names created again in this slice's scope, interned strings kept
+            slices->rowType.intern = NULL;
+            if (__intern)
+            {
+                slices->intern.strings = slices->strings.Value().As<Napi::Array>();
+                slices->rowType.intern = &slices->intern;
+            }
+            if (!rowTemplate(paramDesc->typeDescHandle, &slices->rowType, &slices->errorInfo))
+            {
+                return true;
+            }
+            slices->rowType.slab = slices->slab.IsEmpty() ? Napi::ArrayBuffer() : slices->slab.Value().As<Napi::ArrayBuffer>();
+
+            while (slices->row > 0)
+            {
+                slices->row--;
+                RfcMoveTo(slices->tableHandle, slices->row, NULL);
+                Napi::Value row = wrapRow(&slices->rowType, slices->tableHandle);
+                RfcDeleteCurrentRow(slices->tableHandle, NULL);
+                table.Set(slices->row, row);
+                if (slices->row > 0 && slices->row % NODERFC_SLICE_ROWS == 0 && uv_hrtime() >= expires)
+                {
+                    return false;
+                }
+            }
+
+            result.Set(wrapString(Env(), paramDesc->name), table);
+            slices->table.Reset();
+            slices->strings.Reset();
+            slices->slab.Reset();
+            slices->current++;
+        }
+        return true;
+    }
+
+} // namespace node_rfc
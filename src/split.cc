@@ -0,0 +1,264 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Client.h"
+#include "noderfcsdk.h"
+
+namespace node_rfc
+{
+    ////////////////////////////////////////////////////////////////////////////////
+    // Fixed-width lines split into fields, RFC_READ_TABLE pattern
+    //
+    // data:   table with one character-like line field, DATA WA
+    // fields: FIELDNAME, OFFSET, LENGTH, TYPE rows, FIELDS table or option
+    //
+    // Cells trimmed and converted to UTF-8 on the worker thread, while the lines
+    // are read. Line table rows released after the split.
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static bool splitHandle(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, const std::string &name, RFC_TABLE_HANDLE *tableHandle, RFC_TYPE_DESC_HANDLE *typeDesc, std::string &errorMessage, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_PARAMETER_DESC paramDesc;
+        std::vector<SAP_UC> paramName(name.size() + 1, 0);
+        unsigned int paramNameSize = (unsigned int)paramName.size();
+        unsigned int resultLen = 0;
+
+        if (RfcUTF8ToSAPUC((RFC_BYTE *)name.c_str(), (unsigned int)name.size(), &paramName[0], &paramNameSize, &resultLen, errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+        RFC_RC rc = RfcGetParameterDescByName(functionDescHandle, &paramName[0], &paramDesc, errorInfo);
+        if (rc == RFC_OK && paramDesc.type != RFCTYPE_TABLE)
+        {
+            errorMessage = "Table parameter expected for split: " + name;
+            return false;
+        }
+        *typeDesc = paramDesc.typeDescHandle;
+        return rc == RFC_OK && RfcGetTable(functionHandle, &paramName[0], tableHandle, errorInfo) == RFC_OK;
+    }
+
+    static bool splitLayout(RFC_TABLE_HANDLE fieldsTable, std::vector<SplitField> &fields, RFC_ERROR_INFO *errorInfo)
+    {
+        unsigned int rowCount;
+        SAP_UC name[31];
+        SAP_UC type[1];
+        RFC_INT offset;
+        RFC_INT length;
+
+        if (RfcGetRowCount(fieldsTable, &rowCount, errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+        fields.resize(rowCount);
+        for (unsigned int i = 0; i < rowCount; i++)
+        {
+            memsetU((SAP_UTF16 *)name, 0, 31);
+            if (RfcMoveTo(fieldsTable, i, errorInfo) != RFC_OK ||
+                RfcGetChars(fieldsTable, cU("FIELDNAME"), name, 30, errorInfo) != RFC_OK ||
+                RfcGetInt(fieldsTable, cU("OFFSET"), &offset, errorInfo) != RFC_OK ||
+                RfcGetInt(fieldsTable, cU("LENGTH"), &length, errorInfo) != RFC_OK ||
+                RfcGetChars(fieldsTable, cU("TYPE"), type, 1, errorInfo) != RFC_OK ||
+                !utf8String(name, -1, fields[i].name, errorInfo))
+            {
+                return false;
+            }
+            fields[i].offset = offset < 0 ? 0 : (unsigned int)offset;
+            fields[i].length = length < 0 ? 0 : (unsigned int)length;
+            fields[i].type = type[0] < 0x80 ? (char)type[0] : ' ';
+        }
+        return true;
+    }
+
+    bool Client::splitTable(RFC_FUNCTION_DESC_HANDLE functionDescHandle, RFC_FUNCTION_HANDLE functionHandle, InvokeOptions &options, SplitTable &split, std::string &errorMessage, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_TABLE_HANDLE dataTable;
+        RFC_TYPE_DESC_HANDLE typeDesc;
+        RFC_FIELD_DESC lineDesc;
+        std::string cell;
+
+        if (!splitHandle(functionDescHandle, functionHandle, options.split, &dataTable, &typeDesc, errorMessage, errorInfo))
+        {
+            return false;
+        }
+
+        split.fields = options.splitLayout;
+        if (split.fields.empty())
+        {
+            RFC_TABLE_HANDLE fieldsTable;
+            RFC_TYPE_DESC_HANDLE fieldsDesc;
+            if (!splitHandle(functionDescHandle, functionHandle, options.splitFields, &fieldsTable, &fieldsDesc, errorMessage, errorInfo) ||
+                !splitLayout(fieldsTable, split.fields, errorInfo))
+            {
+                return false;
+            }
+        }
+
+        // line is the first field, WA of RFC_READ_TABLE
+        if (RfcGetFieldDescByIndex(typeDesc, 0, &lineDesc, errorInfo) != RFC_OK ||
+            RfcGetRowCount(dataTable, &split.rowCount, errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+        if (lineDesc.type != RFCTYPE_CHAR && lineDesc.type != RFCTYPE_NUM)
+        {
+            errorMessage = "Character line expected for split: " + options.split;
+            return false;
+        }
+
+        std::vector<SAP_UC> line(lineDesc.nucLength > 0 ? lineDesc.nucLength : 1);
+        split.ends.reserve((size_t)split.rowCount * split.fields.size());
+        for (unsigned int row = 0; row < split.rowCount; row++)
+        {
+            if (RfcMoveTo(dataTable, row, errorInfo) != RFC_OK ||
+                RfcGetCharsByIndex(dataTable, 0, &line[0], lineDesc.nucLength, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < split.fields.size(); i++)
+            {
+                // bounded by the line, leading blanks skipped, trailing removed with the conversion
+                unsigned int begin = split.fields[i].offset < lineDesc.nucLength ? split.fields[i].offset : lineDesc.nucLength;
+                unsigned int end = split.fields[i].length < lineDesc.nucLength - begin ? begin + split.fields[i].length : lineDesc.nucLength;
+                while (begin < end && line[begin] == 0x20)
+                {
+                    begin++;
+                }
+                if (!utf8String(&line[begin], (int)(end - begin), cell, errorInfo))
+                {
+                    return false;
+                }
+                split.text += cell;
+                split.ends.push_back(split.text.size());
+            }
+        }
+
+        RfcDeleteAllRows(dataTable, NULL);
+        return true;
+    }
+
+    static bool splitNumeric(char type)
+    {
+        // ABAP types of RFC_READ_TABLE FIELDS: I, b, s, 8 integers, P packed, F float, a, e decfloat
+        return type != 0 && strchr("Ibs8PFae", type) != NULL;
+    }
+
+    static double splitNumber(const char *text, size_t length)
+    {
+        // WRITE formatted, sign after the number
+        std::string number(text, length);
+        bool negative = !number.empty() && number[number.size() - 1] == '-';
+        if (negative)
+        {
+            number.erase(number.size() - 1);
+        }
+        double value = strtod(number.c_str(), NULL);
+        return negative ? -value : value;
+    }
+
+    Napi::Value Client::splitValue(SplitTable &split, size_t field, size_t begin, size_t end, bool convert)
+    {
+        const char *text = split.text.data() + begin;
+        size_t length = end - begin;
+        if (convert)
+        {
+            char type = split.fields[field].type;
+            if (splitNumeric(type))
+            {
+                return Napi::Number::New(Env(), splitNumber(text, length));
+            }
+            if (type == 'D' && !__dateFromABAP.IsEmpty())
+            {
+                return __dateFromABAP.Call({Napi::String::New(Env(), text, length)});
+            }
+            if (type == 'T' && !__timeFromABAP.IsEmpty())
+            {
+                return __timeFromABAP.Call({Napi::String::New(Env(), text, length)});
+            }
+        }
+        return Napi::String::New(Env(), text, length);
+    }
+
+    Napi::Value Client::wrapSplit(SplitTable &split, bool columns, bool convert)
+    {
+        Napi::EscapableHandleScope scope(Env());
+        size_t fieldCount = split.fields.size();
+        size_t cell = 0;
+
+        if (columns)
+        {
+            // one array per field, Float64Array for converted numbers
+            Napi::Object result = Napi::Object::New(Env());
+            for (size_t i = 0; i < fieldCount; i++)
+            {
+                if (convert && splitNumeric(split.fields[i].type))
+                {
+                    Napi::Float64Array values = Napi::Float64Array::New(Env(), split.rowCount);
+                    for (unsigned int row = 0; row < split.rowCount; row++)
+                    {
+                        cell = (size_t)row * fieldCount + i;
+                        size_t begin = cell == 0 ? 0 : split.ends[cell - 1];
+                        values[row] = splitNumber(split.text.data() + begin, split.ends[cell] - begin);
+                    }
+                    result.Set(split.fields[i].name, values);
+                    continue;
+                }
+                Napi::Array values = Napi::Array::New(Env(), split.rowCount);
+                for (unsigned int row = 0; row < split.rowCount; row++)
+                {
+                    Napi::HandleScope rowScope(Env());
+                    cell = (size_t)row * fieldCount + i;
+                    values.Set(row, splitValue(split, i, cell == 0 ? 0 : split.ends[cell - 1], split.ends[cell], convert));
+                }
+                result.Set(split.fields[i].name, values);
+            }
+            return scope.Escape(result);
+        }
+
+        // row objects, all properties defined at once in field order
+        std::vector<napi_property_descriptor> properties(fieldCount);
+        std::vector<Napi::String> names;
+        for (size_t i = 0; i < fieldCount; i++)
+        {
+            names.push_back(Napi::String::New(Env(), split.fields[i].name));
+            properties[i] = napi_property_descriptor();
+            properties[i].name = names[i];
+            properties[i].attributes = static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable);
+        }
+        Napi::Array rows = Napi::Array::New(Env(), split.rowCount);
+        for (unsigned int row = 0; row < split.rowCount; row++)
+        {
+            Napi::HandleScope rowScope(Env());
+            Napi::Object line = Napi::Object::New(Env());
+            for (size_t i = 0; i < fieldCount; i++, cell++)
+            {
+                properties[i].value = splitValue(split, i, cell == 0 ? 0 : split.ends[cell - 1], split.ends[cell], convert);
+            }
+            if (fieldCount > 0)
+            {
+                napi_status status = napi_define_properties(Env(), line, fieldCount, &properties[0]);
+                if (status != napi_ok)
+                {
+                    Napi::Error::New(Env()).ThrowAsJavaScriptException();
+                }
+            }
+            rows.Set(row, line);
+        }
+        return scope.Escape(rows);
+    }
+
+} // namespace node_rfc
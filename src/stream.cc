@@ -0,0 +1,267 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+
+#include <string>
+#include "Client.h"
+#include "noderfcsdk.h"
+#include "macros.h"
+
+namespace node_rfc
+{
+    ////////////////////////////////////////////////////////////////////////////////
+    // Table streaming, rows encoded in chunks on the worker thread
+    //
+    // ndjson: one JSON object per row, same conventions as the json option
+    // csv:    header line with field names, RFC 4180 quoting, bytes as hex
+    //
+    // JS heap bounded by the chunk size. Rows stay in the SDK table until the
+    // last chunk is read or the stream closed, deleting read rows would move
+    // the rows left for every row streamed.
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static void csvField(std::string &csv, const std::string &text, int kind)
+    {
+        static const char hex[] = "0123456789ABCDEF";
+        if (kind == NODERFC_TEXT_BYTES)
+        {
+            for (size_t i = 0; i < text.size(); i++)
+            {
+                csv += hex[(unsigned char)text[i] >> 4];
+                csv += hex[(unsigned char)text[i] & 0x0F];
+            }
+        }
+        else if (text.find_first_of(",\"\r\n") == std::string::npos)
+        {
+            csv += text;
+        }
+        else
+        {
+            csv += '"';
+            for (size_t i = 0; i < text.size(); i++)
+            {
+                if (text[i] == '"')
+                {
+                    csv += '"';
+                }
+                csv += text[i];
+            }
+            csv += '"';
+        }
+    }
+
+    static bool csvHeader(RFC_TYPE_DESC_HANDLE typeDesc, std::string &csv, std::string &errorMessage, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_FIELD_DESC fieldDesc;
+        unsigned int fieldCount;
+        std::string name;
+
+        if (RfcGetFieldCount(typeDesc, &fieldCount, errorInfo) != RFC_OK)
+        {
+            return false;
+        }
+        for (unsigned int i = 0; i < fieldCount; i++)
+        {
+            if (RfcGetFieldDescByIndex(typeDesc, i, &fieldDesc, errorInfo) != RFC_OK ||
+                !utf8String(fieldDesc.name, -1, name, errorInfo))
+            {
+                return false;
+            }
+            if (fieldDesc.type == RFCTYPE_STRUCTURE || fieldDesc.type == RFCTYPE_TABLE)
+            {
+                errorMessage = "Nested field not supported in CSV stream: " + name;
+                return false;
+            }
+            if (i > 0)
+            {
+                csv += ',';
+            }
+            csvField(csv, name, NODERFC_TEXT_STRING);
+        }
+        csv += '\n';
+        return true;
+    }
+
+    bool Client::streamChunk(TableCursor *cursor, std::string &chunk, std::string &errorMessage, RFC_ERROR_INFO *errorInfo)
+    {
+        RFC_FIELD_DESC fieldDesc;
+        unsigned int fieldCount = 0;
+        std::string text;
+        int kind;
+
+        if (cursor->format == NODERFC_STREAM_CSV)
+        {
+            if (RfcGetFieldCount(cursor->typeDesc, &fieldCount, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            if (cursor->row == 0 && !csvHeader(cursor->typeDesc, chunk, errorMessage, errorInfo))
+            {
+                return false;
+            }
+        }
+
+        while (cursor->row < cursor->rowCount && chunk.size() < NODERFC_STREAM_CHUNK)
+        {
+            if (RfcMoveTo(cursor->tableHandle, cursor->row, errorInfo) != RFC_OK)
+            {
+                return false;
+            }
+            if (cursor->format == NODERFC_STREAM_NDJSON)
+            {
+                if (!jsonStructure(cursor->typeDesc, cursor->tableHandle, chunk, errorInfo))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                for (unsigned int i = 0; i < fieldCount; i++)
+                {
+                    if (RfcGetFieldDescByIndex(cursor->typeDesc, i, &fieldDesc, errorInfo) != RFC_OK ||
+                        !textVariable(fieldDesc.type, cursor->tableHandle, fieldDesc.name, fieldDesc.nucLength, text, &kind, errorInfo))
+                    {
+                        return false;
+                    }
+                    if (i > 0)
+                    {
+                        chunk += ',';
+                    }
+                    csvField(chunk, text, kind);
+                }
+            }
+            chunk += '\n';
+            cursor->row++;
+        }
+        return true;
+    }
+
+    class StreamReadAsync : public Napi::AsyncWorker
+    {
+    public:
+        StreamReadAsync(Napi::Function &callback, Client *client, Napi::External<TableCursor> external)
+            : Napi::AsyncWorker(callback), client(client), cursorRef(Napi::Persistent(external)), cursor(external.Data())
+        {
+            cursor->pending = true;
+            chunk = new std::string();
+        }
+        ~StreamReadAsync()
+        {
+            delete chunk;
+        }
+
+        void Execute()
+        {
+            errorInfo.code = RFC_OK;
+            if (cursor->functionHandle == NULL)
+            {
+                // closed or all rows read
+                return;
+            }
+            chunk->reserve(NODERFC_STREAM_CHUNK + NODERFC_STREAM_CHUNK / 4);
+            if (client->streamChunk(cursor, *chunk, errorMessage, &errorInfo) && cursor->row >= cursor->rowCount)
+            {
+                // table no longer needed, released before the last chunk is consumed
+                RfcDestroyFunction(cursor->functionHandle, NULL);
+                cursor->functionHandle = NULL;
+            }
+        }
+
+        void OnOK()
+        {
+            Napi::Value argv[2] = {Env().Undefined(), Env().Undefined()};
+            cursor->pending = false;
+            cursorRef.Reset();
+
+            if (!errorMessage.empty())
+            {
+                argv[0] = Napi::TypeError::New(Env(), errorMessage).Value();
+            }
+            else if (errorInfo.code != RFC_OK)
+            {
+                argv[0] = wrapError(Env(), &errorInfo);
+            }
+            else if (!chunk->empty())
+            {
+                // not copied, released with the Buffer
+                std::string *data = chunk;
+                chunk = NULL;
+                argv[1] = Napi::Buffer<char>::New(
+                    Env(), &(*data)[0], data->size(),
+                    [](Napi::Env env, char *bytes, std::string *data) { delete data; },
+                    data);
+            }
+            CALLBACK_CALL(Env().Global(), Callback(), 2, argv);
+        }
+
+    private:
+        Client *client;
+        Napi::Reference<Napi::External<TableCursor>> cursorRef;
+        TableCursor *cursor;
+        std::string *chunk;
+        std::string errorMessage;
+        RFC_ERROR_INFO errorInfo;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Client API
+    ////////////////////////////////////////////////////////////////////////////////
+
+    Napi::Value Client::StreamRead(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsExternal())
+        {
+            Napi::TypeError::New(info.Env(), "First argument (stream cursor) must be returned by invoke").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        if (!info[1].IsFunction())
+        {
+            Napi::TypeError::New(info.Env(), "Second argument must be callback function").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::External<TableCursor> external = info[0].As<Napi::External<TableCursor>>();
+        if (external.Data()->pending)
+        {
+            Napi::TypeError::New(info.Env(), "Stream read already pending").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        Napi::Function callback = info[1].As<Napi::Function>();
+
+        (new StreamReadAsync(callback, this, external))->Queue();
+
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Client::StreamClose(const Napi::CallbackInfo &info)
+    {
+        if (!info[0].IsExternal())
+        {
+            Napi::TypeError::New(info.Env(), "First argument (stream cursor) must be returned by invoke").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        TableCursor *cursor = info[0].As<Napi::External<TableCursor>>().Data();
+        if (cursor->pending)
+        {
+            Napi::TypeError::New(info.Env(), "Stream read already pending").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        if (cursor->functionHandle != NULL)
+        {
+            RfcDestroyFunction(cursor->functionHandle, NULL);
+            cursor->functionHandle = NULL;
+        }
+        return info.Env().Undefined();
+    }
+
+} // namespace node_rfc
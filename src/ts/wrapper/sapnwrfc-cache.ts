@@ -0,0 +1,59 @@
+import { binding } from "./sapnwrfc-client";
+import { isUndefined } from "util";
+import { serialize, deserialize } from "v8";
+
+export interface RfcCacheBinding {
+    new (maxBytes?: number, file?: string): RfcCacheBinding;
+    (maxBytes?: number, file?: string): RfcCacheBinding;
+    status: RfcCacheStatus;
+    get(key: string): Buffer | undefined;
+    set(key: string, value: Buffer, ttl: number): boolean;
+    delete(key: string): boolean;
+    clear(): void;
+}
+
+export interface RfcCacheStatus {
+    entries: number;
+    bytes: number;
+    maxBytes: number;
+    hits: number;
+    misses: number;
+    evictions: number;
+    expired: number;
+    shared: boolean;
+}
+
+// values serialized outside of the V8 heap, materialized on every get(),
+// shared by processes of the host when backed by a file
+export class Cache {
+    private __cache: RfcCacheBinding;
+
+    constructor(maxBytes?: number, file?: string) {
+        this.__cache = isUndefined(file)
+            ? isUndefined(maxBytes)
+                ? new binding.Cache()
+                : new binding.Cache(maxBytes)
+            : new binding.Cache(maxBytes, file);
+    }
+
+    get(key: string): any {
+        const data = this.__cache.get(key);
+        return isUndefined(data) ? undefined : deserialize(data);
+    }
+
+    set(key: string, value: any, ttl: number): boolean {
+        return this.__cache.set(key, serialize(value), ttl);
+    }
+
+    delete(key: string): boolean {
+        return this.__cache.delete(key);
+    }
+
+    clear() {
+        this.__cache.clear();
+    }
+
+    get status(): RfcCacheStatus {
+        return this.__cache.status;
+    }
+}
@@ -1,10 +1,22 @@
 var Promise = require("bluebird");
 import { RfcThroughputBinding } from "./sapnwrfc-throughput";
+import { RfcServerBinding } from "./sapnwrfc-server";
+import {
+    RfcTransactionBinding,
+    RfcTransactionOptions,
+    Transaction,
+} from "./sapnwrfc-transaction";
+import { RfcCacheBinding } from "./sapnwrfc-cache";
 import { isUndefined } from "util";
+import * as fs from "fs";
+import { Writable } from "stream";
 
 export interface NWRfcBinding {
     Client: RfcClientBinding;
     Throughput: RfcThroughputBinding;
+    Server: RfcServerBinding;
+    Transaction: RfcTransactionBinding;
+    Cache: RfcCacheBinding;
     verbose(): this;
 }
 
@@ -61,6 +73,9 @@ export interface RfcClientOptions {
     bcd: string | Function;
     date: Function;
     time: Function;
+    intern?: boolean; // repeated short CHAR values of table columns share one string
+    slice?: number; // milliseconds, result tables converted between event loop turns
+    bytes?: string; // BYTE values: "buffer", "view" of one ArrayBuffer per table, "hex" or "base64"
 }
 
 export interface RfcClientBinding {
@@ -72,15 +87,25 @@ export interface RfcClientBinding {
     connect(callback: Function): any;
     invoke(
         rfmName: string,
-        rfmParams: RfcObject,
+        rfmParams: RfcObject | Buffer,
         callback: Function,
         callOptions?: object
     ): any;
+    call(
+        rfmName: string,
+        rfmParams: RfcObject | Buffer,
+        callOptions?: object
+    ): Promise<RfcObject>;
     ping(callback: Function | undefined): void | Promise<void>;
     close(callback: Function | undefined): void | Promise<void>;
     reopen(callback: Function | undefined): void | Promise<void>;
     isAlive(): boolean;
     connectionInfo(): RfcConnectionInfo;
+    exportMetadata(rfmNames: Array<string>, callback: Function): void;
+    importMetadata(snapshot: Buffer, callback: Function): void;
+    streamRead(cursor: any, callback: Function): void;
+    streamClose(cursor: any): void;
+    releaseResult(result: RfcObject): void;
     id: number;
     _connectionHandle: number;
     version: RfcClientVersion;
@@ -105,7 +130,31 @@ enum EnumTrace {
 
 export interface RfcCallOptions {
     notRequested?: Array<String>;
+    json?: boolean;
+    arrow?: Array<string>;
+    arrowDictionary?: boolean;
+    stream?: string;
+    streamFormat?: string;
+    split?: boolean | string;
+    splitFields?: string | Array<RfcSplitField>;
+    splitColumns?: boolean;
+    splitConvert?: boolean;
+    lazy?: boolean; // parameters decoded on first access
     timeout?: number;
+    deadline?: number | Date;
+}
+
+export interface RfcSplitField {
+    FIELDNAME: string;
+    OFFSET: number | string;
+    LENGTH: number | string;
+    TYPE?: string;
+}
+
+export interface RfcStreamOptions {
+    format?: string; // "ndjson" or "csv"
+    end?: boolean; // writable ended after the last row, default true
+    callOptions?: RfcCallOptions;
 }
 
 export interface RfcConnectionParameters {
@@ -163,11 +212,16 @@ export type RfcStructure = {
     [key: string]: RfcVariable | RfcStructure | RfcTable;
 };
 export type RfcTable = Array<RfcStructure>;
+// table by columns of equal length, Buffer with newline delimited UTF-8 values
+export type RfcColumns = {
+    [field: string]: RfcArray | Float64Array | Int32Array | Buffer;
+};
 export type RfcParameterValue =
     | RfcVariable
     | RfcArray
     | RfcStructure
-    | RfcTable;
+    | RfcTable
+    | RfcColumns;
 export type RfcObject = { [key: string]: RfcParameterValue };
 
 export interface RfcClientStatus {
@@ -257,66 +311,12 @@ export class Client {
 
     call(
         rfmName: string,
-        rfmParams: RfcObject,
-        callOptions: RfcCallOptions = {}
+        rfmParams: RfcObject | Buffer,
+        callOptions?: RfcCallOptions
     ): Promise<RfcObject> {
-        return new Promise((resolve, reject) => {
-            if (arguments.length < 2) {
-                reject(
-                    new TypeError(
-                        "Please provide remote function module name and parameters as arguments"
-                    )
-                );
-            }
-
-            if (typeof rfmName !== "string") {
-                reject(
-                    new TypeError(
-                        "First argument (remote function module name) must be an string"
-                    )
-                );
-            }
-
-            if (typeof rfmParams !== "object") {
-                reject(
-                    new TypeError(
-                        "Second argument (remote function module parameters) must be an object"
-                    )
-                );
-            }
-
-            if (arguments.length === 3 && typeof callOptions !== "object") {
-                reject(
-                    new TypeError("Call options argument must be an object")
-                );
-            }
-
-            this.__status.lastcall = Date.now();
-            try {
-                if (!this.__client.isAlive()) {
-                    reject(
-                        new Error(
-                            "Client invoked RFC call with closed connection: id=" +
-                                this.__client.id
-                        )
-                    );
-                }
-                this.__client.invoke(
-                    rfmName,
-                    rfmParams,
-                    (err: any, res: RfcObject) => {
-                        if (!isUndefined(err)) {
-                            reject(err);
-                        } else {
-                            resolve(res);
-                        }
-                    },
-                    callOptions
-                );
-            } catch (ex) {
-                reject(ex);
-            }
-        });
+        // arguments validated and promise settled by the binding
+        this.__status.lastcall = Date.now();
+        return this.__client.call(rfmName, rfmParams, callOptions);
     }
 
     connect(callback: Function) {
@@ -326,7 +326,7 @@ export class Client {
 
     invoke(
         rfmName: string,
-        rfmParams: RfcObject,
+        rfmParams: RfcObject | Buffer,
         callback: Function,
         callOptions?: object
     ) {
@@ -406,6 +406,160 @@ export class Client {
         }
     }
 
+    exportMetadata(rfmNames: Array<string>, file?: string): Promise<Buffer> {
+        return new Promise((resolve, reject) => {
+            try {
+                this.__client.exportMetadata(
+                    rfmNames,
+                    (err: any, snapshot: Buffer) => {
+                        if (!isUndefined(err)) {
+                            reject(err);
+                        } else if (isUndefined(file)) {
+                            resolve(snapshot);
+                        } else {
+                            fs.writeFile(file, snapshot, (err) => {
+                                if (err) {
+                                    reject(err);
+                                } else {
+                                    resolve(snapshot);
+                                }
+                            });
+                        }
+                    }
+                );
+            } catch (ex) {
+                reject(ex);
+            }
+        });
+    }
+
+    importMetadata(snapshot: Buffer | string): Promise<number> {
+        return new Promise((resolve, reject) => {
+            const load = (buffer: Buffer) => {
+                try {
+                    this.__client.importMetadata(
+                        buffer,
+                        (err: any, count: number) => {
+                            if (!isUndefined(err)) {
+                                reject(err);
+                            } else {
+                                resolve(count);
+                            }
+                        }
+                    );
+                } catch (ex) {
+                    reject(ex);
+                }
+            };
+            if (typeof snapshot === "string") {
+                fs.readFile(snapshot, (err, data) => {
+                    if (err) {
+                        reject(err);
+                    } else {
+                        load(data);
+                    }
+                });
+            } else {
+                load(snapshot);
+            }
+        });
+    }
+
+    streamTable(
+        rfmName: string,
+        rfmParams: RfcObject | Buffer,
+        tableName: string,
+        writable: Writable,
+        streamOptions: RfcStreamOptions = {}
+    ): Promise<RfcObject> {
+        return new Promise((resolve, reject) => {
+            const callOptions = Object.assign({}, streamOptions.callOptions, {
+                stream: tableName,
+                streamFormat: streamOptions.format || "ndjson",
+            });
+            this.__status.lastcall = Date.now();
+            try {
+                this.__client.invoke(
+                    rfmName,
+                    rfmParams,
+                    (err: any, res: RfcObject, cursor: any) => {
+                        if (!isUndefined(err)) {
+                            reject(err);
+                            return;
+                        }
+                        let failed: any;
+                        let draining = false;
+                        const done = (err?: any) => {
+                            writable.removeListener("error", onError);
+                            if (!isUndefined(err)) {
+                                this.__client.streamClose(cursor);
+                                reject(err);
+                            } else {
+                                if (streamOptions.end !== false) writable.end();
+                                resolve(res);
+                            }
+                        };
+                        const onError = (err: any) => {
+                            failed = err;
+                            if (draining) {
+                                writable.removeListener("drain", pump);
+                                done(err);
+                            }
+                        };
+                        // next chunk read when the writable is drained
+                        const pump = () => {
+                            draining = false;
+                            this.__client.streamRead(
+                                cursor,
+                                (err: any, chunk: Buffer) => {
+                                    if (!isUndefined(err)) {
+                                        done(err);
+                                    } else if (!isUndefined(failed)) {
+                                        done(failed);
+                                    } else if (isUndefined(chunk)) {
+                                        done();
+                                    } else if (writable.write(chunk)) {
+                                        pump();
+                                    } else {
+                                        draining = true;
+                                        writable.once("drain", pump);
+                                    }
+                                }
+                            );
+                        };
+                        writable.on("error", onError);
+                        pump();
+                    },
+                    callOptions
+                );
+            } catch (ex) {
+                reject(ex);
+            }
+        });
+    }
+
+    // function handle of a lazy result released, parameters not accessed yet lost
+    releaseResult(result: RfcObject) {
+        this.__client.releaseResult(result);
+    }
+
+    transaction(options: RfcTransactionOptions = {}): Transaction {
+        return new Transaction(this, options);
+    }
+
+    queue(queueName: string, options: RfcTransactionOptions = {}): Transaction {
+        if (typeof queueName !== "string")
+            throw new TypeError("Queue name must be a string");
+        return new Transaction(
+            this,
+            Object.assign({}, options, { queue: queueName })
+        );
+    }
+
+    unit(options: RfcTransactionOptions = {}): Transaction {
+        return new Transaction(this, Object.assign({}, options, { unit: true }));
+    }
+
     get isAlive(): boolean {
         return this.__client.isAlive();
     }
@@ -422,6 +576,10 @@ export class Client {
         return this.__client._connectionHandle;
     }
 
+    get _client(): RfcClientBinding {
+        return this.__client;
+    }
+
     get status(): RfcClientStatus {
         return this.__status;
     }
@@ -4,14 +4,189 @@ import {
     Client,
     RfcConnectionParameters,
     RfcClientOptions,
+    RfcCallOptions,
+    RfcObject,
 } from "./sapnwrfc-client";
+import { Cache } from "./sapnwrfc-cache";
+import { Throughput } from "./sapnwrfc-throughput";
 import { isUndefined } from "util";
+import { createHash } from "crypto";
+import { Writable } from "stream";
 import { reject } from "bluebird";
 export { Promise };
 
+export interface RfcPoolClassOptions {
+    priority?: number; // higher priority classes served first, default 0
+    reserved?: number; // connections other classes cannot take, default 0
+}
+
 export interface RfcPoolOptions {
     min: number;
-    //max: number;
+    max?: number; // acquire() requests queued when reached, default unlimited
+    queueMax?: number; // acquire() rejected when more requests queued
+    coalesce?: Array<string>; // read-only RFMs, identical concurrent calls shared
+    cache?: { [rfmName: string]: number }; // read-only RFMs, result TTL milliseconds
+    cacheMaxBytes?: number; // default 64 MB
+    cacheFile?: string; // cache shared by processes of the host, memory mapped
+    metadata?: Array<string>; // RFMs metadata snapshot shared via the cache
+    throughput?: boolean; // one Throughput set on all pooled connections
+    classes?: { [name: string]: RfcPoolClassOptions };
+}
+
+export interface RfcAcquireOptions {
+    class?: string; // priority class, default "default"
+    tenant?: string; // weighted fair queuing between tenants of one class
+    weight?: number; // tenant weight, default 1
+    timeout?: number; // milliseconds, request dropped when waiting longer
+    deadline?: number | Date;
+}
+
+export interface RfcPoolSaturation {
+    inUse: number;
+    max?: number;
+    queued: number;
+    queueMax?: number;
+    oldestWait: number; // milliseconds
+}
+
+export interface RfcPoolClassStatus {
+    priority: number;
+    reserved: number;
+    queued: number;
+    inUse: number;
+    acquired: number;
+    waitTotal: number; // milliseconds
+    waitMax: number;
+}
+
+export interface RfcExtractOptions {
+    table?: string; // result table with the rows, default "DATA"
+    partitions?: Array<RfcObject>; // parameters per partition, key ranges for example
+    window?: number; // rows per partition, windows called until a short one
+    windowParams?: Array<string>; // default ["ROWSKIPS", "ROWCOUNT"]
+    parallel?: number; // partitions running or buffered, default 4
+    ordered?: boolean; // rows written in partition order, default false
+    retries?: number; // calls repeated per partition, default 2
+    end?: boolean; // writable ended after the last partition, default true
+    callOptions?: RfcCallOptions;
+    acquireOptions?: RfcAcquireOptions;
+    progress?: (progress: RfcExtractProgress) => void;
+}
+
+export interface RfcExtractProgress {
+    partition: number; // last written
+    rows: number; // rows of the last written partition
+    done: number; // partitions written
+    partitions?: number; // windows: unknown until a short one returned
+    total: number; // rows written
+    retries: number;
+}
+
+interface PoolWaiter {
+    className: string;
+    finish: number; // WFQ virtual finish time
+    seq: number;
+    queued: number;
+    timer?: NodeJS.Timeout;
+    resolve: (arg: Client) => void;
+    reject: (arg: any) => void;
+}
+
+interface PoolClass {
+    priority: number;
+    reserved: number;
+    inUse: number;
+    virtualTime: number;
+    tenants: Map<string, number>; // tenant's last virtual finish time
+    queue: Array<PoolWaiter>;
+    acquired: number;
+    waitTotal: number;
+    waitMax: number;
+}
+
+// shared metadata snapshot refreshed daily
+const METADATA_TTL = 24 * 60 * 60 * 1000;
+
+// absolute deadline in epoch milliseconds, from timeout and deadline options
+function deadline(options: {
+    timeout?: number;
+    deadline?: number | Date;
+}): number | undefined {
+    let expires: number | undefined;
+    if (typeof options.timeout === "number")
+        expires = Date.now() + options.timeout;
+    if (!isUndefined(options.deadline)) {
+        const time =
+            options.deadline instanceof Date
+                ? options.deadline.getTime()
+                : options.deadline;
+        expires = isUndefined(expires) ? time : Math.min(expires, time);
+    }
+    return expires;
+}
+
+// RFM name and hash of canonical parameters and result relevant call options
+function requestKey(
+    rfmName: string,
+    rfmParams: RfcObject | Buffer,
+    callOptions: RfcCallOptions
+): string {
+    const options = Object.assign({}, callOptions);
+    delete options.timeout;
+    delete options.deadline;
+    const hash = createHash("sha256")
+        .update(Buffer.isBuffer(rfmParams) ? rfmParams : canonical(rfmParams))
+        .update(canonical(options))
+        .digest("base64");
+    return `${rfmName}:${hash}`;
+}
+
+// canonical JSON, object keys sorted, Buffers and Dates as strings
+function canonical(value: any): string {
+    if (Buffer.isBuffer(value)) return `"${value.toString("base64")}"`;
+    if (value instanceof Date) return `"${value.toISOString()}"`;
+    if (Array.isArray(value)) return `[${value.map(canonical).join(",")}]`;
+    if (value !== null && typeof value === "object")
+        return `{${Object.keys(value)
+            .sort()
+            .map((key) => `${JSON.stringify(key)}:${canonical(value[key])}`)
+            .join(",")}}`;
+    return JSON.stringify(value);
+}
+
+// partition parameters over base parameters, OPTIONS predicates of both combined
+function partitionParams(
+    rfmParams: RfcObject,
+    partition: RfcObject
+): RfcObject {
+    const params = Object.assign({}, rfmParams, partition);
+    const base = rfmParams.OPTIONS;
+    const range = partition.OPTIONS;
+    if (Array.isArray(base) && base.length > 0 && Array.isArray(range))
+        params.OPTIONS = [
+            { TEXT: "(" },
+            ...(base as Array<RfcObject>),
+            { TEXT: ") AND (" },
+            ...(range as Array<RfcObject>),
+            { TEXT: ")" },
+        ];
+    return params;
+}
+
+// rows of a table result, or of split columns
+function rowCount(rows: any): number {
+    if (Array.isArray(rows)) return rows.length;
+    if (rows !== null && typeof rows === "object") {
+        const columns = Object.keys(rows);
+        return columns.length > 0 ? rows[columns[0]].length : 0;
+    }
+    return 0;
+}
+
+function poolError(name: string, message: string): Error {
+    const error = new Error(message);
+    error.name = name;
+    return error;
 }
 
 export class Pool {
@@ -19,6 +194,16 @@ export class Pool {
     private __poolOptions: RfcPoolOptions;
     private __clientOptions: RfcClientOptions | undefined;
     private __fillRequests: number;
+    private __classes: Map<string, PoolClass>;
+    private __leases: Map<number, string>;
+    private __seq: number;
+    private __coalesce: Set<string>;
+    private __inFlight: Map<string, Promise<RfcObject>>;
+    private __coalesced: number;
+    private __cache: Cache | undefined;
+    private __warm: Promise<void> | undefined;
+    private __throughput: Throughput | undefined;
+    private __metered: WeakMap<Client, number>; // connection handle
     private static Ready: Array<Client> = [];
     private static Active: Map<number, Client> = new Map();
 
@@ -34,6 +219,26 @@ export class Pool {
         this.__poolOptions = poolOptions;
         this.__clientOptions = clientOptions;
         this.__fillRequests = 0;
+        this.__classes = new Map();
+        this.__leases = new Map();
+        this.__seq = 0;
+        this.__coalesce = new Set(poolOptions.coalesce || []);
+        this.__inFlight = new Map();
+        this.__coalesced = 0;
+        if (
+            !isUndefined(poolOptions.cache) ||
+            !isUndefined(poolOptions.cacheFile) ||
+            !isUndefined(poolOptions.metadata)
+        )
+            this.__cache = new Cache(
+                poolOptions.cacheMaxBytes,
+                poolOptions.cacheFile
+            );
+        this.__metered = new WeakMap();
+        if (poolOptions.throughput) this.__throughput = new Throughput();
+        // reservations effective before the first acquire() of the class
+        for (let className in poolOptions.classes || {})
+            this.poolClass(className);
     }
 
     newClient(): Client {
@@ -65,37 +270,456 @@ export class Pool {
         });
     }
 
-    acquire(reqId?: Number): Promise<Client> {
-        console.log(
-            `    pool acquire req: ${reqId} ready: ${Pool.Ready.length} ${this.READY}`
-        );
+    acquire(
+        reqId?: Number,
+        acquireOptions: RfcAcquireOptions = {}
+    ): Promise<Client> {
         return new Promise(
             (resolve: (arg: Client) => void, reject: (arg: any) => void) => {
-                const client = Pool.Ready.pop();
-                if (Pool.Ready.length < this.__poolOptions.min) this.refill();
-                if (client instanceof Client) {
-                    Pool.Active.set(client.id, client);
-                    console.log(
-                        `    pool acquire req: ${reqId} client: ${client.id}:${client._connectionHandle} ready: ${Pool.Ready.length} ${this.READY}`
+                const className = acquireOptions.class || "default";
+                const poolClass = this.poolClass(className);
+                const tenant = acquireOptions.tenant || "";
+                const weight = acquireOptions.weight || 1;
+                const start = Math.max(
+                    poolClass.virtualTime,
+                    poolClass.tenants.get(tenant) || 0
+                );
+                const waiter: PoolWaiter = {
+                    className: className,
+                    finish: start + 1 / weight,
+                    seq: this.__seq++,
+                    queued: Date.now(),
+                    resolve: resolve,
+                    reject: reject,
+                };
+                poolClass.tenants.set(tenant, waiter.finish);
+                poolClass.queue.push(waiter);
+                this.dispatch();
+
+                // still queued: queue limit and deadline checked
+                if (poolClass.queue.indexOf(waiter) === -1) return;
+                if (
+                    !isUndefined(this.__poolOptions.queueMax) &&
+                    this.queued > this.__poolOptions.queueMax
+                ) {
+                    this.dequeue(waiter);
+                    reject(
+                        poolError(
+                            "RfcPoolOverloadError",
+                            `Pool queue limit reached: ${this.__poolOptions.queueMax}`
+                        )
                     );
-                    resolve(client);
-                } else {
-                    const newClient: Client = this.newClient();
-                    newClient.connect((err: any) => {
-                        if (!isUndefined(err)) {
-                            reject(err);
+                    return;
+                }
+                const expires = deadline(acquireOptions);
+                if (!isUndefined(expires)) {
+                    waiter.timer = setTimeout(() => {
+                        this.dequeue(waiter);
+                        reject(
+                            poolError(
+                                "RfcTimeoutError",
+                                `Pool acquire timed out after ${
+                                    expires - waiter.queued
+                                } ms`
+                            )
+                        );
+                    }, Math.max(0, expires - Date.now()));
+                }
+            }
+        );
+    }
+
+    call(
+        rfmName: string,
+        rfmParams: RfcObject | Buffer,
+        callOptions: RfcCallOptions = {},
+        acquireOptions: RfcAcquireOptions = {}
+    ): Promise<RfcObject> {
+        const ttl = (this.__poolOptions.cache || {})[rfmName];
+        const shared = this.__coalesce.has(rfmName);
+        if (isUndefined(ttl) && !shared)
+            return this.invoke(rfmName, rfmParams, callOptions, acquireOptions);
+
+        const key = requestKey(rfmName, rfmParams, callOptions);
+
+        // cache hit without connection and round trip
+        if (!isUndefined(ttl) && !isUndefined(this.__cache)) {
+            const cached = this.__cache.get(key);
+            if (!isUndefined(cached)) return Promise.resolve(cached);
+        }
+
+        // identical in-flight call shared, result object too
+        let call = this.__inFlight.get(key);
+        if (!isUndefined(call)) {
+            this.__coalesced++;
+            return call;
+        }
+        call = this.invoke(rfmName, rfmParams, callOptions, acquireOptions);
+        if (!isUndefined(ttl) && !isUndefined(this.__cache)) {
+            const cache = this.__cache;
+            call = call.then((result: RfcObject) => {
+                cache.set(key, result, ttl);
+                return result;
+            });
+        }
+        if (shared) {
+            call = call.finally(() => {
+                this.__inFlight.delete(key);
+            });
+            this.__inFlight.set(key, call);
+        }
+        return call;
+    }
+
+    // partitions called concurrently on pooled connections and their rows written
+    // to an object mode writable; at most `parallel` partitions running or
+    // buffered, none started while the writable is draining
+    extract(
+        rfmName: string,
+        rfmParams: RfcObject,
+        writable: Writable,
+        extractOptions: RfcExtractOptions = {}
+    ): Promise<RfcExtractProgress> {
+        return new Promise((resolve, reject) => {
+            const partitions = extractOptions.partitions;
+            const window = extractOptions.window;
+            if (isUndefined(partitions) === isUndefined(window)) {
+                reject(
+                    new TypeError("Extract partitions or window option expected")
+                );
+                return;
+            }
+            const table = extractOptions.table || "DATA";
+            const parallel = Math.max(1, extractOptions.parallel || 4);
+            const retries = isUndefined(extractOptions.retries)
+                ? 2
+                : extractOptions.retries;
+            const [skipParam, countParam] = extractOptions.windowParams || [
+                "ROWSKIPS",
+                "ROWCOUNT",
+            ];
+            const status: RfcExtractProgress = {
+                partition: -1,
+                rows: 0,
+                done: 0,
+                partitions: isUndefined(partitions)
+                    ? undefined
+                    : partitions.length,
+                total: 0,
+                retries: 0,
+            };
+            const buffered: Map<number, any> = new Map();
+            let next = 0; // partition to start
+            let written = 0; // ordered: partition to write
+            let running = 0;
+            let draining = false;
+            let failed: any;
+
+            const params = (partition: number): RfcObject =>
+                isUndefined(partitions)
+                    ? Object.assign({}, rfmParams, {
+                          [skipParam]: partition * (window as number),
+                          [countParam]: window,
+                      })
+                    : partitionParams(rfmParams, partitions[partition]);
+
+            const fail = (err: any) => {
+                if (!isUndefined(failed)) return;
+                failed = err;
+                writable.removeListener("error", fail);
+                writable.removeListener("drain", drained);
+                reject(err);
+            };
+            const drained = () => {
+                draining = false;
+                schedule();
+            };
+            const write = (partition: number, rows: any) => {
+                // split columns written as one chunk
+                for (let row of Array.isArray(rows)
+                    ? rows
+                    : isUndefined(rows)
+                    ? []
+                    : [rows]) {
+                    if (!writable.write(row) && !draining) {
+                        draining = true;
+                        writable.once("drain", drained);
+                    }
+                }
+                status.partition = partition;
+                status.rows = rowCount(rows);
+                status.done++;
+                status.total += status.rows;
+                if (extractOptions.progress)
+                    extractOptions.progress(Object.assign({}, status));
+            };
+            const completed = (partition: number, rows: any) => {
+                running--;
+                const count = rowCount(rows);
+                if (!isUndefined(window) && count < window) {
+                    // empty window past the end, short one the last
+                    const end = count === 0 ? partition : partition + 1;
+                    if (
+                        isUndefined(status.partitions) ||
+                        end < status.partitions
+                    )
+                        status.partitions = end;
+                }
+                if (
+                    isUndefined(status.partitions) ||
+                    partition < status.partitions
+                ) {
+                    if (!extractOptions.ordered) {
+                        write(partition, rows);
+                    } else {
+                        buffered.set(partition, rows);
+                        while (buffered.has(written)) {
+                            write(written, buffered.get(written));
+                            buffered.delete(written++);
+                        }
+                    }
+                }
+                schedule();
+            };
+            const run = (partition: number, attempt: number) => {
+                this.call(
+                    rfmName,
+                    params(partition),
+                    extractOptions.callOptions,
+                    extractOptions.acquireOptions
+                ).then(
+                    (result: RfcObject) => {
+                        if (!isUndefined(failed)) return;
+                        // progress callback and writable errors reject extract()
+                        try {
+                            completed(partition, result[table]);
+                        } catch (ex) {
+                            fail(ex);
+                        }
+                    },
+                    (err: any) => {
+                        if (!isUndefined(failed)) return;
+                        if (attempt < retries) {
+                            status.retries++;
+                            run(partition, attempt + 1);
                         } else {
-                            Pool.Active.set(newClient.id, newClient);
-                            console.log(
-                                `    pool acquire req: ${reqId} client: ${newClient.id}:${newClient._connectionHandle} ready: ${Pool.Ready.length} ${this.READY}`
-                            );
-                            console.log(this.READY);
-                            resolve(newClient);
+                            fail(err);
                         }
-                    });
+                    }
+                );
+            };
+            const schedule = () => {
+                if (!isUndefined(failed)) return;
+                const end = isUndefined(status.partitions)
+                    ? Infinity
+                    : status.partitions;
+                for (let partition of buffered.keys())
+                    if (partition >= end) buffered.delete(partition);
+                if (running === 0 && buffered.size === 0 && next >= end) {
+                    writable.removeListener("error", fail);
+                    writable.removeListener("drain", drained);
+                    if (extractOptions.end !== false) writable.end();
+                    resolve(status);
+                    return;
                 }
-            }
+                while (
+                    !draining &&
+                    next < end &&
+                    running + buffered.size < parallel
+                ) {
+                    running++;
+                    run(next++, 0);
+                }
+            };
+
+            writable.on("error", fail);
+            schedule();
+        });
+    }
+
+    // OPTIONS predicates of key ranges for extract() partitions, bounds sorted:
+    // field < b0, b0 <= field < b1, ..., field >= bn
+    static keyRanges(field: string, bounds: Array<string>): Array<RfcObject> {
+        const quote = (bound: string) => `'${bound.replace(/'/g, "''")}'`;
+        const ranges: Array<RfcObject> = [];
+        for (let i = 0; i <= bounds.length; i++) {
+            const options: Array<RfcObject> = [];
+            if (i > 0)
+                options.push({ TEXT: `${field} >= ${quote(bounds[i - 1])}` });
+            if (i < bounds.length)
+                options.push({
+                    TEXT: `${i > 0 ? "AND " : ""}${field} < ${quote(bounds[i])}`,
+                });
+            ranges.push(options.length > 0 ? { OPTIONS: options } : {});
+        }
+        return ranges;
+    }
+
+    private invoke(
+        rfmName: string,
+        rfmParams: RfcObject | Buffer,
+        callOptions: RfcCallOptions,
+        acquireOptions: RfcAcquireOptions
+    ): Promise<RfcObject> {
+        // one deadline for pool queue, client mutex and RFC call
+        const expires = deadline(callOptions);
+        if (!isUndefined(expires)) {
+            callOptions = Object.assign({}, callOptions, { deadline: expires });
+            delete callOptions.timeout;
+            acquireOptions = Object.assign({ deadline: expires }, acquireOptions);
+        }
+        return this.acquire(undefined, acquireOptions).then((client: Client) =>
+            client.call(rfmName, rfmParams, callOptions).finally(() => {
+                this.release(client);
+            })
+        );
+    }
+
+    private poolClass(className: string): PoolClass {
+        let poolClass = this.__classes.get(className);
+        if (isUndefined(poolClass)) {
+            const classOptions =
+                (this.__poolOptions.classes || {})[className] || {};
+            poolClass = {
+                priority: classOptions.priority || 0,
+                reserved: classOptions.reserved || 0,
+                inUse: 0,
+                virtualTime: 0,
+                tenants: new Map(),
+                queue: [],
+                acquired: 0,
+                waitTotal: 0,
+                waitMax: 0,
+            };
+            this.__classes.set(className, poolClass);
+        }
+        return poolClass;
+    }
+
+    private dequeue(waiter: PoolWaiter) {
+        const queue = this.poolClass(waiter.className).queue;
+        const index = queue.indexOf(waiter);
+        if (index !== -1) queue.splice(index, 1);
+    }
+
+    // free connection left after the reservations of other classes
+    private admits(className: string): boolean {
+        if (isUndefined(this.__poolOptions.max)) return true;
+        let inUse = 0;
+        let reserved = 0;
+        for (let [name, poolClass] of this.__classes) {
+            inUse += poolClass.inUse;
+            if (name !== className)
+                reserved += Math.max(0, poolClass.reserved - poolClass.inUse);
+        }
+        return this.__poolOptions.max - inUse > reserved;
+    }
+
+    // queued requests served by class priority, tenants by WFQ finish time
+    private dispatch() {
+        const classes = Array.from(this.__classes.entries()).sort(
+            (a, b) => b[1].priority - a[1].priority
         );
+        for (;;) {
+            let granted = false;
+            for (let [name, poolClass] of classes) {
+                if (poolClass.queue.length === 0 || !this.admits(name))
+                    continue;
+                let next = 0;
+                for (let i = 1; i < poolClass.queue.length; i++) {
+                    const waiter = poolClass.queue[i];
+                    const best = poolClass.queue[next];
+                    if (
+                        waiter.finish < best.finish ||
+                        (waiter.finish === best.finish && waiter.seq < best.seq)
+                    )
+                        next = i;
+                }
+                const waiter = poolClass.queue.splice(next, 1)[0];
+                if (!isUndefined(waiter.timer)) clearTimeout(waiter.timer);
+                poolClass.virtualTime = waiter.finish;
+                if (poolClass.queue.length === 0) poolClass.tenants.clear();
+                this.grant(poolClass, waiter);
+                granted = true;
+                break;
+            }
+            if (!granted) return;
+        }
+    }
+
+    private grant(poolClass: PoolClass, waiter: PoolWaiter) {
+        const wait = Date.now() - waiter.queued;
+        poolClass.inUse++;
+        poolClass.acquired++;
+        poolClass.waitTotal += wait;
+        poolClass.waitMax = Math.max(poolClass.waitMax, wait);
+
+        const client = Pool.Ready.pop();
+        if (Pool.Ready.length < this.__poolOptions.min) this.refill();
+        if (client instanceof Client) {
+            Pool.Active.set(client.id, client);
+            this.__leases.set(client.id, waiter.className);
+            this.meter(client);
+            this.warm(client, waiter);
+        } else {
+            const newClient: Client = this.newClient();
+            newClient.connect((err: any) => {
+                if (!isUndefined(err)) {
+                    poolClass.inUse--;
+                    waiter.reject(err);
+                    this.dispatch();
+                } else {
+                    Pool.Active.set(newClient.id, newClient);
+                    this.__leases.set(newClient.id, waiter.className);
+                    this.meter(newClient);
+                    this.warm(newClient, waiter);
+                }
+            });
+        }
+    }
+
+    // new and reopened connections have new handles
+    private meter(client: Client) {
+        if (isUndefined(this.__throughput)) return;
+        if (this.__metered.get(client) === client._connectionHandle) return;
+        this.__throughput.setOnConnection(client);
+        this.__metered.set(client, client._connectionHandle);
+    }
+
+    private unmeter(client: Client) {
+        if (isUndefined(this.__throughput)) return;
+        this.__throughput.removeFromConnection(client);
+        this.__metered.delete(client);
+    }
+
+    // metadata snapshot imported once, before the first client is handed over,
+    // exported and shared when not cached yet or not matching the system
+    private warm(client: Client, waiter: PoolWaiter) {
+        const rfmNames = this.__poolOptions.metadata;
+        if (isUndefined(rfmNames) || isUndefined(this.__cache)) {
+            waiter.resolve(client);
+            return;
+        }
+        if (isUndefined(this.__warm)) {
+            const cache = this.__cache;
+            const params = Object.assign({}, this.__connectionParams);
+            delete params.passwd;
+            const hash = createHash("sha256")
+                .update(canonical(params))
+                .update(canonical(rfmNames))
+                .digest("base64");
+            const key = `metadata:${hash}`;
+            const exported = () =>
+                client.exportMetadata(rfmNames).then((snapshot: Buffer) => {
+                    cache.set(key, snapshot, METADATA_TTL);
+                });
+            const snapshot = cache.get(key);
+            this.__warm = (isUndefined(snapshot)
+                ? exported()
+                : client.importMetadata(snapshot).catch(exported)
+            ).catch(() => {});
+        }
+        (this.__warm as Promise<void>).then(() => waiter.resolve(client));
     }
 
     release(client: Client, reqId?: Number): Promise<void> {
@@ -112,15 +736,23 @@ export class Pool {
                     );
                 const id = client.id;
                 Pool.Active.delete(id);
-                if (Pool.Ready.length < this.__poolOptions.min) {
+                const className = this.__leases.get(id);
+                if (!isUndefined(className)) {
+                    this.__leases.delete(id);
+                    this.poolClass(className).inUse--;
+                }
+                // kept open for queued requests
+                if (
+                    Pool.Ready.length < this.__poolOptions.min ||
+                    this.queued > 0
+                ) {
                     Pool.Ready.push(client);
                 } else {
+                    this.unmeter(client);
                     client.close(() => {});
                 }
-                console.log(
-                    `    pool release req: ${reqId} client: ${client.id}:${client._connectionHandle} ready: ${Pool.Ready.length} ${this.READY}`
-                );
                 resolve(id);
+                this.dispatch();
             }
         );
     }
@@ -129,7 +761,10 @@ export class Pool {
         return new Promise((resolve: (arg: number) => void) => {
             const toBeClosed = Pool.Ready.length + Pool.Active.size;
             let closed = 0;
+            this.__leases.clear();
+            for (let poolClass of this.__classes.values()) poolClass.inUse = 0;
             for (let [id, client] of Pool.Active.entries()) {
+                this.unmeter(client);
                 client.close(() => {
                     closed++;
                     if (closed === toBeClosed) {
@@ -139,7 +774,8 @@ export class Pool {
                     }
                 });
             }
-            Pool.Ready.forEach((client) =>
+            Pool.Ready.forEach((client) => {
+                this.unmeter(client);
                 client.close(() => {
                     closed++;
                     if (closed === toBeClosed) {
@@ -147,8 +783,8 @@ export class Pool {
                         Pool.Active = new Map();
                         resolve(closed);
                     }
-                })
-            );
+                });
+            });
         });
     }
 
@@ -156,10 +792,69 @@ export class Pool {
         return {
             active: Pool.Active.size,
             ready: Pool.Ready.length,
+            queued: this.queued,
+            classes: this.classes,
+            coalesced: this.__coalesced,
+            cache: isUndefined(this.__cache) ? undefined : this.__cache.status,
             options: this.__poolOptions,
         };
     }
 
+    clearCache() {
+        if (!isUndefined(this.__cache)) this.__cache.clear();
+    }
+
+    // counters and rates of all pooled connections, same array on every call
+    get throughput(): Float64Array | undefined {
+        return isUndefined(this.__throughput)
+            ? undefined
+            : this.__throughput.snapshot();
+    }
+
+    get queued(): number {
+        let queued = 0;
+        for (let poolClass of this.__classes.values())
+            queued += poolClass.queue.length;
+        return queued;
+    }
+
+    // load shedding signal for callers
+    get saturation(): RfcPoolSaturation {
+        const now = Date.now();
+        let inUse = 0;
+        let queued = 0;
+        let oldest = now;
+        for (let poolClass of this.__classes.values()) {
+            inUse += poolClass.inUse;
+            queued += poolClass.queue.length;
+            for (let waiter of poolClass.queue)
+                oldest = Math.min(oldest, waiter.queued);
+        }
+        return {
+            inUse: inUse,
+            max: this.__poolOptions.max,
+            queued: queued,
+            queueMax: this.__poolOptions.queueMax,
+            oldestWait: now - oldest,
+        };
+    }
+
+    get classes(): { [name: string]: RfcPoolClassStatus } {
+        const classes: { [name: string]: RfcPoolClassStatus } = {};
+        for (let [name, poolClass] of this.__classes) {
+            classes[name] = {
+                priority: poolClass.priority,
+                reserved: poolClass.reserved,
+                queued: poolClass.queue.length,
+                inUse: poolClass.inUse,
+                acquired: poolClass.acquired,
+                waitTotal: poolClass.waitTotal,
+                waitMax: poolClass.waitMax,
+            };
+        }
+        return classes;
+    }
+
     get READY(): Array<Number> {
         const ready = new Array<Number>();
         for (let c of Pool.Ready) ready.push(c._connectionHandle);
@@ -0,0 +1,159 @@
+var Promise = require("bluebird");
+import {
+    binding,
+    Client,
+    RfcClientBinding,
+    RfcConnectionParameters,
+    RfcObject,
+} from "./sapnwrfc-client";
+import { isUndefined } from "util";
+
+export interface RfcServerOptions {
+    threads?: number;
+}
+
+export type RfcServerFunction = (
+    abapInput: RfcObject
+) => RfcObject | void | Promise<RfcObject | void>;
+
+export interface RfcServerBinding {
+    new (
+        serverParams: RfcConnectionParameters,
+        client: RfcClientBinding,
+        options?: RfcServerOptions
+    ): RfcServerBinding;
+    (
+        serverParams: RfcConnectionParameters,
+        client: RfcClientBinding,
+        options?: RfcServerOptions
+    ): RfcServerBinding;
+    start(callback: Function): void;
+    stop(callback: Function): void;
+    addFunction(
+        abapFunctionName: string,
+        jsFunction: RfcServerFunction,
+        callback: Function
+    ): void;
+    removeFunction(abapFunctionName: string): boolean;
+    id: number;
+    alive: boolean;
+    threads: number;
+}
+
+export class Server {
+    private __server: RfcServerBinding;
+    private __client: Client;
+
+    constructor(
+        serverParams: RfcConnectionParameters,
+        client: Client,
+        options?: RfcServerOptions
+    ) {
+        if (!(client instanceof Client))
+            throw new TypeError("Client instance required as second argument");
+        this.__client = client;
+        this.__server = options
+            ? new binding.Server(serverParams, client._client, options)
+            : new binding.Server(serverParams, client._client);
+    }
+
+    start(callback?: Function): Promise<void> | any {
+        if (typeof callback === "function") {
+            return this.__server.start(callback);
+        } else if (!isUndefined(callback)) {
+            throw new TypeError(
+                `Start callback, if provided, must be a function, received: typeof ${callback}`
+            );
+        } else {
+            return new Promise((resolve, reject) => {
+                this.__server.start((err: any) => {
+                    if (!isUndefined(err)) {
+                        reject(err);
+                    } else {
+                        resolve();
+                    }
+                });
+            });
+        }
+    }
+
+    stop(callback?: Function): Promise<void> | any {
+        if (typeof callback === "function") {
+            return this.__server.stop(callback);
+        } else if (!isUndefined(callback)) {
+            throw new TypeError(
+                `Stop callback, if provided, must be a function, received: typeof ${callback}`
+            );
+        } else {
+            return new Promise((resolve, reject) => {
+                this.__server.stop((err: any) => {
+                    if (!isUndefined(err)) {
+                        reject(err);
+                    } else {
+                        resolve();
+                    }
+                });
+            });
+        }
+    }
+
+    addFunction(
+        abapFunctionName: string,
+        jsFunction: RfcServerFunction,
+        callback?: Function
+    ): Promise<void> | any {
+        if (typeof abapFunctionName !== "string")
+            throw new TypeError(
+                "First argument (ABAP function name) must be a string"
+            );
+        if (typeof jsFunction !== "function")
+            throw new TypeError(
+                "Second argument (JavaScript function) must be a function"
+            );
+        if (typeof callback === "function") {
+            return this.__server.addFunction(
+                abapFunctionName,
+                jsFunction,
+                callback
+            );
+        } else if (!isUndefined(callback)) {
+            throw new TypeError(
+                `Callback, if provided, must be a function, received: typeof ${callback}`
+            );
+        } else {
+            return new Promise((resolve, reject) => {
+                this.__server.addFunction(
+                    abapFunctionName,
+                    jsFunction,
+                    (err: any) => {
+                        if (!isUndefined(err)) {
+                            reject(err);
+                        } else {
+                            resolve();
+                        }
+                    }
+                );
+            });
+        }
+    }
+
+    removeFunction(abapFunctionName: string): boolean {
+        return this.__server.removeFunction(abapFunctionName);
+    }
+
+    get id(): number {
+        return this.__server.id;
+    }
+
+    get alive(): boolean {
+        return this.__server.alive;
+    }
+
+    get threads(): number {
+        return this.__server.threads;
+    }
+
+    get client(): Client {
+        return this.__client;
+    }
+}
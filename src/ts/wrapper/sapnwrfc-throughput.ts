@@ -11,6 +11,7 @@ export interface RfcThroughputBinding {
     getFromConnection(_connectionHandle: number): any;
     reset(): void;
     destroy(): void;
+    snapshot(values: Float64Array): any;
 }
 
 export interface RfcThroughputStatus {
@@ -23,9 +24,28 @@ export interface RfcThroughputStatus {
     deserializationTime: number;
 }
 
+// Throughput snapshot() elements, rates over the interval since the previous snapshot
+export enum RfcThroughputIndex {
+    numberOfCalls = 0,
+    sentBytes,
+    receivedBytes,
+    applicationTime,
+    totalTime,
+    serializationTime,
+    deserializationTime,
+    interval, // seconds, 0 for the first snapshot
+    callsPerSecond,
+    sentBytesPerSecond,
+    receivedBytesPerSecond,
+    meanApplicationTime, // per call
+}
+
 export class Throughput {
     private __throughput: RfcThroughputBinding;
     private __clients: Set<Client> = new Set();
+    private __snapshot: Float64Array = new Float64Array(
+        RfcThroughputIndex.meanApplicationTime + 1
+    );
 
     private static __Handles: Map<number, Throughput> = new Map();
 
@@ -98,6 +118,13 @@ export class Throughput {
         return this.__throughput.status;
     }
 
+    // same array refilled on every call, indexed by RfcThroughputIndex
+    snapshot(): Float64Array {
+        const e = this.__throughput.snapshot(this.__snapshot);
+        if (!isUndefined(e)) throw new Error(JSON.stringify(e));
+        return this.__snapshot;
+    }
+
     get clients(): Set<Client> {
         return this.__clients;
     }
@@ -0,0 +1,141 @@
+var Promise = require("bluebird");
+import { binding, Client, RfcClientBinding, RfcObject } from "./sapnwrfc-client";
+import { isUndefined } from "util";
+
+export interface RfcTransactionOptions {
+    // bgRFC unit, tRFC/qRFC transaction otherwise
+    unit?: boolean;
+    // qRFC queue, or bgRFC unit queues
+    queue?: string | Array<string>;
+    // TID or unit ID of a persisted transaction, to be sent again
+    id?: string;
+}
+
+export interface RfcTransactionBinding {
+    new (
+        client: RfcClientBinding,
+        options?: RfcTransactionOptions
+    ): RfcTransactionBinding;
+    (
+        client: RfcClientBinding,
+        options?: RfcTransactionOptions
+    ): RfcTransactionBinding;
+    create(callback: Function): void;
+    add(rfmName: string, rfmParams: RfcObject, callback: Function): void;
+    submit(callback: Function): void;
+    confirm(callback: Function): void;
+    destroy(): void;
+    id: number;
+    tid: string;
+    type: string;
+    queue: Array<string>;
+}
+
+export type RfcTransactionCall = { rfmName: string; rfmParams: RfcObject };
+
+export class Transaction {
+    private __transaction: RfcTransactionBinding;
+    private __client: Client;
+    private __calls: Array<RfcTransactionCall> = [];
+
+    constructor(client: Client, options?: RfcTransactionOptions) {
+        if (!(client instanceof Client))
+            throw new TypeError("Client instance required as first argument");
+        this.__client = client;
+        this.__transaction = options
+            ? new binding.Transaction(client._client, options)
+            : new binding.Transaction(client._client);
+    }
+
+    private __call(method: string, ...args: any[]): Promise<any> {
+        return new Promise((resolve, reject) => {
+            (this.__transaction as any)[method](...args, (err: any, res: any) => {
+                if (!isUndefined(err)) {
+                    reject(err);
+                } else {
+                    resolve(res);
+                }
+            });
+        });
+    }
+
+    add(rfmName: string, rfmParams: RfcObject = {}): Transaction {
+        if (typeof rfmName !== "string")
+            throw new TypeError(
+                "First argument (remote function module name) must be an string"
+            );
+        if (typeof rfmParams !== "object")
+            throw new TypeError(
+                "Second argument (remote function module parameters) must be an object"
+            );
+        this.__calls.push({ rfmName: rfmName, rfmParams: rfmParams });
+        return this;
+    }
+
+    // Sends all added calls in one round trip. The beforeSubmit hook receives
+    // the TID/unit ID, to be persisted for exactly-once processing. After a
+    // failure, submit() again sends the calls under the same TID/unit ID.
+    submit(beforeSubmit?: (tid: string) => any): Promise<string> {
+        if (!isUndefined(beforeSubmit) && typeof beforeSubmit !== "function")
+            throw new TypeError(
+                `beforeSubmit, if provided, must be a function, received: typeof ${beforeSubmit}`
+            );
+        if (this.__calls.length === 0)
+            return Promise.reject(
+                new Error("No function calls added to transaction")
+            );
+        return this.__call("create")
+            .then((tid: string) => {
+                if (beforeSubmit) return Promise.resolve(beforeSubmit(tid));
+            })
+            .then(() =>
+                Promise.each(this.__calls, (call: RfcTransactionCall) =>
+                    this.__call("add", call.rfmName, call.rfmParams)
+                )
+            )
+            .then(() => this.__call("submit"))
+            .then(() => {
+                this.__calls = [];
+                return this.__transaction.tid;
+            })
+            .catch((err: any) => {
+                // handle released, submit() can be retried with the same TID
+                this.__transaction.destroy();
+                throw err;
+            });
+    }
+
+    // Confirms the submitted transaction, the backend can delete the TID
+    confirm(): Promise<void> {
+        return this.__call("confirm");
+    }
+
+    destroy() {
+        this.__calls = [];
+        this.__transaction.destroy();
+    }
+
+    get id(): number {
+        return this.__transaction.id;
+    }
+
+    get tid(): string {
+        return this.__transaction.tid;
+    }
+
+    get type(): string {
+        return this.__transaction.type;
+    }
+
+    get queue(): Array<string> {
+        return this.__transaction.queue;
+    }
+
+    get calls(): Array<RfcTransactionCall> {
+        return this.__calls;
+    }
+
+    get client(): Client {
+        return this.__client;
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+
+#include <map>
+#include <uv.h>
+#include "watchdog.h"
+
+namespace node_rfc
+{
+    ////////////////////////////////////////////////////////////////////////////////
+    // Watchdog, one thread per process, started with the first deadline
+    //
+    // Sleeps until the earliest deadline and cancels its RFC call. RfcCancel()
+    // runs under the watchdog mutex, so that a call completing at the same time
+    // cannot have its connection handle cancelled after watchdogRemove().
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static uv_once_t watchdogOnce = UV_ONCE_INIT;
+    static uv_mutex_t watchdogMutex;
+    static uv_cond_t watchdogCond;
+    static uv_thread_t watchdogThread;
+    static std::multimap<uint64_t, Deadline *> deadlines;
+
+    static void watchdogRun(void *arg)
+    {
+        RFC_ERROR_INFO errorInfo;
+        uv_mutex_lock(&watchdogMutex);
+        for (;;)
+        {
+            if (deadlines.empty())
+            {
+                uv_cond_wait(&watchdogCond, &watchdogMutex);
+                continue;
+            }
+            uint64_t now = uv_hrtime();
+            std::multimap<uint64_t, Deadline *>::iterator earliest = deadlines.begin();
+            if (earliest->first > now)
+            {
+                uv_cond_timedwait(&watchdogCond, &watchdogMutex, earliest->first - now);
+                continue;
+            }
+            Deadline *deadline = earliest->second;
+            deadlines.erase(earliest);
+            deadline->cancelled = true;
+            RfcCancel(deadline->connectionHandle, &errorInfo);
+        }
+    }
+
+    static void watchdogStart(void)
+    {
+        uv_mutex_init(&watchdogMutex);
+        uv_cond_init(&watchdogCond);
+        uv_thread_create(&watchdogThread, watchdogRun, NULL);
+    }
+
+    void watchdogAdd(Deadline *deadline)
+    {
+        uv_once(&watchdogOnce, watchdogStart);
+        uv_mutex_lock(&watchdogMutex);
+        deadline->cancelled = false;
+        deadlines.insert(std::make_pair(deadline->expires, deadline));
+        uv_cond_signal(&watchdogCond);
+        uv_mutex_unlock(&watchdogMutex);
+    }
+
+    void watchdogRemove(Deadline *deadline)
+    {
+        uv_mutex_lock(&watchdogMutex);
+        std::pair<std::multimap<uint64_t, Deadline *>::iterator, std::multimap<uint64_t, Deadline *>::iterator> range = deadlines.equal_range(deadline->expires);
+        for (std::multimap<uint64_t, Deadline *>::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second == deadline)
+            {
+                deadlines.erase(it);
+                break;
+            }
+        }
+        uv_mutex_unlock(&watchdogMutex);
+    }
+} // namespace node_rfc
@@ -0,0 +1,37 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+
+#ifndef NODE_SAPNWRFC_WATCHDOG_H_
+#define NODE_SAPNWRFC_WATCHDOG_H_
+
+#include <stdint.h>
+#include <sapnwrfc.h>
+
+namespace node_rfc
+{
+    // RFC call deadline, connection cancelled by the watchdog thread when passed
+    typedef struct _Deadline
+    {
+        RFC_CONNECTION_HANDLE connectionHandle;
+        uint64_t expires; // uv_hrtime() nanoseconds
+        bool cancelled;
+    } Deadline;
+
+    void watchdogAdd(Deadline *deadline);
+    // no RfcCancel for this deadline running or pending after return
+    void watchdogRemove(Deadline *deadline);
+} // namespace node_rfc
+
+#endif // NODE_SAPNWRFC_WATCHDOG_H_
@@ -872,4 +872,103 @@ module.exports = () => {
             }
         );
     });
+
+    test("TABLE accepts columns", function (done) {
+        const rows = [
+            { RFCINT4: 1, RFCFLOAT: 1.5, RFCCHAR4: "AB", RFCDATE: "20200101" },
+            { RFCINT4: 2, RFCFLOAT: 2.5, RFCCHAR4: "CD", RFCDATE: "20200102" },
+        ];
+        client.invoke(
+            "STFC_STRUCTURE",
+            {
+                RFCTABLE: {
+                    RFCINT4: new Int32Array([1, 2]),
+                    RFCFLOAT: new Float64Array([1.5, 2.5]),
+                    RFCCHAR4: Buffer.from("AB\nCD\n"),
+                    RFCDATE: ["20200101", "20200102"],
+                },
+            },
+            function (err, res) {
+                expect(err).toBeUndefined();
+                expect(res.RFCTABLE.slice(0, 2)).toEqual([
+                    expect.objectContaining(rows[0]),
+                    expect.objectContaining(rows[1]),
+                ]);
+                done();
+            }
+        );
+    });
+
+    test("error: TABLE columns of different length", function (done) {
+        client.invoke(
+            "STFC_STRUCTURE",
+            {
+                RFCTABLE: {
+                    RFCINT4: new Int32Array([1, 2]),
+                    RFCCHAR4: ["AB"],
+                },
+            },
+            function (err) {
+                expect(err).toEqual(
+                    expect.objectContaining({
+                        name: "TypeError",
+                        message:
+                            "Column RFCCHAR4 of table RFCTABLE has 1 values, 2 expected",
+                    })
+                );
+                done();
+            }
+        );
+    });
+
+    test("TABLE text column with CRLF lines", function (done) {
+        client.invoke(
+            "STFC_STRUCTURE",
+            { RFCTABLE: { RFCCHAR4: Buffer.from("AB\r\nCD\r\n") } },
+            function (err, res) {
+                expect(err).toBeUndefined();
+                expect(res.RFCTABLE[0].RFCCHAR4).toBe("AB");
+                expect(res.RFCTABLE[1].RFCCHAR4).toBe("CD");
+                done();
+            }
+        );
+    });
+
+    test("error: TABLE integer column with NaN", function (done) {
+        client.invoke(
+            "STFC_STRUCTURE",
+            { RFCTABLE: { RFCINT4: new Float64Array([1, NaN]) } },
+            function (err) {
+                expect(err.name).toBe("TypeError");
+                expect(err.message).toMatch(
+                    "Integer in field range expected in row 1 of column RFCINT4"
+                );
+                done();
+            }
+        );
+    });
+
+    test("TABLE of character-like fields moved as whole rows", function (done) {
+        client.invoke(
+            "RFC_READ_TABLE",
+            {
+                QUERY_TABLE: "T000",
+                FIELDS: [{ FIELDNAME: "MANDT" }],
+                OPTIONS: [{ TEXT: "MANDT = '000'" }],
+            },
+            function (err, res) {
+                expect(err).toBeUndefined();
+                expect(res.FIELDS[0]).toEqual(
+                    expect.objectContaining({
+                        FIELDNAME: "MANDT",
+                        OFFSET: "000000",
+                        LENGTH: "000003",
+                        TYPE: "C",
+                    })
+                );
+                expect(res.DATA).toEqual([{ WA: "000" }]);
+                done();
+            }
+        );
+    });
 };
@@ -138,4 +138,63 @@ module.exports = () => {
             );
         });
     });
+
+    test("error: promise call() rejects invalid call options", function () {
+        expect.assertions(1);
+        return client.call("rfc", {}, 2).catch((err) => {
+            expect(err).toEqual(
+                expect.objectContaining({
+                    name: "TypeError",
+                    message: "Call options argument must be an object",
+                })
+            );
+        });
+    });
+
+    test("error: promise call() rejects, not throws, conflicting options", function () {
+        expect.assertions(2);
+        const call = client.call(
+            "STFC_CONNECTION",
+            { REQUTEXT: "HELLÖ SAP!" },
+            { json: true, stream: "X" }
+        );
+        expect(call).toBeInstanceOf(Promise);
+        return call.catch((err) => {
+            expect(err).toEqual(
+                expect.objectContaining({
+                    name: "TypeError",
+                    message: "Options json and stream cannot be combined",
+                })
+            );
+        });
+    });
+
+    test("error: promise call() rejects unknown call option", function () {
+        expect.assertions(1);
+        return client
+            .call("STFC_CONNECTION", {}, { bogus: 1 })
+            .catch((err) => {
+                expect(err).toEqual(
+                    expect.objectContaining({
+                        name: "TypeError",
+                        message: "Unknown option: bogus",
+                    })
+                );
+            });
+    });
+
+    test("error: promise call() rejects stream option", function () {
+        expect.assertions(1);
+        return client
+            .call("STFC_STRUCTURE", {}, { stream: "RFCTABLE" })
+            .catch((err) => {
+                expect(err).toEqual(
+                    expect.objectContaining({
+                        name: "TypeError",
+                        message:
+                            "Option stream not supported by call(), use streamTable()",
+                    })
+                );
+            });
+    });
 };
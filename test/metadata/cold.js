@@ -0,0 +1,41 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+// Run in a child process, SDK repository empty: one STFC_CONNECTION call,
+// after the metadata snapshot given as argument is imported, if any.
+// Prints the number of RFC calls sent, metadata lookups included.
+
+const setup = require("../testutils/setup");
+
+(async () => {
+    const client = setup.client();
+    const throughput = new setup.rfcThroughput();
+    await client.open();
+    const count = process.argv[2]
+        ? await client.importMetadata(process.argv[2])
+        : 0;
+    throughput.setOnConnection(client);
+    const res = await client.call("STFC_CONNECTION", { REQUTEXT: "cold" });
+    const numberOfCalls = throughput.status.numberOfCalls;
+    throughput.removeFromConnection(client);
+    await client.close();
+    process.stdout.write(
+        JSON.stringify({ count, numberOfCalls, echo: res.ECHOTEXT })
+    );
+})().catch((ex) => {
+    process.stderr.write(ex.message);
+    process.exit(1);
+});
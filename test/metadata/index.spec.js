@@ -0,0 +1 @@
+describe("Metadata: snapshot export and import", require("./metadata"));
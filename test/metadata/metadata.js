@@ -0,0 +1,92 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const path = require("path");
+    const os = require("os");
+    const { execFile } = require("child_process");
+    const client = setup.client();
+
+    const RFMS = ["STFC_CONNECTION", "STFC_STRUCTURE", "BAPI_USER_GET_DETAIL"];
+
+    beforeAll(() => {
+        return client.open();
+    });
+
+    afterAll(() => {
+        return client.close();
+    });
+
+    // fresh processes, no function or type descriptions cached by the SDK
+    const cold = (file) => {
+        const args = [path.join(__dirname, "cold.js")];
+        if (file) args.push(file);
+        return new Promise((resolve, reject) => {
+            execFile(process.execPath, args, (err, stdout, stderr) => {
+                if (err) reject(new Error(stderr || err.message));
+                else resolve(JSON.parse(stdout));
+            });
+        });
+    };
+
+    test("Export and import into fresh process", function () {
+        expect.assertions(6);
+        const file = path.join(os.tmpdir(), "node-rfc-metadata.bin");
+        return client.exportMetadata(RFMS, file).then((snapshot) => {
+            expect(snapshot.slice(0, 8).toString()).toBe("NRFCMETA");
+            return Promise.all([cold(), cold(file)]).then(
+                ([lookup, imported]) => {
+                    // metadata lookup sent with the first call, unless imported
+                    expect(lookup.numberOfCalls).toBeGreaterThan(1);
+                    expect(imported.count).toBe(RFMS.length);
+                    expect(imported.numberOfCalls).toBe(1);
+                    expect(imported.echo).toBe("cold");
+                    expect(lookup.echo).toBe("cold");
+                }
+            );
+        });
+    });
+
+    test("error: invalid snapshot", function () {
+        expect.assertions(1);
+        return client
+            .importMetadata(Buffer.from("NRFCMETA garbage"))
+            .catch((ex) => {
+                expect(ex.message).toBe("Invalid metadata snapshot");
+            });
+    });
+
+    test("error: partner system mismatch", function () {
+        expect.assertions(1);
+        return client.exportMetadata(["STFC_CONNECTION"]).then((snapshot) => {
+            // first system ID character, after magic, version and length prefix
+            snapshot.write("X", 16, "utf16le");
+            return client.importMetadata(snapshot).catch((ex) => {
+                expect(ex.message).toBe(
+                    "Metadata snapshot does not match partner system ID or release"
+                );
+            });
+        });
+    });
+
+    test("error: unknown function", function () {
+        expect.assertions(1);
+        return client.exportMetadata(["XXX"]).catch((ex) => {
+            expect(ex.key).toBe("FU_NOT_FOUND");
+        });
+    });
+};
@@ -90,4 +90,374 @@ module.exports = () => {
                 );
             });
     });
+
+    test("options: json result as Buffer", function () {
+        expect.assertions(3);
+        const params = { REQUTEXT: 'Hällo "JSON"\n' };
+        return client.call("STFC_CONNECTION", params).then((res) => {
+            return client
+                .call("STFC_CONNECTION", params, { json: true })
+                .then((buffer) => {
+                    expect(Buffer.isBuffer(buffer)).toBe(true);
+                    const parsed = JSON.parse(buffer.toString("utf8"));
+                    expect(parsed.ECHOTEXT).toBe(res.ECHOTEXT);
+                    delete parsed.RESPTEXT;
+                    delete res.RESPTEXT;
+                    expect(parsed).toEqual(JSON.parse(JSON.stringify(res)));
+                });
+        });
+    });
+
+    test("options: json result with tables and bcd numbers", function () {
+        expect.assertions(1);
+        const xclient = setup.client(setup.abapSystem, { bcd: "number" });
+        const params = { IMPORTSTRUCT: { RFCFLOAT: 1.5, RFCINT4: 4 } };
+        return xclient
+            .open()
+            .then(() => xclient.call("STFC_STRUCTURE", params))
+            .then((res) =>
+                xclient
+                    .call("STFC_STRUCTURE", params, { json: true })
+                    .then((buffer) => {
+                        const parsed = JSON.parse(buffer.toString());
+                        parsed.ECHOSTRUCT.RFCTIME = res.ECHOSTRUCT.RFCTIME;
+                        expect(parsed.ECHOSTRUCT).toEqual(
+                            JSON.parse(JSON.stringify(res.ECHOSTRUCT))
+                        );
+                    })
+            )
+            .then(() => xclient.close());
+    });
+
+    test("options: interned table strings equal to plain strings", function () {
+        expect.assertions(3);
+        const xclient = setup.client(setup.abapSystem, { intern: true });
+        const row = { RFCCHAR1: "A", RFCCHAR2: "BC", RFCCHAR4: "DEF" };
+        const params = { RFCTABLE: [row, row, row] };
+        expect(xclient.options.intern).toBe(true);
+        return xclient
+            .open()
+            .then(() =>
+                Promise.all([
+                    xclient.call("STFC_STRUCTURE", params),
+                    client.call("STFC_STRUCTURE", params),
+                ])
+            )
+            .then(([interned, plain]) => {
+                expect(interned.RFCTABLE).toEqual(plain.RFCTABLE);
+                expect(interned.RFCTABLE[1].RFCCHAR4).toBe("DEF");
+            })
+            .then(() => xclient.close());
+    });
+
+    test("options: result tables converted in slices equal to plain result", function () {
+        expect.assertions(4);
+        const xclient = setup.client(setup.abapSystem, { slice: 1 });
+        const rows = [];
+        for (let i = 0; i < 5000; i++) rows.push({ RFCINT4: i, RFCCHAR4: "ROW" });
+        const params = { RFCTABLE: rows };
+        let turns = 0;
+        const timer = setInterval(() => turns++, 0);
+        expect(xclient.options.slice).toBe(1);
+        return xclient
+            .open()
+            .then(() =>
+                Promise.all([
+                    xclient.call("STFC_STRUCTURE", params),
+                    client.call("STFC_STRUCTURE", params),
+                ])
+            )
+            .then(([sliced, plain]) => {
+                clearInterval(timer);
+                expect(Object.keys(sliced)).toEqual(Object.keys(plain));
+                expect(sliced.RFCTABLE).toEqual(plain.RFCTABLE);
+                expect(turns).toBeGreaterThan(0);
+            })
+            .then(() => xclient.close());
+    });
+
+    test("error: conversion error in a slice rejects the call", function () {
+        expect.assertions(1);
+        const xclient = setup.client(setup.abapSystem, {
+            slice: 1,
+            date: {
+                toABAP: (date) => date,
+                fromABAP: (date) => {
+                    if (date === "20200102") throw new Error("Invalid date");
+                    return date;
+                },
+            },
+        });
+        const rows = [];
+        for (let i = 0; i < 1000; i++) rows.push({ RFCINT4: i, RFCDATE: "20200102" });
+        return xclient
+            .open()
+            .then(() => xclient.call("STFC_STRUCTURE", { RFCTABLE: rows }))
+            .catch((ex) => {
+                expect(ex.message).toBe("Invalid date");
+            })
+            .then(() => xclient.close());
+    });
+
+    test("options: table BYTE values as views of one ArrayBuffer", function () {
+        expect.assertions(4);
+        const xclient = setup.client(setup.abapSystem, { bytes: "view" });
+        const row = { RFCHEX3: Buffer.from("010203", "hex") };
+        const params = { RFCTABLE: [row, row] };
+        return xclient
+            .open()
+            .then(() => xclient.call("STFC_STRUCTURE", params))
+            .then((res) => {
+                const first = res.RFCTABLE[0].RFCHEX3;
+                expect(first instanceof Uint8Array).toBe(true);
+                expect(Buffer.from(first).toString("hex")).toBe("010203");
+                expect(first.buffer).toBe(res.RFCTABLE[1].RFCHEX3.buffer);
+                expect(Buffer.isBuffer(res.ECHOSTRUCT.RFCHEX3)).toBe(true);
+            })
+            .then(() => xclient.close());
+    });
+
+    test("options: BYTE values as hex strings, accepted as input", function () {
+        expect.assertions(2);
+        const xclient = setup.client(setup.abapSystem, { bytes: "hex" });
+        return xclient
+            .open()
+            .then(() =>
+                xclient.call("STFC_STRUCTURE", {
+                    IMPORTSTRUCT: { RFCHEX3: "0a0b0c" },
+                    RFCTABLE: [{ RFCHEX3: "010203" }],
+                })
+            )
+            .then((res) => {
+                expect(res.ECHOSTRUCT.RFCHEX3).toBe("0a0b0c");
+                expect(res.RFCTABLE[0].RFCHEX3).toBe("010203");
+            })
+            .then(() => xclient.close());
+    });
+
+    test("error: base64 BYTE value with data after padding", function () {
+        expect.assertions(1);
+        const xclient = setup.client(setup.abapSystem, { bytes: "base64" });
+        return xclient
+            .open()
+            .then(() =>
+                xclient.call("STFC_STRUCTURE", {
+                    IMPORTSTRUCT: { RFCHEX3: "AQ==garbage" },
+                })
+            )
+            .catch((ex) => {
+                expect(ex.message).toBe(
+                    "Invalid base64 string when filling field 'RFCHEX3' of type 4"
+                );
+            })
+            .then(() => xclient.close());
+    });
+
+    test("lazy: parameters decoded on first access, then cached", function () {
+        expect.assertions(4);
+        const params = {
+            IMPORTSTRUCT: { RFCINT4: 4 },
+            RFCTABLE: [{ RFCCHAR4: "ROW" }],
+        };
+        return Promise.all([
+            client.call("STFC_STRUCTURE", params, { lazy: true }),
+            client.call("STFC_STRUCTURE", params),
+        ]).then(([lazy, plain]) => {
+            expect(
+                typeof Object.getOwnPropertyDescriptor(lazy, "RFCTABLE").get
+            ).toBe("function");
+            expect(lazy.RFCTABLE).toEqual(plain.RFCTABLE);
+            expect(lazy.RFCTABLE).toBe(lazy.RFCTABLE);
+            expect(Object.keys(lazy)).toEqual(Object.keys(plain));
+        });
+    });
+
+    test("error: lazy parameter accessed after release", function () {
+        expect.assertions(2);
+        return client
+            .call(
+                "STFC_STRUCTURE",
+                { IMPORTSTRUCT: { RFCINT4: 4 } },
+                { lazy: true }
+            )
+            .then((res) => {
+                expect(res.ECHOSTRUCT.RFCINT4).toBe(4);
+                client.releaseResult(res);
+                expect(() => res.RESPTEXT).toThrow(
+                    "Result released, parameter not decoded: RESPTEXT"
+                );
+            });
+    });
+
+    test("tables: rows built like structures, plain data properties", function () {
+        expect.assertions(3);
+        const row = { RFCCHAR1: "A", RFCINT4: 4 };
+        return client
+            .call("STFC_STRUCTURE", { IMPORTSTRUCT: row, RFCTABLE: [row] })
+            .then((res) => {
+                const tableRow = res.RFCTABLE[0];
+                expect(Object.keys(tableRow)).toEqual(
+                    Object.keys(res.ECHOSTRUCT)
+                );
+                expect(
+                    Object.getOwnPropertyDescriptor(tableRow, "RFCCHAR1")
+                ).toEqual({
+                    value: "A",
+                    writable: true,
+                    enumerable: true,
+                    configurable: true,
+                });
+                tableRow.RFCINT4 = 5;
+                expect(tableRow.RFCINT4).toBe(5);
+            });
+    });
+
+    test("options: json parameters from Buffer", function () {
+        expect.assertions(2);
+        const params = { IMPORTSTRUCT: { RFCFLOAT: 1.5, RFCCHAR4: "Aé\"" } };
+        return client
+            .call("STFC_STRUCTURE", Buffer.from(JSON.stringify(params)))
+            .then((res) => {
+                expect(res.ECHOSTRUCT.RFCFLOAT).toBe(1.5);
+                expect(res.ECHOSTRUCT.RFCCHAR4).toBe("Aé\"");
+            });
+    });
+
+    test("error: json parameters from invalid Buffer", function () {
+        expect.assertions(2);
+        return client
+            .call("STFC_CONNECTION", Buffer.from('{"REQUTEXT": 1}'))
+            .catch((ex) => {
+                expect(ex.name).toBe("TypeError");
+                expect(ex.message).toBe(
+                    "Char expected when filling field REQUTEXT of type 0"
+                );
+            });
+    });
+
+    test("error: json integer out of range from Buffer", function () {
+        expect.assertions(2);
+        return client
+            .call(
+                "STFC_STRUCTURE",
+                Buffer.from('{"IMPORTSTRUCT": {"RFCINT4": 4294967296}}')
+            )
+            .catch((ex) => {
+                expect(ex.name).toBe("TypeError");
+                expect(ex.message).toMatch(
+                    "Overflow or other error when filling integer field RFCINT4"
+                );
+            });
+    });
+
+    test("options: arrow table as IPC stream Buffer", function () {
+        expect.assertions(5);
+        const params = { RFCTABLE: [{ RFCFLOAT: 1.5, RFCCHAR4: "ABCD" }] };
+        return client
+            .call("STFC_STRUCTURE", params, {
+                arrow: ["RFCTABLE"],
+                arrowDictionary: true,
+            })
+            .then((res) => {
+                const stream = res.RFCTABLE;
+                expect(Buffer.isBuffer(stream)).toBe(true);
+                // schema message first, end-of-stream marker last
+                expect(stream.readUInt32LE(0)).toBe(0xffffffff);
+                expect(stream.readUInt32LE(stream.length - 8)).toBe(0xffffffff);
+                expect(stream.readUInt32LE(stream.length - 4)).toBe(0);
+                expect(res.ECHOSTRUCT).toHaveProperty("RFCFLOAT");
+            });
+    });
+
+    test("error: arrow export of non-table parameter", function () {
+        expect.assertions(1);
+        return client
+            .call("STFC_STRUCTURE", {}, { arrow: ["ECHOSTRUCT"] })
+            .catch((ex) => {
+                expect(ex.message).toBe(
+                    "Table parameter expected for Arrow export: ECHOSTRUCT"
+                );
+            });
+    });
+
+    test("split: RFC_READ_TABLE lines as row objects", function () {
+        expect.assertions(2);
+        return client
+            .call(
+                "RFC_READ_TABLE",
+                {
+                    QUERY_TABLE: "T000",
+                    FIELDS: [{ FIELDNAME: "MANDT" }, { FIELDNAME: "MTEXT" }],
+                    OPTIONS: [{ TEXT: "MANDT = '000'" }],
+                },
+                { split: true }
+            )
+            .then((res) => {
+                expect(res.DATA.length).toBe(1);
+                expect(Object.keys(res.DATA[0])).toEqual(["MANDT", "MTEXT"]);
+            });
+    });
+
+    test("split: explicit layout as columns", function () {
+        expect.assertions(2);
+        return client
+            .call(
+                "RFC_READ_TABLE",
+                {
+                    QUERY_TABLE: "T000",
+                    FIELDS: [{ FIELDNAME: "MANDT" }],
+                    OPTIONS: [{ TEXT: "MANDT = '000'" }],
+                },
+                {
+                    split: "DATA",
+                    splitFields: [
+                        { FIELDNAME: "CLIENT", OFFSET: 0, LENGTH: 3, TYPE: "I" },
+                    ],
+                    splitColumns: true,
+                    splitConvert: true,
+                }
+            )
+            .then((res) => {
+                expect(res.DATA.CLIENT instanceof Float64Array).toBe(true);
+                expect(Array.from(res.DATA.CLIENT)).toEqual([0]);
+            });
+    });
+
+    test("error: split of non-table parameter", function () {
+        expect.assertions(1);
+        return client
+            .call("STFC_STRUCTURE", {}, { split: "ECHOSTRUCT" })
+            .catch((ex) => {
+                expect(ex.message).toBe(
+                    "Table parameter expected for split: ECHOSTRUCT"
+                );
+            });
+    });
+
+    test("error: call cancelled after timeout, connection reopened", function () {
+        expect.assertions(4);
+        return client
+            .call("RFC_PING_AND_WAIT", { SECONDS: 10 }, { timeout: 1000 })
+            .catch((ex) => {
+                expect(ex.name).toBe("RfcTimeoutError");
+                expect(ex.message).toBe("RFC call timed out after 1000 ms");
+                expect(ex.alive).toBe(true);
+                return client.ping().then((res) => {
+                    expect(res).toBe(true);
+                });
+            });
+    });
+
+    test("error: deadline passed before the call", function () {
+        expect.assertions(1);
+        return client
+            .call(
+                "STFC_CONNECTION",
+                {},
+                { deadline: new Date(Date.now() - 1000) }
+            )
+            .catch((ex) => {
+                expect(ex.name).toBe("RfcTimeoutError");
+            });
+    });
 };
@@ -7,4 +7,9 @@ describe("Pool: Acquire multiple / release all", require("./pool.01")) &&
     ) &&
     describe("Pool: Error - Release without client", require("./pool.05")) &&
     describe("Pool: Acquire 1 / Release 1", require("./pool.06")) &&
-    describe("Pool Options", require("./pool.options"));
+    describe("Pool Options", require("./pool.options")) &&
+    describe("Pool: priority classes", require("./pool.priority")) &&
+    describe("Pool: admission control", require("./pool.admission")) &&
+    describe("Pool: call coalescing", require("./pool.coalesce")) &&
+    describe("Pool: result cache", require("./pool.cache")) &&
+    describe("Pool: partitioned extraction", require("./pool.extract"));
@@ -0,0 +1,56 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const Pool = setup.rfcPool;
+    const abapSystem = setup.abapSystem;
+
+    test("pool: requests over queue limit rejected", function () {
+        expect.assertions(3);
+        const pool = new Pool(abapSystem, { min: 0, max: 1, queueMax: 1 });
+        const wait = { SECONDS: 1 };
+        const calls = [
+            pool.call("RFC_PING_AND_WAIT", wait),
+            pool.call("RFC_PING_AND_WAIT", wait),
+        ];
+        expect(pool.saturation.queued).toBe(1);
+        return pool
+            .call("RFC_PING_AND_WAIT", wait)
+            .catch((ex) => {
+                expect(ex.name).toBe("RfcPoolOverloadError");
+                return Promise.all(calls);
+            })
+            .then(() => {
+                expect(pool.saturation.queued).toBe(0);
+                return pool.releaseAll();
+            });
+    });
+
+    test("pool: request dropped when deadline passes in queue", function () {
+        expect.assertions(2);
+        const pool = new Pool(abapSystem, { min: 0, max: 1 });
+        const busy = pool.call("RFC_PING_AND_WAIT", { SECONDS: 2 });
+        return pool
+            .call("STFC_CONNECTION", {}, { timeout: 500 })
+            .catch((ex) => {
+                expect(ex.name).toBe("RfcTimeoutError");
+                expect(pool.saturation.oldestWait).toBe(0);
+                return busy;
+            })
+            .then(() => pool.releaseAll());
+    });
+};
@@ -0,0 +1,73 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const Pool = setup.rfcPool;
+    const abapSystem = setup.abapSystem;
+    const Cache = setup.rfcCache;
+
+    test("pool: cached result returned without RFC call", function () {
+        expect.assertions(4);
+        const pool = new Pool(abapSystem, {
+            min: 0,
+            cache: { BAPI_USER_GET_DETAIL: 60000 },
+        });
+        const params = { USERNAME: "DEMO" };
+        return pool
+            .call("BAPI_USER_GET_DETAIL", params)
+            .then((first) =>
+                pool.call("BAPI_USER_GET_DETAIL", params).then((second) => {
+                    expect(second).toEqual(first);
+                    expect(second).not.toBe(first);
+                    expect(pool.status.cache.hits).toBe(1);
+                    expect(pool.status.cache.misses).toBe(1);
+                    return pool.releaseAll();
+                })
+            );
+    });
+
+    test("cache: least recently used entries evicted", function () {
+        const cache = new Cache(1024);
+        const value = { TEXT: "x".repeat(400), DATA: Buffer.alloc(8) };
+        cache.set("A", value, 60000);
+        cache.set("B", value, 60000);
+        expect(cache.get("A")).toEqual(value);
+        cache.set("C", value, 60000);
+        expect(cache.get("B")).toBeUndefined();
+        expect(cache.get("A")).toEqual(value);
+        expect(cache.status.evictions).toBe(1);
+    });
+
+    test("cache: file backed cache shared by instances", function () {
+        const file = require("path").join(
+            require("os").tmpdir(),
+            `node-rfc-${process.pid}.cache`
+        );
+        const value = { TEXT: "shared", DATA: Buffer.alloc(8) };
+        try {
+            const writer = new Cache(1024 * 1024, file);
+            const reader = new Cache(1024 * 1024, file);
+            writer.set("A", value, 60000);
+            expect(reader.get("A")).toEqual(value);
+            expect(reader.status.shared).toBe(true);
+            reader.delete("A");
+            expect(writer.get("A")).toBeUndefined();
+        } finally {
+            require("fs").unlinkSync(file);
+        }
+    });
+};
@@ -0,0 +1,41 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const Pool = setup.rfcPool;
+    const abapSystem = setup.abapSystem;
+
+    test("pool: identical concurrent calls share one invocation", function () {
+        expect.assertions(4);
+        const pool = new Pool(abapSystem, {
+            min: 0,
+            coalesce: ["BAPI_USER_GET_DETAIL"],
+        });
+        const calls = [
+            pool.call("BAPI_USER_GET_DETAIL", { USERNAME: "DEMO" }),
+            pool.call("BAPI_USER_GET_DETAIL", { USERNAME: "DEMO" }),
+            pool.call("BAPI_USER_GET_DETAIL", { USERNAME: "UNKNOWN" }),
+        ];
+        return Promise.all(calls).then((res) => {
+            expect(res[1]).toBe(res[0]);
+            expect(res[2]).not.toBe(res[0]);
+            expect(res[0]).toHaveProperty("ADDRESS");
+            expect(pool.status.coalesced).toBe(1);
+            return pool.releaseAll();
+        });
+    });
+};
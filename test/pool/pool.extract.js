@@ -0,0 +1,122 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const Pool = setup.rfcPool;
+    const abapSystem = setup.abapSystem;
+    const { Writable } = require("stream");
+
+    function collect(rows) {
+        return new Writable({
+            objectMode: true,
+            write(row, encoding, callback) {
+                rows.push(row);
+                callback();
+            },
+        });
+    }
+
+    test("pool: table extracted in ordered row windows", function () {
+        expect.assertions(4);
+        const pool = new Pool(abapSystem, { min: 0, max: 3 });
+        const rows = [];
+        const progress = [];
+        return pool
+            .extract(
+                "RFC_READ_TABLE",
+                { QUERY_TABLE: "T002", FIELDS: [{ FIELDNAME: "SPRAS" }] },
+                collect(rows),
+                {
+                    window: 10,
+                    parallel: 3,
+                    ordered: true,
+                    callOptions: { split: true },
+                    progress: (p) => progress.push(p.partition),
+                }
+            )
+            .then((status) => {
+                expect(rows.length).toBe(status.total);
+                expect(status.done).toBe(status.partitions);
+                // partitions written in order
+                expect(progress).toEqual(
+                    progress.slice().sort((a, b) => a - b)
+                );
+                expect(Object.keys(rows[0])).toEqual(["SPRAS"]);
+                return pool.releaseAll();
+            });
+    });
+
+    test("pool: key range partitions combined with base predicates", function () {
+        expect.assertions(2);
+        const pool = new Pool(abapSystem, { min: 0, max: 2 });
+        const rows = [];
+        return pool
+            .extract(
+                "RFC_READ_TABLE",
+                {
+                    QUERY_TABLE: "T000",
+                    FIELDS: [{ FIELDNAME: "MANDT" }],
+                    OPTIONS: [{ TEXT: "MANDT <> '999'" }],
+                },
+                collect(rows),
+                {
+                    partitions: Pool.keyRanges("MANDT", ["100"]),
+                    callOptions: { split: true },
+                }
+            )
+            .then((status) => {
+                expect(status.partitions).toBe(2);
+                expect(rows.map((row) => row.MANDT)).toContain("000");
+                return pool.releaseAll();
+            });
+    });
+
+    test("error: extract without partitions or window", function () {
+        expect.assertions(1);
+        const pool = new Pool(abapSystem, { min: 0 });
+        return pool
+            .extract("RFC_READ_TABLE", {}, collect([]))
+            .catch((ex) => {
+                expect(ex.message).toBe(
+                    "Extract partitions or window option expected"
+                );
+            });
+    });
+
+    test("error: progress callback error rejects extract", function () {
+        expect.assertions(1);
+        const pool = new Pool(abapSystem, { min: 0, max: 2 });
+        return pool
+            .extract(
+                "RFC_READ_TABLE",
+                { QUERY_TABLE: "T002", FIELDS: [{ FIELDNAME: "SPRAS" }] },
+                collect([]),
+                {
+                    window: 10,
+                    parallel: 2,
+                    callOptions: { split: true },
+                    progress: () => {
+                        throw new Error("progress failed");
+                    },
+                }
+            )
+            .catch((ex) => {
+                expect(ex.message).toBe("progress failed");
+            })
+            .then(() => pool.releaseAll());
+    });
+};
@@ -0,0 +1,60 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const Pool = setup.rfcPool;
+    const abapSystem = setup.abapSystem;
+
+    test("pool: interactive class served before queued batch calls", function () {
+        expect.assertions(4);
+        const pool = new Pool(abapSystem, {
+            min: 0,
+            max: 2,
+            classes: {
+                interactive: { priority: 10, reserved: 1 },
+                batch: { priority: 0 },
+            },
+        });
+        const order = [];
+        const calls = [];
+        for (let i = 0; i < 2; i++) {
+            const batch = { class: "batch", tenant: `tenant${i}` };
+            calls.push(
+                pool
+                    .call("RFC_PING_AND_WAIT", { SECONDS: 1 }, {}, batch)
+                    .then(() => order.push("batch"))
+            );
+        }
+        // one connection reserved, batch calls limited to max - reserved
+        expect(pool.status.classes.batch.inUse).toBe(1);
+        const interactive = { class: "interactive" };
+        calls.push(
+            pool
+                .call("STFC_CONNECTION", {}, {}, interactive)
+                .then(() => order.push("interactive"))
+        );
+        return Promise.all(calls).then(() => {
+            const status = pool.status.classes;
+            expect(order[0]).toBe("interactive");
+            expect(status.batch.acquired).toBe(2);
+            expect(status.batch.waitMax).toBeGreaterThan(
+                status.interactive.waitMax
+            );
+            return pool.releaseAll();
+        });
+    });
+};
@@ -0,0 +1 @@
+describe("Server: Promises", require("./server"));
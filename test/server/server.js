@@ -0,0 +1,138 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const Server = setup.rfcServer;
+    const serverParams = require("../testutils/abapSystem")("MME_SERVER");
+    const callerParams = require("../testutils/abapSystem")(
+        "MME_SERVER_CLIENT"
+    );
+
+    // function descriptions are taken from the backend system
+    const client = setup.client();
+    const caller = setup.client(callerParams);
+
+    beforeAll(() => {
+        return client.open();
+    });
+
+    afterAll(() => {
+        return client.close();
+    });
+
+    test("Server requires client instance", function () {
+        expect(() => new Server(serverParams, {})).toThrow(
+            new TypeError("Client instance required as second argument")
+        );
+    });
+
+    test("Server unknown option", function () {
+        expect(() => new Server(serverParams, client, { xyz: 1 })).toThrow(
+            new TypeError("Unknown option: xyz")
+        );
+    });
+
+    test("Server threads option", function () {
+        const server = new Server(serverParams, client, { threads: 3 });
+        expect(server.threads).toBe(3);
+        expect(server.alive).toBe(false);
+        expect(server.client).toBe(client);
+    });
+
+    test("Server add function not found", function () {
+        expect.assertions(1);
+        const server = new Server(serverParams, client);
+        return server.addFunction("XYZ_NOT_EXISTS", () => {}).catch((ex) => {
+            expect(ex).toEqual(
+                expect.objectContaining({
+                    name: "RfcLibError",
+                    codeString: "RFC_NOT_FOUND",
+                })
+            );
+        });
+    });
+
+    test("Server call handled in JavaScript", function () {
+        expect.assertions(4);
+        const server = new Server(serverParams, client, { threads: 2 });
+        return (async () => {
+            await server.addFunction("STFC_CONNECTION", (abapInput) => {
+                return { ECHOTEXT: abapInput.REQUTEXT, RESPTEXT: "node-rfc" };
+            });
+            await server.start();
+            expect(server.alive).toBe(true);
+            await caller.open();
+            const res = await caller.call("STFC_CONNECTION", {
+                REQUTEXT: setup.UNICODETEST,
+            });
+            await caller.close();
+            await server.stop();
+            expect(server.alive).toBe(false);
+            expect(res.ECHOTEXT).toBe(setup.UNICODETEST);
+            expect(res.RESPTEXT).toBe("node-rfc");
+        })();
+    });
+
+    test("Server async handler and error", function () {
+        expect.assertions(3);
+        const server = new Server(serverParams, client);
+        return (async () => {
+            await server.addFunction("STFC_CONNECTION", async (abapInput) => {
+                if (abapInput.REQUTEXT === "fail")
+                    throw new Error("handler failed");
+                return { ECHOTEXT: abapInput.REQUTEXT };
+            });
+            await server.start();
+            await caller.open();
+            const res = await caller.call("STFC_CONNECTION", {
+                REQUTEXT: "async",
+            });
+            expect(res.ECHOTEXT).toBe("async");
+            try {
+                await caller.call("STFC_CONNECTION", { REQUTEXT: "fail" });
+            } catch (ex) {
+                expect(ex.message).toBe("handler failed");
+            }
+            await caller.close();
+            expect(server.removeFunction("stfc_connection")).toBe(true);
+            await server.stop();
+        })();
+    });
+
+    test("Server stop fails unsettled handler calls", function () {
+        expect.assertions(2);
+        const server = new Server(serverParams, client);
+        return (async () => {
+            let handled;
+            const called = new Promise((resolve) => (handled = resolve));
+            await server.addFunction("STFC_CONNECTION", () => {
+                handled();
+                return new Promise(() => {});
+            });
+            await server.start();
+            await caller.open();
+            const call = caller
+                .call("STFC_CONNECTION", { REQUTEXT: "never" })
+                .catch((ex) => ex);
+            await called;
+            await server.stop();
+            expect(server.alive).toBe(false);
+            expect((await call).message).toBe("node-rfc server stopped");
+            await caller.close();
+        })();
+    });
+};
@@ -0,0 +1 @@
+describe("Stream: table rows to Writable", require("./stream"));
@@ -0,0 +1,121 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const { PassThrough, Writable } = require("stream");
+    const client = setup.client();
+
+    const params = {
+        RFCTABLE: [
+            { RFCINT4: 1, RFCCHAR4: "A,B" },
+            { RFCINT4: 2, RFCCHAR4: 'C"D' },
+        ],
+    };
+
+    function collect(writable) {
+        const chunks = [];
+        writable.on("data", (chunk) => chunks.push(chunk));
+        return () => Buffer.concat(chunks).toString();
+    }
+
+    beforeAll(() => {
+        return client.open();
+    });
+
+    afterAll(() => {
+        return client.close();
+    });
+
+    test("Table as NDJSON", function () {
+        expect.assertions(4);
+        const writable = new PassThrough();
+        const text = collect(writable);
+        return client
+            .streamTable("STFC_STRUCTURE", params, "RFCTABLE", writable)
+            .then((res) => {
+                const rows = text().trim().split("\n").map(JSON.parse);
+                // STFC_STRUCTURE appends one row
+                expect(rows.length).toBe(3);
+                expect(rows[1].RFCCHAR4).toBe('C"D');
+                expect(res).not.toHaveProperty("RFCTABLE");
+                expect(res).toHaveProperty("ECHOSTRUCT");
+            });
+    });
+
+    test("Table as CSV", function () {
+        expect.assertions(3);
+        const writable = new PassThrough();
+        const text = collect(writable);
+        return client
+            .streamTable("STFC_STRUCTURE", params, "RFCTABLE", writable, {
+                format: "csv",
+            })
+            .then(() => {
+                const lines = text().split("\n");
+                expect(lines[0].split(",")).toContain("RFCCHAR4");
+                expect(lines[1]).toContain('"A,B"');
+                expect(lines[2]).toContain('"C""D"');
+            });
+    });
+
+    test("error: Writable error stops streaming", function () {
+        expect.assertions(1);
+        const writable = new Writable({
+            write(chunk, encoding, callback) {
+                callback(new Error("Writable failed"));
+            },
+        });
+        return client
+            .streamTable("STFC_STRUCTURE", params, "RFCTABLE", writable)
+            .catch((ex) => {
+                expect(ex.message).toBe("Writable failed");
+            });
+    });
+
+    test("error: stream of non-table parameter", function () {
+        expect.assertions(1);
+        const writable = new PassThrough();
+        return client
+            .streamTable("STFC_STRUCTURE", {}, "ECHOSTRUCT", writable)
+            .catch((ex) => {
+                expect(ex.message).toBe(
+                    "Table parameter expected for streaming: ECHOSTRUCT"
+                );
+            });
+    });
+
+    test("error: stream with client JS conversions", function () {
+        expect.assertions(1);
+        const xclient = setup.client(setup.abapSystem, { bytes: "hex" });
+        return xclient
+            .open()
+            .then(() =>
+                xclient.streamTable(
+                    "STFC_STRUCTURE",
+                    params,
+                    "RFCTABLE",
+                    new PassThrough()
+                )
+            )
+            .catch((ex) => {
+                expect(ex.message).toBe(
+                    "Option stream cannot be combined with client options bcd function, date, time or bytes hex/base64"
+                );
+            })
+            .then(() => xclient.close());
+    });
+};
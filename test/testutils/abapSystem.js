@@ -29,6 +29,21 @@ let abapSystem = {
         lang: "EN",
     },
 
+    // registered server program, for RFC server tests
+    MME_SERVER: {
+        gwhost: "10.68.110.51",
+        gwserv: "sapgw00",
+        program_id: "NODE_RFC_TEST",
+    },
+
+    // client calling the registered server program via gateway
+    MME_SERVER_CLIENT: {
+        gwhost: "10.68.110.51",
+        gwserv: "sapgw00",
+        tpname: "NODE_RFC_TEST",
+        client: "620",
+    },
+
     QM7: {
         user: "NWRFCTEST",
         passwd: "Welcome1",
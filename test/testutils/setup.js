@@ -2,6 +2,10 @@ const nodeRfc = require("../../package.json").dependencies["node-rfc"];
 const rfcClient = require(nodeRfc ? "node-rfc" : "../../lib").Client;
 const rfcPool = require(nodeRfc ? "node-rfc" : "../../lib").Pool;
 const rfcThroughput = require(nodeRfc ? "node-rfc" : "../../lib").Throughput;
+const rfcThroughputIndex = require(nodeRfc ? "node-rfc" : "../../lib")
+    .RfcThroughputIndex;
+const rfcServer = require(nodeRfc ? "node-rfc" : "../../lib").Server;
+const rfcCache = require(nodeRfc ? "node-rfc" : "../../lib").Cache;
 const Promise = require(nodeRfc ? "node-rfc" : "../../lib").Promise;
 const abapSystem = require("./abapSystem")();
 const UNICODETEST = "ทดสอบสร้างลูกค้าจากภายนอกครั้งที่".repeat(7);
@@ -10,6 +14,9 @@ module.exports = {
     rfcClient: rfcClient,
     rfcPool: rfcPool,
     rfcThroughput: rfcThroughput,
+    rfcThroughputIndex: rfcThroughputIndex,
+    rfcServer: rfcServer,
+    rfcCache: rfcCache,
     Promise: Promise,
     abapSystem: abapSystem,
     UNICODETEST: UNICODETEST,
@@ -181,4 +181,28 @@ module.exports = () => {
             await client2.close();
         })();
     });
+
+    test("Throughput pool snapshot", function () {
+        return (async () => {
+            const Pool = setup.rfcPool;
+            const Index = setup.rfcThroughputIndex;
+            const pool = new Pool(setup.abapSystem, {
+                min: 0,
+                throughput: true,
+            });
+
+            await pool.call("STFC_CONNECTION", { REQUTEXT: "hello" });
+            const snapshot = pool.throughput;
+            expect(snapshot).toBeInstanceOf(Float64Array);
+            expect(snapshot[Index.numberOfCalls]).toBeGreaterThan(0);
+            expect(snapshot[Index.interval]).toEqual(0);
+
+            await pool.call("STFC_CONNECTION", { REQUTEXT: "hello" });
+            expect(pool.throughput).toBe(snapshot);
+            expect(snapshot[Index.interval]).toBeGreaterThan(0);
+            expect(snapshot[Index.callsPerSecond]).toBeGreaterThan(0);
+
+            await pool.releaseAll();
+        })();
+    });
 };
@@ -0,0 +1 @@
+describe("Transaction: tRFC, qRFC, bgRFC", require("./transaction"));
@@ -0,0 +1,158 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const setup = require("../testutils/setup");
+    const client = setup.client();
+
+    const TCPICDAT = (text) => {
+        return { TCPICDAT: [{ LINE: text }] };
+    };
+
+    beforeAll(() => {
+        return client.open();
+    });
+
+    afterAll(() => {
+        return client.close();
+    });
+
+    test("Transaction types", function () {
+        expect(client.transaction().type).toBe("tRFC");
+        expect(client.queue("NODE_RFC_TEST").type).toBe("qRFC");
+        expect(client.queue("NODE_RFC_TEST").queue).toEqual([
+            "NODE_RFC_TEST",
+        ]);
+        expect(client.unit().type).toBe("bgRFC");
+        expect(client.unit({ queue: ["Q1", "Q2"] }).queue).toEqual([
+            "Q1",
+            "Q2",
+        ]);
+    });
+
+    test("Transaction invalid options", function () {
+        expect(() => client.transaction({ xyz: 1 })).toThrow(
+            new TypeError("Unknown option: xyz")
+        );
+        expect(() => client.transaction({ queue: ["Q1", "Q2"] })).toThrow(
+            new TypeError(
+                "Only one queue supported for qRFC, use bgRFC unit for multiple queues"
+            )
+        );
+        expect(() => client.transaction({ id: "123" })).toThrow(
+            new TypeError(
+                "Transaction id must be 24 characters long, received: 123"
+            )
+        );
+    });
+
+    test("Transaction without calls", function () {
+        expect.assertions(1);
+        return client
+            .transaction()
+            .submit()
+            .catch((ex) => {
+                expect(ex.message).toBe(
+                    "No function calls added to transaction"
+                );
+            });
+    });
+
+    test("tRFC submit and confirm", function () {
+        expect.assertions(4);
+        const transaction = client.transaction();
+        let persistedTid;
+        transaction
+            .add("STFC_WRITE_TO_TCPIC", TCPICDAT("node-rfc tRFC 1"))
+            .add("STFC_WRITE_TO_TCPIC", TCPICDAT("node-rfc tRFC 2"));
+        expect(transaction.calls.length).toBe(2);
+        return (async () => {
+            const tid = await transaction.submit((tid) => {
+                persistedTid = tid;
+            });
+            expect(tid).toHaveLength(24);
+            expect(tid).toBe(persistedTid);
+            await transaction.confirm();
+            expect(transaction.calls.length).toBe(0);
+        })();
+    });
+
+    test("tRFC resubmit with persisted TID", function () {
+        expect.assertions(1);
+        return (async () => {
+            const first = client.transaction();
+            first.add("STFC_WRITE_TO_TCPIC", TCPICDAT("node-rfc tRFC retry"));
+            const tid = await first.submit();
+            // sent again after failure, not executed twice in backend
+            const retry = client.transaction({ id: tid });
+            retry.add("STFC_WRITE_TO_TCPIC", TCPICDAT("node-rfc tRFC retry"));
+            expect(await retry.submit()).toBe(tid);
+            await retry.confirm();
+        })();
+    });
+
+    test("tRFC submit retried after failure", function () {
+        expect.assertions(3);
+        const transaction = client.transaction();
+        const tids = [];
+        const persist = (tid) => {
+            tids.push(tid);
+            if (tids.length === 1) throw new Error("TID not persisted");
+        };
+        transaction.add(
+            "STFC_WRITE_TO_TCPIC",
+            TCPICDAT("node-rfc tRFC retry after failure")
+        );
+        return (async () => {
+            await transaction.submit(persist).catch((ex) => {
+                expect(ex.message).toBe("TID not persisted");
+            });
+            // same object, handle created again under the same TID
+            const tid = await transaction.submit(persist);
+            expect(tid).toBe(tids[0]);
+            expect(tids[1]).toBe(tids[0]);
+            await transaction.confirm();
+        })();
+    });
+
+    test("qRFC submit", function () {
+        expect.assertions(1);
+        return (async () => {
+            const transaction = client.queue("NODE_RFC_TEST");
+            transaction.add(
+                "STFC_WRITE_TO_TCPIC",
+                TCPICDAT("node-rfc qRFC")
+            );
+            const tid = await transaction.submit();
+            expect(tid).toHaveLength(24);
+            await transaction.confirm();
+        })();
+    });
+
+    test("Transaction function not found", function () {
+        expect.assertions(1);
+        const transaction = client.transaction();
+        transaction.add("XYZ_NOT_EXISTS", {});
+        return transaction.submit().catch((ex) => {
+            expect(ex).toEqual(
+                expect.objectContaining({
+                    name: "RfcLibError",
+                    codeString: "RFC_NOT_FOUND",
+                })
+            );
+        });
+    });
+};
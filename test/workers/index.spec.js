@@ -0,0 +1 @@
+describe("Worker threads", require("./workers"));
@@ -0,0 +1,72 @@
+// Copyright 2014 SAP AG.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http: //www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+// either express or implied. See the License for the specific
+// language governing permissions and limitations under the License.
+
+"use strict";
+
+module.exports = () => {
+    const { Worker } = require("worker_threads");
+    const path = require("path");
+    const setup = require("../testutils/setup");
+    const WORKERS = 4;
+    const CALLS = 8;
+
+    // each worker loads its own addon instance and runs its own clients
+    const workerScript = `
+        const { parentPort, workerData } = require("worker_threads");
+        const setup = require(workerData.setup);
+        (async () => {
+            const client = setup.client();
+            await client.open();
+            const results = [];
+            for (let i = 0; i < workerData.calls; i++) {
+                const text = workerData.text + " " + workerData.id + " " + i;
+                const res = await client.call("STFC_CONNECTION", {
+                    REQUTEXT: text,
+                });
+                results.push(res.ECHOTEXT === text);
+            }
+            await client.close();
+            parentPort.postMessage({ id: client.id, results: results });
+        })().catch((ex) => parentPort.postMessage({ error: ex.message }));
+    `;
+
+    test("Clients in parallel worker threads", function () {
+        expect.assertions(WORKERS * 2);
+        const workers = [];
+        for (let id = 0; id < WORKERS; id++) {
+            workers.push(
+                new Promise((resolve, reject) => {
+                    const worker = new Worker(workerScript, {
+                        eval: true,
+                        workerData: {
+                            id: id,
+                            calls: CALLS,
+                            text: setup.UNICODETEST,
+                            setup: path.join(__dirname, "../testutils/setup"),
+                        },
+                    });
+                    worker.on("message", resolve);
+                    worker.on("error", reject);
+                })
+            );
+        }
+        return Promise.all(workers).then((messages) => {
+            messages.forEach((message) => {
+                expect(message.error).toBeUndefined();
+                // client ids are counted per worker thread
+                expect(message.results).toEqual(Array(CALLS).fill(true));
+            });
+        });
+    });
+};